@@ -0,0 +1,22 @@
+#ifndef VLK_BENCH_VALUES_HPP
+#define VLK_BENCH_VALUES_HPP
+
+#include "ValkyrieEngineCommon/ValkyrieEngineCommon.hpp"
+#include "catch2/catch.hpp"
+#include <random>
+#include <vector>
+
+//! Number of elements processed by each batch benchmark.
+constexpr vlk::Size benchCount = 4096;
+
+//! Returns <tt>n</tt> reproducible pseudo-random floats in the range [lo, hi).
+inline std::vector<vlk::Float> RandomFloats(vlk::Size n, vlk::Float lo = -100.0f, vlk::Float hi = 100.0f)
+{
+	std::mt19937 rng(0x5EED);
+	std::uniform_real_distribution<vlk::Float> dist(lo, hi);
+	std::vector<vlk::Float> out(n);
+	for (vlk::Float& f : out) f = dist(rng);
+	return out;
+}
+
+#endif
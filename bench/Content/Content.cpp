@@ -0,0 +1,489 @@
+#include "BenchValues.hpp"
+#include "ValkyrieEngineCommon/Content.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+using namespace vlk;
+
+namespace
+{
+	struct BenchContent
+	{
+		int value;
+	};
+
+	//! Content whose destruction takes a while, like freeing GPU resources.
+	struct SlowContent
+	{
+		int value;
+	};
+
+	constexpr Size aliasCount = 256;
+	constexpr Size lookupsPerThread = 100000;
+
+	//! The registry GetContent used before it became lock-free, for comparison.
+	struct LockedRegistry
+	{
+		VLK_SHARED_MUTEX_TYPE mtx;
+		std::unordered_map<std::string, BenchContent*> content;
+
+		const BenchContent* Get(const std::string& alias)
+		{
+			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx);
+			auto it = content.find(alias);
+			if (it == content.end()) return nullptr;
+			return it->second;
+		}
+	};
+
+	//! Runs <tt>threads</tt> threads each calling <tt>lookup</tt> on every alias in turn, and returns a checksum.
+	template <typename F>
+	Size RunReaders(Size threads, const std::vector<std::string>& aliases, F lookup)
+	{
+		std::vector<Size> sums(threads, 0);
+		std::vector<std::thread> t;
+
+		for (Size i = 0; i < threads; i++)
+		{
+			t.emplace_back([&, i]()
+			{
+				Size sum = 0;
+				for (Size k = 0; k < lookupsPerThread; k++)
+				{
+					sum += lookup(aliases[(k + i * 7) % aliases.size()])->value;
+				}
+				sums[i] = sum;
+			});
+		}
+
+		Size total = 0;
+		for (Size i = 0; i < threads; i++)
+		{
+			t[i].join();
+			total += sums[i];
+		}
+		return total;
+	}
+}
+
+template<>
+BenchContent* vlk::ConstructContent(const std::string& path)
+{
+	return new BenchContent{static_cast<int>(path.size())};
+}
+
+template<>
+void vlk::DestroyContent(BenchContent* c)
+{
+	delete c;
+}
+
+template<>
+SlowContent* vlk::ConstructContent(const std::string&)
+{
+	return new SlowContent{0};
+}
+
+template<>
+void vlk::DestroyContent(SlowContent* c)
+{
+	const auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(200);
+	while (std::chrono::steady_clock::now() < end) { }
+	delete c;
+}
+
+TEST_CASE("Content lookup contention", "[!benchmark][Content]")
+{
+	std::vector<std::string> aliases;
+	LockedRegistry locked;
+
+	for (Size i = 0; i < aliasCount; i++)
+	{
+		aliases.push_back("content_" + std::to_string(i));
+		Content<BenchContent>::LoadContent(aliases.back(), aliases.back());
+		locked.content[aliases.back()] = new BenchContent{static_cast<int>(aliases.back().size())};
+	}
+
+	for (Size threads : { Size(1), Size(2), Size(4), Size(8), Size(16), Size(32) })
+	{
+		BENCHMARK("shared_mutex lookup, " + std::to_string(threads) + " threads")
+		{
+			return RunReaders(threads, aliases, [&](const std::string& a) { return locked.Get(a); });
+		};
+
+		BENCHMARK("Content<T>::GetContent, " + std::to_string(threads) + " threads")
+		{
+			return RunReaders(threads, aliases, [](const std::string& a) { return Content<BenchContent>::GetContent(a); });
+		};
+	}
+
+	for (const std::string& a : aliases)
+	{
+		Content<BenchContent>::UnloadContent(a);
+		delete locked.content[a];
+	}
+}
+
+TEST_CASE("Content lookup by handle", "[!benchmark][Content]")
+{
+	std::vector<std::string> aliases;
+	std::vector<ContentHandle<BenchContent>> handles;
+
+	for (Size i = 0; i < aliasCount; i++)
+	{
+		aliases.push_back("content_" + std::to_string(i));
+		Content<BenchContent>::LoadContent(aliases.back(), aliases.back());
+		handles.push_back(Content<BenchContent>::Resolve(aliases.back()));
+	}
+
+	BENCHMARK("Content<T>::GetContent by alias")
+	{
+		Size sum = 0;
+		for (Size k = 0; k < benchCount; k++) sum += Content<BenchContent>::GetContent(aliases[k % aliasCount])->value;
+		return sum;
+	};
+
+	BENCHMARK("Content<T>::GetContent by string literal")
+	{
+		Size sum = 0;
+		for (Size k = 0; k < benchCount; k++) sum += Content<BenchContent>::GetContent("content_17")->value;
+		return sum;
+	};
+
+	BENCHMARK("ContentHandle<T>::Get")
+	{
+		Size sum = 0;
+		for (Size k = 0; k < benchCount; k++) sum += handles[k % aliasCount].Get()->value;
+		return sum;
+	};
+
+	for (const std::string& a : aliases) Content<BenchContent>::UnloadContent(a);
+}
+
+TEST_CASE("Content batch loading", "[!benchmark][Content]")
+{
+	std::vector<std::pair<std::string, std::string>> entries;
+	for (Size i = 0; i < 1024; i++)
+	{
+		entries.push_back(std::make_pair("batch_" + std::to_string(i), "batch_" + std::to_string(i)));
+	}
+
+	BENCHMARK("LoadContent loop, 1024 entries")
+	{
+		for (const std::pair<std::string, std::string>& e : entries) Content<BenchContent>::LoadContent(e.first, e.second);
+		return Content<BenchContent>::GetContent("batch_0");
+	};
+
+	BENCHMARK("LoadBatch, 1024 entries")
+	{
+		return Content<BenchContent>::LoadBatch(entries).loaded;
+	};
+
+	for (const std::pair<std::string, std::string>& e : entries) Content<BenchContent>::UnloadContent(e.second);
+}
+
+namespace
+{
+	//! Content holding a copy of its file, as read through std::ifstream.
+	struct BufferedBlob
+	{
+		std::vector<char> bytes;
+	};
+
+	//! Content referring to its memory-mapped file.
+	struct MappedBlob
+	{
+		ContentView view;
+	};
+
+	constexpr Size blobSize = 16 * 1024 * 1024;
+}
+
+namespace vlk
+{
+	template<>
+	struct MapContent<MappedBlob> : std::true_type { };
+}
+
+template<>
+BufferedBlob* vlk::ConstructContent(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file.good()) return nullptr;
+	BufferedBlob* b = new BufferedBlob();
+	b->bytes.resize(static_cast<Size>(file.tellg()));
+	file.seekg(0);
+	file.read(b->bytes.data(), b->bytes.size());
+	return b;
+}
+
+template<>
+void vlk::DestroyContent(BufferedBlob* b)
+{
+	delete b;
+}
+
+template<>
+MappedBlob* vlk::ConstructContent(const std::string&, const ContentView& view)
+{
+	return new MappedBlob{view};
+}
+
+template<>
+void vlk::DestroyContent(MappedBlob* b)
+{
+	delete b;
+}
+
+TEST_CASE("Content loading from mapped files", "[!benchmark][Content]")
+{
+	Content<BufferedBlob>::SetContentPrefix("./");
+	Content<MappedBlob>::SetContentPrefix("./");
+
+	{
+		std::ofstream blob("bench_blob", std::ios::binary);
+		std::vector<char> bytes(blobSize);
+		for (Size i = 0; i < blobSize; i++) bytes[i] = static_cast<char>(i * 31);
+		blob.write(bytes.data(), bytes.size());
+	}
+
+	// Sums a sparse sample of bytes, as a parser touching the whole file would
+	BENCHMARK("Load 16 MiB through std::ifstream")
+	{
+		Content<BufferedBlob>::LoadContent("bench_blob", "blob");
+		const BufferedBlob* b = Content<BufferedBlob>::GetContent("blob");
+		Size sum = 0;
+		for (Size i = 0; i < b->bytes.size(); i += 4096) sum += static_cast<UByte>(b->bytes[i]);
+		Content<BufferedBlob>::UnloadContent("blob");
+		return sum;
+	};
+
+	BENCHMARK("Load 16 MiB through MapContent")
+	{
+		Content<MappedBlob>::LoadContent("bench_blob", "blob");
+		const MappedBlob* b = Content<MappedBlob>::GetContent("blob");
+		Size sum = 0;
+		for (Size i = 0; i < b->view.size; i += 4096) sum += b->view.data[i];
+		Content<MappedBlob>::UnloadContent("blob");
+		return sum;
+	};
+
+	std::remove("bench_blob");
+}
+
+namespace
+{
+	//! The metadata store Content<T> used before ContentMetadata, for comparison.
+	void ParseIntoMultimap(const std::string& path, const std::string& alias,
+		std::unordered_multimap<std::string, std::pair<std::string, std::string>>& out)
+	{
+		std::ifstream metaFile(path);
+		std::string str;
+		while (std::getline(metaFile, str))
+		{
+			if (str.length() == 0 || str[0] == '#' || str[0] == '!') continue;
+			Size split = str.find_first_of('=');
+			if (split == 0 || split == std::string::npos) continue;
+			out.insert(std::make_pair(alias, std::make_pair(str.substr(0, split), str.substr(split + 1))));
+		}
+	}
+}
+
+TEST_CASE("Content metadata", "[!benchmark][Content]")
+{
+	const Size fieldCount = 32;
+
+	{
+		std::ofstream meta("bench_metadata.meta");
+		meta << "!version=1\n";
+		for (Size i = 0; i < fieldCount; i++) meta << "metadata_key_" << i << "=value of metadata field " << i << "\n";
+	}
+
+	std::remove("bench_metadata.metab");
+	ContentMetadata::Load("bench_metadata", true);
+
+	BENCHMARK("Parse into unordered_multimap")
+	{
+		std::unordered_multimap<std::string, std::pair<std::string, std::string>> m;
+		ParseIntoMultimap("bench_metadata.meta", "alias", m);
+		return m.size();
+	};
+
+	BENCHMARK("ContentMetadata from text")
+	{
+		return ContentMetadata::Load("bench_metadata", false)->Count();
+	};
+
+	BENCHMARK("ContentMetadata from .metab cache")
+	{
+		return ContentMetadata::Load("bench_metadata", true)->Count();
+	};
+
+	std::unordered_multimap<std::string, std::pair<std::string, std::string>> multimap;
+	for (Size a = 0; a < 256; a++) ParseIntoMultimap("bench_metadata.meta", "alias_" + std::to_string(a), multimap);
+	std::unique_ptr<ContentMetadata> metadata = ContentMetadata::Load("bench_metadata", false);
+	const std::string key = "metadata_key_" + std::to_string(fieldCount - 1);
+
+	BENCHMARK("Lookup in unordered_multimap")
+	{
+		Size found = 0;
+		for (Size k = 0; k < benchCount; k++)
+		{
+			auto range = multimap.equal_range("alias_17");
+			for (auto it = range.first; it != range.second; it++)
+			{
+				if (it->second.first == key) { found += it->second.second.size(); break; }
+			}
+		}
+		return found;
+	};
+
+	BENCHMARK("Lookup in ContentMetadata")
+	{
+		Size found = 0;
+		const char* value;
+		Size size;
+		for (Size k = 0; k < benchCount; k++)
+		{
+			if (metadata->Find(key, value, size)) found += size;
+		}
+		return found;
+	};
+
+	std::remove("bench_metadata.meta");
+	std::remove("bench_metadata.metab");
+}
+
+TEST_CASE("Typed content metadata", "[!benchmark][Content]")
+{
+	typedef Content<BenchContent> C;
+
+	{
+		std::ofstream meta("bench_typed.meta");
+		meta << "!version=1\nframes=12\nframe_time=0.125\nfiltered=true\n";
+	}
+
+	C::SetContentPrefix("./");
+	C::LoadContent("bench_typed", "typed");
+	const std::string alias = "typed";
+	const std::string framesKey = "frames";
+	const std::string timeKey = "frame_time";
+	const std::string filteredKey = "filtered";
+
+	BENCHMARK("stoi/stof of GetMetadata")
+	{
+		Double sum = 0;
+		for (Size k = 0; k < benchCount; k++)
+		{
+			sum += std::stoi(C::GetMetadata(alias, framesKey));
+			sum += std::stof(C::GetMetadata(alias, timeKey));
+			sum += (C::GetMetadata(alias, filteredKey) == "true") ? 1 : 0;
+		}
+		return sum;
+	};
+
+	BENCHMARK("Typed accessors")
+	{
+		Double sum = 0;
+		for (Size k = 0; k < benchCount; k++)
+		{
+			sum += C::GetMetadataInt(alias, framesKey);
+			sum += C::GetMetadataFloat(alias, timeKey);
+			sum += C::GetMetadataBool(alias, filteredKey) ? 1 : 0;
+		}
+		return sum;
+	};
+
+	const ContentMetadata* meta = C::FindMetadata(alias);
+	const UInt frames = MetadataKeys::Intern(framesKey);
+	const UInt time = MetadataKeys::Intern(timeKey);
+	const UInt filtered = MetadataKeys::Intern(filteredKey);
+
+	BENCHMARK("Cached metadata and key ids")
+	{
+		Double sum = 0;
+		Long i = 0;
+		Double d = 0;
+		bool b = false;
+		for (Size k = 0; k < benchCount; k++)
+		{
+			meta->GetInt(frames, i);
+			meta->GetFloat(time, d);
+			meta->GetBool(filtered, b);
+			sum += i + d + (b ? 1 : 0);
+		}
+		return sum;
+	};
+
+	C::UnloadContent("typed");
+	C::SetContentPrefix("content/");
+	std::remove("bench_typed.meta");
+}
+
+TEST_CASE("Unloading content", "[!benchmark][Content]")
+{
+	typedef Content<SlowContent> C;
+
+	for (bool deferred : { false, true })
+	{
+		C::SetDeferredDestructionEnabled(deferred);
+
+		BENCHMARK_ADVANCED(deferred ? "UnloadContent, deferred destruction" : "UnloadContent, immediate destruction")(Catch::Benchmark::Chronometer meter)
+		{
+			std::vector<std::string> aliases;
+			for (int i = 0; i < meter.runs(); i++)
+			{
+				aliases.push_back("slow_" + std::to_string(i));
+				C::LoadContent(aliases.back(), aliases.back());
+			}
+
+			meter.measure([&](int i) { return C::UnloadContent(aliases[i]); });
+			ContentReclaimer::Flush();
+		};
+	}
+
+	C::SetDeferredDestructionEnabled(false);
+}
+
+TEST_CASE("Content lookup under a memory budget", "[!benchmark][Content]")
+{
+	typedef Content<BenchContent> C;
+	std::vector<std::string> aliases;
+
+	for (Size i = 0; i < aliasCount; i++)
+	{
+		aliases.push_back("content_" + std::to_string(i));
+		C::LoadContent(aliases.back(), aliases.back());
+	}
+
+	for (Size budget : { Size(0), Size(aliasCount * sizeof(BenchContent)) })
+	{
+		C::SetMemoryBudget(budget);
+
+		BENCHMARK(budget == 0 ? "GetContent, no budget" : "GetContent, budget set")
+		{
+			Size sum = 0;
+			for (Size k = 0; k < benchCount; k++) sum += C::GetContent(aliases[k % aliasCount])->value;
+			return sum;
+		};
+	}
+
+	// Half the content fits, so every sweep of the lookups reloads evicted content on this thread, which set the budget
+	C::SetMemoryBudget(aliasCount / 2 * sizeof(BenchContent));
+	C::ResetCacheStats();
+
+	BENCHMARK("GetContent, half the content evicted")
+	{
+		Size sum = 0;
+		for (Size k = 0; k < benchCount; k++) sum += C::GetContent(aliases[k % aliasCount])->value;
+		return sum;
+	};
+
+	C::SetMemoryBudget(0);
+	for (const std::string& a : aliases) C::UnloadContent(a);
+}
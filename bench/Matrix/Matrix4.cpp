@@ -0,0 +1,131 @@
+#include "BenchValues.hpp"
+
+using namespace vlk;
+
+namespace
+{
+	std::vector<Matrix4> MakeTransforms()
+	{
+		std::vector<Float> f = RandomFloats(benchCount * 9, -4.0f, 4.0f);
+		std::vector<Matrix4> out(benchCount);
+		for (Size i = 0; i < benchCount; i++)
+		{
+			const Float* r = f.data() + i * 9;
+			out[i] =
+				Matrix4::CreateTranslation(Vector3(r[0], r[1], r[2])) *
+				Matrix4::CreateRotation(Vector3(r[3], r[4], r[5])) *
+				Matrix4::CreateScale(Vector3(r[6] + 5.0f, r[7] + 5.0f, r[8] + 5.0f));
+		}
+		return out;
+	}
+
+	MatrixBase<4, 4, Float> ToBase(const Matrix4& m)
+	{
+		MatrixBase<4, 4, Float> b;
+		for (Size x = 0; x < 4; x++)
+		{
+			for (Size y = 0; y < 4; y++) b[x][y] = m[x][y];
+		}
+		return b;
+	}
+}
+
+TEST_CASE("Matrix4 inverse", "[!benchmark][Matrix4]")
+{
+	std::vector<Matrix4> m = MakeTransforms();
+	std::vector<MatrixBase<4, 4, Float>> b;
+	for (const Matrix4& mm : m) b.push_back(ToBase(mm));
+
+	BENCHMARK("MatrixBase<4, 4, Float>::Inverse")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += b[i].Inverse()[3][3];
+		return acc;
+	};
+
+	BENCHMARK("Matrix4::operator!")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += (!m[i])[3][3];
+		return acc;
+	};
+
+	BENCHMARK("Matrix4::InverseAffine")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += m[i].InverseAffine()[3][3];
+		return acc;
+	};
+
+	BENCHMARK("MatrixBase<4, 4, Float>::Determinant")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += b[i].Determinant();
+		return acc;
+	};
+
+	BENCHMARK("Matrix4::Determinant")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += m[i].Determinant();
+		return acc;
+	};
+}
+
+TEST_CASE("Matrix4 multiplication", "[!benchmark][Matrix4]")
+{
+	std::vector<Matrix4> m = MakeTransforms();
+	std::vector<MatrixBase<4, 4, Float>> b;
+	for (const Matrix4& mm : m) b.push_back(ToBase(mm));
+
+	std::vector<Float> f = RandomFloats(benchCount * 4);
+	std::vector<Vector4> v(benchCount);
+	std::vector<MatrixBase<4, 4, Float>::ColType> c(benchCount);
+	for (Size i = 0; i < benchCount; i++)
+	{
+		v[i] = Vector4(f[i * 4], f[i * 4 + 1], f[i * 4 + 2], 1.0f);
+		c[i] = MatrixBase<4, 4, Float>::ColType({f[i * 4], f[i * 4 + 1], f[i * 4 + 2], 1.0f});
+	}
+
+	std::vector<Vector4> out(benchCount);
+
+	BENCHMARK("MatrixBase<4, 4, Float> * MatrixBase<4, 4, Float>")
+	{
+		MatrixBase<4, 4, Float> acc(b[0]);
+		for (Size i = 1; i < benchCount; i++) acc = b[i] * acc;
+		return acc[3][3];
+	};
+
+	BENCHMARK("Matrix4 * Matrix4")
+	{
+		Matrix4 acc(m[0]);
+		for (Size i = 1; i < benchCount; i++) acc = m[i] * acc;
+		return acc[3][3];
+	};
+
+	BENCHMARK("MatrixBase<4, 4, Float> * ColType")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += (b[i & 63] * c[i])[0];
+		return acc;
+	};
+
+	BENCHMARK("Matrix4 * Vector4")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += (m[i & 63] * v[i])[0];
+		return acc;
+	};
+
+	BENCHMARK("Matrix4 * Vector4 loop")
+	{
+		for (Size i = 0; i < benchCount; i++) out[i] = m[0] * v[i];
+		return out[benchCount - 1][0];
+	};
+
+	BENCHMARK("Matrix4::TransformPoints")
+	{
+		m[0].TransformPoints(v.data(), out.data(), benchCount);
+		return out[benchCount - 1][0];
+	};
+}
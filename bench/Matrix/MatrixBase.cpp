@@ -0,0 +1,101 @@
+#include "BenchValues.hpp"
+#include <string>
+
+using namespace vlk;
+
+namespace
+{
+	// The recursive cofactor expansion used below VLK_COMMON_LU_THRESHOLD,
+	// reproduced here so it can be compared at every size.
+	template <Size N>
+	struct Cofactor
+	{
+		static Float Determinant(const MatrixBase<N, N, Float>& m)
+		{
+			Float det = 0.0f;
+			Float mod = 1.0f;
+
+			for (Size n = 0; n < N; n++)
+			{
+				MatrixBase<N - 1, N - 1, Float> sub;
+				Size x1 = 0;
+
+				for (Size x = 0; x < N; x++)
+				{
+					if (x == n) continue;
+					for (Size y = 1; y < N; y++) sub[x1][y - 1] = m[x][y];
+					x1++;
+				}
+
+				det += mod * m[n][0] * Cofactor<N - 1>::Determinant(sub);
+				mod = -mod;
+			}
+
+			return det;
+		}
+	};
+
+	template <>
+	struct Cofactor<1>
+	{
+		static Float Determinant(const MatrixBase<1, 1, Float>& m) { return m[0][0]; }
+	};
+
+	template <Size N>
+	MatrixBase<N, N, Float> MakeMatrix()
+	{
+		std::vector<Float> f = RandomFloats(N * N, -1.0f, 1.0f);
+		MatrixBase<N, N, Float> m;
+		for (Size x = 0; x < N; x++)
+		{
+			for (Size y = 0; y < N; y++) m[x][y] = f[x * N + y];
+			m[x][x] += static_cast<Float>(N);
+		}
+		return m;
+	}
+
+	template <Size N>
+	void BenchmarkSize()
+	{
+		const MatrixBase<N, N, Float> m = MakeMatrix<N>();
+		const VectorBase<N, Float> b(m[0]);
+		const std::string n = std::to_string(N) + "x" + std::to_string(N);
+
+		// Cofactor expansion is factorial, stop before it takes seconds per sample
+		if (N <= 8)
+		{
+			BENCHMARK("Cofactor determinant " + n)
+			{
+				return Cofactor<N>::Determinant(m);
+			};
+		}
+
+		BENCHMARK("LU determinant " + n)
+		{
+			return MatrixBase<N, N, Float>::Determinant(m.Decompose());
+		};
+
+		BENCHMARK("LU inverse " + n)
+		{
+			return MatrixBase<N, N, Float>::Inverse(m.Decompose());
+		};
+
+		BENCHMARK("LU solve " + n)
+		{
+			return m.Solve(b);
+		};
+	}
+}
+
+TEST_CASE("MatrixBase determinant and inverse sweep", "[!benchmark][MatrixBase]")
+{
+	BenchmarkSize<2>();
+	BenchmarkSize<3>();
+	BenchmarkSize<4>();
+	BenchmarkSize<5>();
+	BenchmarkSize<6>();
+	BenchmarkSize<7>();
+	BenchmarkSize<8>();
+	BenchmarkSize<9>();
+	BenchmarkSize<10>();
+}
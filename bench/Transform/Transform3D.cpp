@@ -0,0 +1,67 @@
+#include "BenchValues.hpp"
+
+using namespace vlk;
+
+namespace
+{
+	//! Builds a single chain of <tt>depth</tt> transforms, each parented to the previous one.
+	std::vector<Transform3D> MakeChain(Size depth, bool caching)
+	{
+		std::vector<Float> f = RandomFloats(depth * 6, -1.0f, 1.0f);
+		std::vector<Transform3D> chain(depth);
+		for (Size i = 0; i < depth; i++)
+		{
+			const Float* r = f.data() + i * 6;
+			chain[i].translation = Vector3(r[0], r[1], r[2]);
+			chain[i].rotation = Quaternion::AngleAxis(r[3], Vector3::Normalized(Vector3(r[4], r[5], 1.0f)));
+			chain[i].SetCachingEnabled(caching);
+			if (i > 0) chain[i].SetParent(&chain[i - 1]);
+		}
+		return chain;
+	}
+}
+
+TEST_CASE("Transform3D world queries", "[!benchmark][Transform3D]")
+{
+	for (Size depth : { Size(4), Size(16), Size(64) })
+	{
+		std::vector<Transform3D> uncached = MakeChain(depth, false);
+		std::vector<Transform3D> cached = MakeChain(depth, true);
+
+		// Queries every bone of the chain once per frame, as a skinning pass would
+		BENCHMARK("Uncached world matrices, depth " + std::to_string(depth))
+		{
+			Float acc = 0.0f;
+			for (const Transform3D& t : uncached) acc += t.GetWorldMatrix()[3][0];
+			return acc;
+		};
+
+		BENCHMARK("Cached world matrices, depth " + std::to_string(depth))
+		{
+			Float acc = 0.0f;
+			for (const Transform3D& t : cached) acc += t.GetWorldMatrix()[3][0];
+			return acc;
+		};
+
+		// A root modification forces every cached matrix to be rebuilt once
+		BENCHMARK("Cached world matrices after root change, depth " + std::to_string(depth))
+		{
+			cached[0].SetTranslation(cached[0].translation);
+			Float acc = 0.0f;
+			for (const Transform3D& t : cached) acc += t.GetWorldMatrix()[3][0];
+			return acc;
+		};
+
+		BENCHMARK("Uncached leaf translation, rotation and scale, depth " + std::to_string(depth))
+		{
+			const Transform3D& leaf = uncached.back();
+			return leaf.GetWorldTranslation()[0] + leaf.GetWorldRotation()[0] + leaf.GetWorldScale()[0];
+		};
+
+		BENCHMARK("Cached leaf translation, rotation and scale, depth " + std::to_string(depth))
+		{
+			const Transform3D& leaf = cached.back();
+			return leaf.GetWorldTranslation()[0] + leaf.GetWorldRotation()[0] + leaf.GetWorldScale()[0];
+		};
+	}
+}
@@ -0,0 +1,102 @@
+#include "BenchValues.hpp"
+#include "ValkyrieEngineCommon/TransformGraph.hpp"
+
+using namespace vlk;
+
+namespace
+{
+	constexpr Size graphSize = 100000;
+
+	//! Builds a random tree of transforms, each parented to a random earlier transform.
+	void MakeTree(std::vector<Transform3D>& tree, bool caching)
+	{
+		std::vector<Float> f = RandomFloats(graphSize * 7, 0.0f, 1.0f);
+		tree.resize(graphSize);
+		for (Size i = 0; i < graphSize; i++)
+		{
+			const Float* r = f.data() + i * 7;
+			tree[i].translation = Vector3(r[0], r[1], r[2]);
+			tree[i].rotation = Quaternion::AngleAxis(r[3], Vector3::Normalized(Vector3(r[4], r[5], 1.0f)));
+			tree[i].SetCachingEnabled(caching);
+			if (i > 0) tree[i].SetParent(&tree[static_cast<Size>(r[6] * Float(i)) % i]);
+		}
+	}
+}
+
+TEST_CASE("TransformGraph3D world matrices", "[!benchmark][TransformGraph3D]")
+{
+	std::vector<Transform3D> uncached;
+	std::vector<Transform3D> cached;
+	MakeTree(uncached, false);
+	MakeTree(cached, true);
+
+	std::vector<const Transform3D*> pointers;
+	for (const Transform3D& t : uncached) pointers.push_back(&t);
+
+	TransformGraph3D graph;
+	graph.Import(pointers);
+	graph.UpdateWorldMatrices();
+
+	BENCHMARK("Transform3D::GetWorldMatrix, 100k nodes")
+	{
+		Float acc = 0.0f;
+		for (const Transform3D& t : uncached) acc += t.GetWorldMatrix()[3][0];
+		return acc;
+	};
+
+	// Every cached matrix is rebuilt once, as after animating every node
+	BENCHMARK("Cached Transform3D::GetWorldMatrix, all dirty, 100k nodes")
+	{
+		for (Transform3D& t : cached) t.Invalidate();
+		Float acc = 0.0f;
+		for (const Transform3D& t : cached) acc += t.GetWorldMatrix()[3][0];
+		return acc;
+	};
+
+	BENCHMARK("TransformGraph3D::UpdateWorldMatrices, 100k nodes")
+	{
+		graph.UpdateWorldMatrices();
+		return graph.GetWorldMatrix(graphSize - 1)[3][0];
+	};
+
+	BENCHMARK("TransformGraph3D::Import, 100k nodes")
+	{
+		TransformGraph3D g;
+		return g.Import(pointers).size();
+	};
+}
+
+TEST_CASE("TransformGraph3D parallel world matrices", "[!benchmark][TransformGraph3D]")
+{
+	std::vector<Transform3D> tree;
+	MakeTree(tree, false);
+
+	std::vector<const Transform3D*> pointers;
+	for (const Transform3D& t : tree) pointers.push_back(&t);
+
+	TransformGraph3D graph;
+	graph.Import(pointers);
+
+	BENCHMARK("Serial update, 100k nodes")
+	{
+		graph.UpdateWorldMatrices();
+		return graph.GetWorldMatrix(graphSize - 1)[3][0];
+	};
+
+	// The calling thread takes part in the update, so a pool of n - 1 workers uses n threads
+	const Size hardwareThreads = std::max<Size>(std::thread::hardware_concurrency(), 1);
+	std::vector<Size> threadCounts;
+	for (Size threads = 1; threads < hardwareThreads; threads *= 2) threadCounts.push_back(threads);
+	threadCounts.push_back(hardwareThreads);
+
+	for (Size threads : threadCounts)
+	{
+		ThreadPool pool(threads - 1);
+
+		BENCHMARK("Parallel update, 100k nodes, " + std::to_string(threads) + " threads")
+		{
+			graph.UpdateWorldMatrices(pool);
+			return graph.GetWorldMatrix(graphSize - 1)[3][0];
+		};
+	}
+}
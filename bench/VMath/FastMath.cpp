@@ -0,0 +1,89 @@
+#include "BenchValues.hpp"
+#include "ValkyrieEngineCommon/FastMath.hpp"
+
+using namespace vlk;
+
+TEST_CASE("Fast sine and cosine", "[!benchmark][FastMath]")
+{
+	const std::vector<Float> angles = RandomFloats(benchCount, -TwoPi, TwoPi);
+	std::vector<Float> sines(benchCount), cosines(benchCount);
+
+	BENCHMARK("vlk::Sin and vlk::Cos")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += Sin(angles[i]) * Cos(angles[i]);
+		return acc;
+	};
+
+	BENCHMARK("vlk::SinCos")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++)
+		{
+			Float s, c;
+			SinCos(angles[i], s, c);
+			acc += s * c;
+		}
+		return acc;
+	};
+
+	BENCHMARK("vlk::SinCos batch")
+	{
+		SinCos(angles.data(), sines.data(), cosines.data(), angles.size());
+		return sines[benchCount - 1] * cosines[benchCount - 1];
+	};
+}
+
+TEST_CASE("Fast arc tangent", "[!benchmark][FastMath]")
+{
+	const std::vector<Float> y = RandomFloats(benchCount);
+	std::vector<Float> x = RandomFloats(benchCount * 2);
+	x.erase(x.begin(), x.begin() + benchCount);
+	std::vector<Float> out(benchCount);
+
+	BENCHMARK("vlk::ATan2")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += ATan2(y[i], x[i]);
+		return acc;
+	};
+
+	BENCHMARK("vlk::FastATan2")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += FastATan2(y[i], x[i]);
+		return acc;
+	};
+
+	BENCHMARK("vlk::FastATan2 batch")
+	{
+		FastATan2(y.data(), x.data(), out.data(), out.size());
+		return out[benchCount - 1];
+	};
+}
+
+TEST_CASE("Fast arc cosine", "[!benchmark][FastMath]")
+{
+	const std::vector<Float> f = RandomFloats(benchCount, -1.0f, 1.0f);
+	std::vector<Float> out(benchCount);
+
+	BENCHMARK("vlk::ACos")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += ACos(f[i]);
+		return acc;
+	};
+
+	BENCHMARK("vlk::FastACos")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += FastACos(f[i]);
+		return acc;
+	};
+
+	BENCHMARK("vlk::FastACos batch")
+	{
+		FastACos(f.data(), out.data(), out.size());
+		return out[benchCount - 1];
+	};
+}
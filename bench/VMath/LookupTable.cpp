@@ -0,0 +1,49 @@
+#include "BenchValues.hpp"
+#include "ValkyrieEngineCommon/LookupTable.hpp"
+
+using namespace vlk;
+
+TEST_CASE("Sine lookup table", "[!benchmark][LookupTable]")
+{
+	const std::vector<Float> angles = RandomFloats(benchCount, -TwoPi, TwoPi);
+
+	BENCHMARK("vlk::Sin")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += Sin(angles[i]);
+		return acc;
+	};
+
+	BENCHMARK("vlk::SinTable<256>")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += SinTable<256>(angles[i]);
+		return acc;
+	};
+
+	BENCHMARK("vlk::SinTable<1024>")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += SinTable<1024>(angles[i]);
+		return acc;
+	};
+}
+
+TEST_CASE("Easing lookup table", "[!benchmark][LookupTable]")
+{
+	const std::vector<Float> times = RandomFloats(benchCount, 0.0f, 1.0f);
+
+	BENCHMARK("Elastic easing with vlk::Pow and vlk::Sin")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += Pow(2.0f, -10.0f * times[i]) * Sin((10.0f * times[i] - 0.75f) * (TwoPi / 3.0f)) + 1.0f;
+		return acc;
+	};
+
+	BENCHMARK("vlk::EasingTable<OutElastic>")
+	{
+		Float acc = 0.0f;
+		for (Size i = 0; i < benchCount; i++) acc += EasingTable<Easing::OutElastic>(times[i]);
+		return acc;
+	};
+}
@@ -0,0 +1,97 @@
+#include "BenchValues.hpp"
+#include "ValkyrieEngineCommon/VMathBatch.hpp"
+#include <string>
+
+using namespace vlk;
+
+namespace
+{
+	const char* LevelName(SIMDLevel level)
+	{
+		switch (level)
+		{
+			case SIMDLevel::Scalar: return "scalar";
+			case SIMDLevel::SSE2: return "SSE2";
+			case SIMDLevel::AVX2: return "AVX2";
+			case SIMDLevel::AVX512: return "AVX-512";
+		}
+
+		return "unknown";
+	}
+
+	//! Benchmarks a bulk function at every level the CPU supports.
+	template <typename Batch>
+	void BenchmarkLevels(const std::string& name, const std::vector<Float>& in, std::vector<Float>& out, Batch batch)
+	{
+		const SIMDLevel detected = DetectSIMDLevel();
+
+		for (int l = 0; l <= static_cast<int>(detected); l++)
+		{
+			SetSIMDLevel(static_cast<SIMDLevel>(l));
+
+			BENCHMARK(name + " batch, " + LevelName(static_cast<SIMDLevel>(l)))
+			{
+				batch(in.data(), out.data(), out.size());
+				return out[benchCount - 1];
+			};
+		}
+
+		SetSIMDLevel(detected);
+	}
+}
+
+TEST_CASE("Bulk square root", "[!benchmark][VMathBatch]")
+{
+	const std::vector<Float> in = RandomFloats(benchCount, 0.0f, 100.0f);
+	std::vector<Float> out(benchCount);
+
+	BENCHMARK("vlk::Sqrt")
+	{
+		for (Size i = 0; i < benchCount; i++) out[i] = Sqrt(in[i]);
+		return out[benchCount - 1];
+	};
+
+	BenchmarkLevels("vlk::Sqrt", in, out, [](const Float* i, Float* o, Size n) { Sqrt(i, o, n); });
+}
+
+TEST_CASE("Bulk floor", "[!benchmark][VMathBatch]")
+{
+	const std::vector<Float> in = RandomFloats(benchCount);
+	std::vector<Float> out(benchCount);
+
+	BENCHMARK("vlk::Floor")
+	{
+		for (Size i = 0; i < benchCount; i++) out[i] = Floor(in[i]);
+		return out[benchCount - 1];
+	};
+
+	BenchmarkLevels("vlk::Floor", in, out, [](const Float* i, Float* o, Size n) { Floor(i, o, n); });
+}
+
+TEST_CASE("Bulk round", "[!benchmark][VMathBatch]")
+{
+	const std::vector<Float> in = RandomFloats(benchCount);
+	std::vector<Float> out(benchCount);
+
+	BENCHMARK("vlk::Round")
+	{
+		for (Size i = 0; i < benchCount; i++) out[i] = Round(in[i]);
+		return out[benchCount - 1];
+	};
+
+	BenchmarkLevels("vlk::Round", in, out, [](const Float* i, Float* o, Size n) { Round(i, o, n); });
+}
+
+TEST_CASE("Bulk absolute value", "[!benchmark][VMathBatch]")
+{
+	const std::vector<Float> in = RandomFloats(benchCount);
+	std::vector<Float> out(benchCount);
+
+	BENCHMARK("vlk::Abs")
+	{
+		for (Size i = 0; i < benchCount; i++) out[i] = Abs(in[i]);
+		return out[benchCount - 1];
+	};
+
+	BenchmarkLevels("vlk::Abs", in, out, [](const Float* i, Float* o, Size n) { Abs(i, o, n); });
+}
@@ -0,0 +1,102 @@
+#include "BenchValues.hpp"
+#include "ValkyrieEngineCommon/VectorStream.hpp"
+
+using namespace vlk;
+
+namespace
+{
+	std::vector<Vector3> MakeVectors(Size offset)
+	{
+		std::vector<Float> f = RandomFloats(benchCount * 3 + offset);
+		std::vector<Vector3> out(benchCount);
+		for (Size i = 0; i < benchCount; i++)
+		{
+			out[i] = Vector3(f[offset + i * 3], f[offset + i * 3 + 1], f[offset + i * 3 + 2]);
+		}
+		return out;
+	}
+}
+
+TEST_CASE("Vector3Stream kernels", "[!benchmark][Vector3Stream]")
+{
+	std::vector<Vector3> a = MakeVectors(0);
+	std::vector<Vector3> b = MakeVectors(1);
+	std::vector<Vector3> c(benchCount);
+	std::vector<Float> f(benchCount);
+
+	Vector3Stream sa(a);
+	Vector3Stream sb(b);
+	Vector3Stream sc(benchCount);
+
+	BENCHMARK("std::vector<Vector3> add")
+	{
+		for (Size i = 0; i < benchCount; i++) c[i] = a[i] + b[i];
+		return c[0];
+	};
+
+	BENCHMARK("Vector3Stream::Add")
+	{
+		Vector3Stream::Add(sa, sb, sc);
+		return sc.X()[0];
+	};
+
+	BENCHMARK("std::vector<Vector3> dot")
+	{
+		for (Size i = 0; i < benchCount; i++) f[i] = Vector3::Dot(a[i], b[i]);
+		return f[0];
+	};
+
+	BENCHMARK("Vector3Stream::Dot")
+	{
+		Vector3Stream::Dot(sa, sb, f.data());
+		return f[0];
+	};
+
+	BENCHMARK("std::vector<Vector3> cross")
+	{
+		for (Size i = 0; i < benchCount; i++) c[i] = Vector3::Cross(a[i], b[i]);
+		return c[0];
+	};
+
+	BENCHMARK("Vector3Stream::Cross")
+	{
+		Vector3Stream::Cross(sa, sb, sc);
+		return sc.X()[0];
+	};
+
+	BENCHMARK("std::vector<Vector3> normalize")
+	{
+		for (Size i = 0; i < benchCount; i++) c[i] = Vector3::Normalized(a[i]);
+		return c[0];
+	};
+
+	BENCHMARK("Vector3Stream::Normalized")
+	{
+		Vector3Stream::Normalized(sa, sc);
+		return sc.X()[0];
+	};
+
+	BENCHMARK("std::vector<Vector3> fast normalize")
+	{
+		Vector3::FastNormalized(a.data(), c.data(), c.size());
+		return c[0];
+	};
+
+	BENCHMARK("Vector3Stream::FastNormalized")
+	{
+		Vector3Stream::FastNormalized(sa, sc);
+		return sc.X()[0];
+	};
+
+	BENCHMARK("std::vector<Vector3> lerp")
+	{
+		for (Size i = 0; i < benchCount; i++) c[i] = Vector3::Lerp(a[i], b[i], 0.5f);
+		return c[0];
+	};
+
+	BENCHMARK("Vector3Stream::Lerp")
+	{
+		Vector3Stream::Lerp(sa, sb, 0.5f, sc);
+		return sc.X()[0];
+	};
+}
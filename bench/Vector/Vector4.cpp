@@ -0,0 +1,111 @@
+#include "BenchValues.hpp"
+
+using namespace vlk;
+
+namespace
+{
+	// Scalar loops identical to the generic VectorBase template, which
+	// VectorBase<4, Float> replaces.
+	struct ScalarVector4
+	{
+		Float data[4];
+
+		ScalarVector4 operator+(const ScalarVector4& rhs) const
+		{
+			ScalarVector4 tmp;
+			for (Size i = 0; i < 4; i++) tmp.data[i] = data[i] + rhs.data[i];
+			return tmp;
+		}
+
+		ScalarVector4 operator*(const Float v) const
+		{
+			ScalarVector4 tmp;
+			for (Size i = 0; i < 4; i++) tmp.data[i] = data[i] * v;
+			return tmp;
+		}
+
+		ScalarVector4& operator+=(const ScalarVector4& rhs)
+		{
+			for (Size i = 0; i < 4; i++) data[i] += rhs.data[i];
+			return *this;
+		}
+
+		bool operator==(const ScalarVector4& rhs) const
+		{
+			for (Size i = 0; i < 4; i++)
+			{
+				if (data[i] != rhs.data[i]) return false;
+			}
+
+			return true;
+		}
+	};
+
+	template <typename V>
+	std::vector<V> MakeVectors()
+	{
+		std::vector<Float> f = RandomFloats(benchCount * 4);
+		std::vector<V> out(benchCount);
+		for (Size i = 0; i < benchCount; i++)
+		{
+			for (Size j = 0; j < 4; j++) out[i].data[j] = f[i * 4 + j];
+		}
+		return out;
+	}
+}
+
+TEST_CASE("Vector4 arithmetic", "[!benchmark][Vector4]")
+{
+	std::vector<VectorBase<4, Float>> a = MakeVectors<VectorBase<4, Float>>();
+	std::vector<VectorBase<4, Float>> b = MakeVectors<VectorBase<4, Float>>();
+	std::vector<ScalarVector4> sa = MakeVectors<ScalarVector4>();
+	std::vector<ScalarVector4> sb = MakeVectors<ScalarVector4>();
+
+	BENCHMARK("Scalar a * s + b")
+	{
+		ScalarVector4 acc {};
+		for (Size i = 0; i < benchCount; i++) acc += sa[i] * 0.5f + sb[i];
+		return acc;
+	};
+
+	BENCHMARK("VectorBase<4, Float> a * s + b")
+	{
+		VectorBase<4, Float> acc;
+		for (Size i = 0; i < benchCount; i++) acc += a[i] * 0.5f + b[i];
+		return acc;
+	};
+
+	BENCHMARK("Scalar equality")
+	{
+		Size count = 0;
+		for (Size i = 0; i < benchCount; i++) count += (sa[i] == sb[i]);
+		return count;
+	};
+
+	BENCHMARK("VectorBase<4, Float> equality")
+	{
+		Size count = 0;
+		for (Size i = 0; i < benchCount; i++) count += (a[i] == b[i]);
+		return count;
+	};
+}
+
+TEST_CASE("Quaternion normalize", "[!benchmark][Vector4]")
+{
+	const std::vector<Float> f = RandomFloats(benchCount * 4);
+	std::vector<Quaternion> q(benchCount);
+	for (Size i = 0; i < benchCount; i++) q[i] = Quaternion(f[i * 4], f[i * 4 + 1], f[i * 4 + 2], f[i * 4 + 3]);
+	std::vector<Quaternion> out(benchCount);
+
+	BENCHMARK("Quaternion::Normalized")
+	{
+		for (Size i = 0; i < benchCount; i++) out[i] = Quaternion::Normalized(q[i]);
+		return out[0];
+	};
+
+	BENCHMARK("Quaternion::FastNormalized")
+	{
+		Quaternion::FastNormalized(q.data(), out.data(), out.size());
+		return out[0];
+	};
+}
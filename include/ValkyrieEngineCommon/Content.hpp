@@ -3,13 +3,32 @@
 
 #include "ValkyrieEngine/EventBus.hpp"
 #include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include "ValkyrieEngineCommon/ContentArchive.hpp"
+#include "ValkyrieEngineCommon/ContentMetadata.hpp"
+#include "ValkyrieEngineCommon/ContentStats.hpp"
+#include "ValkyrieEngineCommon/Epoch.hpp"
+#include "ValkyrieEngineCommon/MappedFile.hpp"
+#include "ValkyrieEngineCommon/ReadMostlyMap.hpp"
+#include "ValkyrieEngineCommon/SlotArray.hpp"
+#include "ValkyrieEngineCommon/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <shared_mutex>
+#include <vector>
 
 namespace vlk
 {
@@ -64,147 +83,1687 @@ namespace vlk
 		throw std::runtime_error("Generic template for vlk::ConstructContent called. Template must be specialized.");
 	}
 
+	/*!
+	 * \brief Reports the memory used by content of type T.
+	 *
+	 * Used to account loaded content against the memory budget of
+	 * vlk::Content<T>. The default reports <tt>sizeof(T)</tt>, so types
+	 * owning more memory, such as textures or meshes, should specialize it.
+	 *
+	 * This function must not invoke any member of <tt>vlk::Content<T></tt>
+	 * while it is executing.
+	 *
+	 * \param t The content to measure.
+	 *
+	 * \returns The number of bytes used by <tt>t</tt>.
+	 *
+	 * \sa vlk::Content<T>::SetMemoryBudget(Size)
+	 */
+	template <typename T>
+	Size ContentSize(const T&)
+	{
+		return sizeof(T);
+	}
+
+	/*!
+	 * \brief A read-only view of the bytes of a content file.
+	 *
+	 * \sa vlk::MapContent
+	 */
+	struct ContentView
+	{
+		//! First byte of the file, or nullptr if the file is empty.
+		const UByte* data;
+
+		//! Size of the file in bytes.
+		Size size;
+	};
+
+	/*!
+	 * \brief Selects how content of type T is constructed.
+	 *
+	 * By default <tt>vlk::ConstructContent(const std::string&)</tt> is
+	 * called with the path of the file to load. Specializing this template
+	 * to derive from <tt>std::true_type</tt> makes vlk::Content<T> map the
+	 * file into memory and call
+	 * <tt>vlk::ConstructContent(const std::string&, const ContentView&)</tt>
+	 * instead, so content can be parsed in place without reading the file
+	 * into a buffer first.
+	 *
+	 * The mapping stays valid until <tt>vlk::DestroyContent(T*)</tt> has
+	 * been called for the content constructed from it, so the content may
+	 * keep pointers into the view. Files that can not be mapped fail to load
+	 * without calling <tt>vlk::ConstructContent</tt>.
+	 */
+	template <typename T>
+	struct MapContent : std::false_type { };
+
+	/*!
+	 * \brief Constructs content of type T from a memory-mapped file.
+	 *
+	 * Only called if vlk::MapContent<T> is specialized to derive from
+	 * <tt>std::true_type</tt>, and must be specialized in that case. The
+	 * same requirements as for
+	 * <tt>vlk::ConstructContent(const std::string&)</tt> apply.
+	 *
+	 * \param path The location of the content file on the disk.
+	 * \param view The contents of the file. Remains valid until the
+	 * returned content is destroyed.
+	 *
+	 * \returns An owning pointer to an instance of T if constructing the
+	 * content succeeds, otherwise returns nullptr.
+	 */
+	template <typename T>
+	VLK_NODISCARD T* ConstructContent(const std::string&, const ContentView&)
+	{
+		VLK_STATIC_ASSERT_MSG((!std::is_same<T, T>::value), "Generic template for vlk::ConstructContent being compiled. Template must be specialized.");
+		throw std::runtime_error("Generic template for vlk::ConstructContent called. Template must be specialized.");
+		return nullptr;
+	}
+
+	template <typename T>
+	class Content;
+
+	/*!
+	 * \brief Owns the thread pool shared by every
+	 * <tt>vlk::Content<T>::LoadContentAsync(const std::string&, const std::string&)</tt>.
+	 */
+	class ContentLoader
+	{
+		static inline std::unique_ptr<ThreadPool>& Instance()
+		{
+			static std::unique_ptr<ThreadPool> pool;
+			return pool;
+		}
+
+		static inline std::mutex& InstanceMutex()
+		{
+			static std::mutex m;
+			return m;
+		}
+
+		static inline Size& RequestedThreadCount()
+		{
+			static Size count = std::max<Size>(std::thread::hardware_concurrency(), 2) - 1;
+			return count;
+		}
+
+		public:
+		/*!
+		 * \brief Sets the number of loader threads.
+		 *
+		 * By default one less than the number of hardware threads is used, so
+		 * loading does not compete with the main thread.
+		 *
+		 * \throws std::runtime_error if the loader pool has already been started.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 */
+		static inline void SetThreadCount(Size count)
+		{
+			std::lock_guard<std::mutex> lock(InstanceMutex());
+			if (Instance()) throw std::runtime_error("The content loader pool has already been started.");
+			RequestedThreadCount() = count;
+		}
+
+		/*!
+		 * \brief Returns the loader pool, starting it on first use.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 */
+		static inline ThreadPool& Pool()
+		{
+			std::lock_guard<std::mutex> lock(InstanceMutex());
+			if (!Instance()) Instance().reset(new ThreadPool(RequestedThreadCount()));
+			return *Instance();
+		}
+	};
+
+	/*!
+	 * \brief Destroys retired content on a background thread once no reader
+	 * can still be using it.
+	 *
+	 * Content is retired through the process-wide EpochDomain, so it stays
+	 * alive until every EpochGuard that was active when it was retired has
+	 * ended. The destruction itself then runs on a dedicated thread, which is
+	 * started on first use.
+	 *
+	 * \sa vlk::Content<T>::SetDeferredDestructionEnabled(bool)
+	 */
+	class ContentReclaimer
+	{
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::vector<std::function<void()>> ready;
+
+		//! Retired functions that have not finished running yet.
+		Size outstanding;
+		bool stopping;
+		std::condition_variable idle;
+		std::thread thread;
+
+		//! Set once the reclaimer has been destroyed at exit. Like content still loaded at exit, content retired after that is not destroyed.
+		static inline std::atomic<bool>& Stopped()
+		{
+			static std::atomic<bool> stopped(false);
+			return stopped;
+		}
+
+		// The epoch domain is constructed first, so it outlives the reclaimer
+		inline ContentReclaimer() : mutex(), wake(), ready(), outstanding(0), stopping(false), idle(), thread()
+		{
+			EpochDomain::Global();
+			thread = std::thread([this]() { Run(); });
+		}
+
+		inline ~ContentReclaimer()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+
+			wake.notify_all();
+			thread.join();
+			Stopped().store(true, std::memory_order_release);
+		}
+
+		static inline ContentReclaimer& Instance()
+		{
+			static ContentReclaimer reclaimer;
+			return reclaimer;
+		}
+
+		//! Queues a function whose content no reader can be using anymore.
+		inline void Ready(std::function<void()> destroy)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				ready.push_back(std::move(destroy));
+			}
+
+			wake.notify_all();
+		}
+
+		inline void Run()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			while (true)
+			{
+				if (ready.empty())
+				{
+					if (stopping) return;
+
+					// Content still waiting for readers is collected periodically
+					if (outstanding > 0) wake.wait_for(lock, std::chrono::milliseconds(1));
+					else wake.wait(lock);
+				}
+
+				if (ready.empty())
+				{
+					lock.unlock();
+					EpochDomain::Global().Collect();
+					lock.lock();
+					continue;
+				}
+
+				std::vector<std::function<void()>> batch;
+				batch.swap(ready);
+				lock.unlock();
+
+				for (std::function<void()>& f : batch) f();
+
+				lock.lock();
+				outstanding -= batch.size();
+				if (outstanding == 0) idle.notify_all();
+			}
+		}
+
+		public:
+		ContentReclaimer(const ContentReclaimer&) = delete;
+		ContentReclaimer& operator=(const ContentReclaimer&) = delete;
+
+		/*!
+		 * \brief Schedules a function destroying content that has been made
+		 * unreachable.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 */
+		static inline void Retire(std::function<void()> destroy)
+		{
+			ContentReclaimer& r = Instance();
+
+			{
+				std::lock_guard<std::mutex> lock(r.mutex);
+				r.outstanding++;
+			}
+
+			EpochDomain::Global().Retire([destroy]()
+			{
+				if (!Stopped().load(std::memory_order_acquire)) Instance().Ready(destroy);
+			});
+
+			r.wake.notify_all();
+		}
+
+		/*!
+		 * \brief Blocks until all content retired so far has been destroyed.
+		 *
+		 * Must not be called while the calling thread is inside an
+		 * EpochGuard, or while another thread stays inside one indefinitely.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 * This function may block the calling thread.<br>
+		 */
+		static inline void Flush()
+		{
+			ContentReclaimer& r = Instance();
+			std::unique_lock<std::mutex> lock(r.mutex);
+			r.idle.wait(lock, [&r]() { return r.outstanding == 0; });
+		}
+
+		/*!
+		 * \brief Returns the number of retired pieces of content that have not
+		 * been destroyed yet.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 */
+		static inline Size Outstanding()
+		{
+			ContentReclaimer& r = Instance();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			return r.outstanding;
+		}
+	};
+
+	/*!
+	 * \brief A stable reference to loaded content of type T.
+	 *
+	 * A handle is a generational index into the slots of Content<T>.
+	 * Dereferencing one with Get() is a constant time array access that does
+	 * not hash or compare strings, so handles should be preferred over
+	 * aliases wherever content is looked up repeatedly.
+	 *
+	 * A handle is invalidated when its content is unloaded or replaced by
+	 * loading new content under the same alias, after which Get() returns
+	 * nullptr. Call Content<T>::Resolve(const std::string&) again to obtain a
+	 * handle to the new content.
+	 *
+	 * \sa vlk::Content<T>::Resolve(const std::string&)
+	 */
+	template <typename T>
+	class ContentHandle
+	{
+		friend class Content<T>;
+
+		UInt index;
+		UInt generation;
+
+		inline constexpr ContentHandle(UInt i, UInt g) : index(i), generation(g) { }
+
+		public:
+		//! Constructs a null handle.
+		inline constexpr ContentHandle() : index(0), generation(0) { }
+
+		//! Returns true if this handle was never assigned content. A handle that is not null may still be stale.
+		inline constexpr bool IsNull() const { return generation == 0; }
+
+		/*!
+		 * \brief Returns the content this handle refers to.
+		 *
+		 * \return A pointer to the content, or nullptr if the handle is null
+		 * or its content has been unloaded or replaced.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Does not lock.<br>
+		 */
+		inline const T* Get() const;
+
+		inline constexpr bool operator==(const ContentHandle& other) const
+		{
+			return index == other.index && generation == other.generation;
+		}
+
+		inline constexpr bool operator!=(const ContentHandle& other) const
+		{
+			return !(*this == other);
+		}
+	};
+
 	template <typename T>
 	class Content
 	{
-		static void LoadMetadata(const std::string& path, const std::string& alias)
+		//! Stores content in a free slot and returns a handle to it.
+		static inline ContentHandle<T> Allocate(T* t)
+		{
+			ContentHandle<T> handle;
+			slots.Allocate(t, handle.index, handle.generation);
+			return handle;
+		}
+
+		typedef std::unique_ptr<const ContentMetadata> MetadataPtr;
+
+		//! Locks mtx, recording the time spent waiting for it.
+		template <typename Lock>
+		static inline void Acquire(Lock& lock)
+		{
+			const ContentStatsRecorder::Timestamp start = stats.Start();
+			lock.lock();
+			stats.Record(ContentStatsRecorder::LockWait, start);
+		}
+
+		static inline T* Construct(const std::string& file, std::false_type)
+		{
+			return vlk::ConstructContent<T>(file);
+		}
+
+		static inline T* Construct(const std::string& file, std::true_type)
+		{
+			std::shared_ptr<MappedFile> mapped = std::make_shared<MappedFile>(file);
+			if (!mapped->IsOpen()) return nullptr;
+
+			T* t = vlk::ConstructContent<T>(file, ContentView{mapped->Data(), mapped->Length()});
+			if (t) KeepAlive(t, std::move(mapped));
+			return t;
+		}
+
+		static inline T* ConstructArchived(const std::string&, const ContentArchive::Entry&, const std::shared_ptr<const ContentArchive>&, std::false_type)
+		{
+			throw std::runtime_error("Content loaded from a content archive must specialize vlk::MapContent.");
+		}
+
+		static inline T* ConstructArchived(const std::string& path, const ContentArchive::Entry& entry, const std::shared_ptr<const ContentArchive>& archive, std::true_type)
+		{
+			T* t = vlk::ConstructContent<T>(path, ContentView{entry.data, entry.size});
+			if (t) KeepAlive(t, archive);
+			return t;
+		}
+
+		//! Keeps the memory content was constructed from alive until the content is destroyed.
+		static inline void KeepAlive(const T* t, std::shared_ptr<const void> owner)
+		{
+			std::lock_guard<std::mutex> lock(mappingMutex);
+			mappings[t] = std::move(owner);
+		}
+
+		//! Where content is loaded from, captured when a load starts.
+		struct Source
+		{
+			std::string prefix;
+			std::shared_ptr<const ContentArchive> archive;
+			bool metadataCache;
+		};
+
+		static inline Source CurrentSource()
+		{
+			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+			Acquire(slock);
+			return Source{contentPrefix, archive, metadataCache};
+		}
+
+		/*!
+		 * Constructs content and reads its metadata, from the archive of
+		 * <tt>source</tt> if it has one or from loose files otherwise, with
+		 * the hook selected by vlk::MapContent<T>. May run on any thread.
+		 */
+		static inline T* Construct(const Source& source, const std::string& path, MetadataPtr& meta)
+		{
+			T* t = nullptr;
+			ContentStatsRecorder::Timestamp start = stats.Start();
+
+			if (source.archive)
+			{
+				ContentArchive::Entry entry;
+				if (source.archive->Find(path, entry))
+				{
+					t = ConstructArchived(path, entry, source.archive, std::integral_constant<bool, MapContent<T>::value>());
+					stats.Record(ContentStatsRecorder::Construct, start);
+
+					if (t && entry.metadataSize > 0)
+					{
+						start = stats.Start();
+						meta = ContentMetadata::Parse(entry.metadata, entry.metadataSize);
+						stats.Record(ContentStatsRecorder::MetadataParse, start);
+					}
+				}
+			}
+			else
+			{
+				const std::string file = source.prefix + path;
+				t = Construct(file, std::integral_constant<bool, MapContent<T>::value>());
+				stats.Record(ContentStatsRecorder::Construct, start);
+
+				if (t)
+				{
+					start = stats.Start();
+					meta = ContentMetadata::Load(file, source.metadataCache);
+					stats.Record(ContentStatsRecorder::MetadataParse, start);
+				}
+			}
+
+			if (!t) stats.Add(ContentStatsRecorder::Failures);
+			return t;
+		}
+
+		//! Destroys content and releases the file mapping it was constructed from, if any.
+		static inline void Destroy(T* t)
+		{
+			// Taken out before destruction, since the key may not be used once t is freed.
+			// Released after it, since the content may still refer to the mapped file.
+			std::shared_ptr<const void> mapping;
+			if (MapContent<T>::value)
+			{
+				std::lock_guard<std::mutex> lock(mappingMutex);
+				auto it = mappings.find(t);
+				if (it != mappings.end())
+				{
+					mapping = std::move(it->second);
+					mappings.erase(it);
+				}
+			}
+
+			const ContentStatsRecorder::Timestamp start = stats.Start();
+			vlk::DestroyContent(t);
+			stats.Record(ContentStatsRecorder::Destroy, start);
+		}
+
+		//! Removes and returns the metadata of an alias. Must be called under a unique lock on mtx.
+		static inline MetadataPtr TakeMetadata(const std::string& alias)
+		{
+			MetadataPtr meta;
+			auto it = metadata.find(alias);
+			if (it != metadata.end())
+			{
+				meta = std::move(it->second);
+				metadata.erase(it);
+			}
+			return meta;
+		}
+
+		/*!
+		 * Destroys content and its metadata once they are unreachable,
+		 * immediately or, with deferred destruction enabled, on the
+		 * ContentReclaimer thread once no reader can be using them. Must be
+		 * called without holding mtx.
+		 */
+		static inline void Release(T* t, MetadataPtr meta)
+		{
+			if (!deferredDestruction.load(std::memory_order_acquire))
+			{
+				Destroy(t);
+				return;
+			}
+
+			const ContentMetadata* m = meta.release();
+			ContentReclaimer::Retire([t, m]()
+			{
+				Destroy(t);
+				delete m;
+			});
+		}
+
+		//! Content constructed on a loader thread, waiting to be published.
+		struct PendingLoad
+		{
+			std::string path;
+			std::string alias;
+			T* t;
+			MetadataPtr metadata;
+			std::exception_ptr error;
+			std::promise<ContentHandle<T>> promise;
+
+			//! Set for reloads of evicted content, which are dropped if the alias was loaded or unloaded meanwhile.
+			bool reload = false;
+		};
+
+		/*!
+		 * Stores content constructed from <tt>path</tt> under an alias,
+		 * replacing and destroying any content already loaded under it, and
+		 * sends the corresponding events. Unless <tt>enforceBudget</tt> is
+		 * false, then evicts other content to meet the memory budget. Must be
+		 * called from the main thread without holding mtx.
+		 */
+		static inline ContentHandle<T> Publish(T* t, const std::string& path, const std::string& alias, MetadataPtr meta, bool enforceBudget = true)
+		{
+			const Size bytes = ContentSize(*t);
+
+			std::lock_guard<std::recursive_mutex> wlock(writeMutex);
+			std::unique_lock<VLK_SHARED_MUTEX_TYPE> ulock(mtx, std::defer_lock);
+			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+			Acquire(slock);
+			ContentHandle<T> handle;
+
+			//erase existing entry
+			ContentHandle<T> existing;
+			T* old = nullptr;
+			MetadataPtr oldMeta;
+			if (content.Find(alias, existing))
+			{
+				old = slots.Get(existing.index, existing.generation);
+				SendEvent(UnloadEvent{old, alias});
+
+				slock.unlock();
+				Acquire(ulock);
+
+				//erase any existing metadata
+				oldMeta = TakeMetadata(alias);
+
+				//publish the new content before destroying the old one
+				handle = Allocate(t);
+				content.Insert(alias, handle);
+				slots.Free(existing.index);
+			}
+			else
+			{
+				slock.unlock();
+				Acquire(ulock);
+				//insert new content
+				handle = Allocate(t);
+				content.Insert(alias, handle);
+			}
+
+			if (meta) metadata[alias] = std::move(meta);
+			paths[alias] = path;
+
+			ulock.unlock();
+
+			//destroy the old content without blocking lookups
+			if (old) Release(old, std::move(oldMeta));
+			AddResident(alias, bytes);
+
+			stats.Add(ContentStatsRecorder::Loads);
+			if (old) stats.Add(ContentStatsRecorder::Reloads);
+
+			vlk::SendEvent(LoadEvent{t, alias});
+
+			if (enforceBudget) EnforceBudget(alias);
+
+			return handle;
+		}
+
+		//! Accounts content as resident. Must be called while holding writeMutex.
+		static inline void AddResident(const std::string& alias, Size bytes)
+		{
+			auto it = sizes.find(alias);
+			if (it == sizes.end())
+			{
+				sizes.insert(std::make_pair(alias, Resident{bytes, clock.size()}));
+				clock.push_back(alias);
+			}
+			else
+			{
+				memoryUsage.fetch_sub(it->second.bytes, std::memory_order_relaxed);
+				it->second.bytes = bytes;
+			}
+
+			memoryUsage.fetch_add(bytes, std::memory_order_relaxed);
+			if (evicted.Erase(alias)) evictedCount.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		//! Stops accounting content as resident. Must be called while holding writeMutex.
+		static inline void RemoveResident(const std::string& alias)
+		{
+			auto it = sizes.find(alias);
+			if (it == sizes.end()) return;
+
+			memoryUsage.fetch_sub(it->second.bytes, std::memory_order_relaxed);
+			const Size i = it->second.clockIndex;
+			sizes.erase(it);
+
+			//Move the last alias into the gap, so the hand keeps pointing at the same content
+			const Size last = clock.size() - 1;
+			if (i != last)
+			{
+				clock[i] = std::move(clock[last]);
+				sizes[clock[i]].clockIndex = i;
+			}
+
+			clock.pop_back();
+			if (clockHand == last) clockHand = i;
+			if (clockHand >= clock.size()) clockHand = 0;
+		}
+
+		/*!
+		 * Removes content from the registry, sends its UnloadEvent and
+		 * releases it. Evicted content keeps its path so it can be reloaded.
+		 * Unloading evicted content forgets it.
+		 */
+		static inline bool Remove(const std::string& alias, bool evict)
+		{
+			std::lock_guard<std::recursive_mutex> wlock(writeMutex);
+			std::unique_lock<VLK_SHARED_MUTEX_TYPE> ulock(mtx, std::defer_lock);
+			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+			Acquire(slock);
+			ContentHandle<T> handle;
+
+			//Check if content does not exist
+			if (!content.Find(alias, handle))
+			{
+				if (evict || !evicted.Erase(alias)) return false;
+
+				evictedCount.fetch_sub(1, std::memory_order_relaxed);
+				slock.unlock();
+				Acquire(ulock);
+				paths.erase(alias);
+				return true;
+			}
+
+			T* existing = slots.Get(handle.index, handle.generation);
+			vlk::SendEvent(UnloadEvent{existing, alias});
+			slock.unlock();
+			Acquire(ulock);
+
+			MetadataPtr meta = TakeMetadata(alias);
+			if (!evict) paths.erase(alias);
+			content.Erase(alias);
+			slots.Free(handle.index);
+			ulock.unlock();
+
+			RemoveResident(alias);
+			stats.Add(ContentStatsRecorder::Unloads);
+			if (evict)
+			{
+				evicted.Insert(alias, true);
+				evictedCount.fetch_add(1, std::memory_order_relaxed);
+				evictions.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			//destroy the content without blocking lookups
+			Release(existing, std::move(meta));
+
+			return true;
+		}
+
+		/*!
+		 * Evicts content the CLOCK hand finds unreferenced until the memory
+		 * budget is met, sparing <tt>keep</tt>. Each visit clears the
+		 * referenced bit set by GetContent, so content is only evicted if it
+		 * has not been retrieved since the hand last passed it.
+		 */
+		static inline void EnforceBudget(const std::string& keep)
+		{
+			const Size budget = memoryBudget.load(std::memory_order_relaxed);
+			if (budget == 0 || memoryUsage.load(std::memory_order_relaxed) <= budget) return;
+
+			std::lock_guard<std::recursive_mutex> wlock(writeMutex);
+
+			while (memoryUsage.load(std::memory_order_relaxed) > budget)
+			{
+				std::string victim;
+
+				//Two passes clear every referenced bit, so a victim is found unless only keep is resident
+				for (Size visited = 0; visited < 2 * clock.size() && victim.empty(); visited++)
+				{
+					if (clockHand >= clock.size()) clockHand = 0;
+					const std::string& alias = clock[clockHand++];
+					if (alias == keep) continue;
+
+					ContentHandle<T> handle;
+					if (content.Find(alias, handle) && !slots.ClearReferenced(handle.index)) victim = alias;
+				}
+
+				if (victim.empty()) return;
+				Remove(victim, true);
+			}
+		}
+
+		/*!
+		 * Reloads evicted content from the path it was loaded from if called
+		 * from the thread that set the memory budget, which is taken to be the
+		 * main thread. Other threads only queue the reload and get nullptr.
+		 * Never evicts or destroys other content, so pointers retrieved
+		 * earlier stay valid; the budget is met again by the next
+		 * PublishLoads().
+		 */
+		static inline const T* Reload(const std::string& alias)
+		{
+			std::lock_guard<std::recursive_mutex> wlock(writeMutex);
+
+			if (std::this_thread::get_id() != budgetThread)
+			{
+				QueueReload(alias);
+				return nullptr;
+			}
+
+			if (!IsEvicted(alias)) return nullptr;
+
+			std::string path;
+			{
+				std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+				Acquire(slock);
+				auto it = paths.find(alias);
+				if (it == paths.end()) return nullptr;
+				path = it->second;
+			}
+
+			misses.fetch_add(1, std::memory_order_relaxed);
+
+			MetadataPtr meta;
+			T* t = Construct(CurrentSource(), path, meta);
+			if (!t) return nullptr;
+
+			//A reload queued by another thread meanwhile is dropped by PublishLoads
+			stats.Add(ContentStatsRecorder::Reloads);
+			const ContentHandle<T> handle = Publish(t, path, alias, std::move(meta), false);
+			return slots.Get(handle.index, handle.generation);
+		}
+
+		/*!
+		 * Queues a reload of evicted content from the path it was loaded
+		 * from, unless one is already queued. It is published, with its
+		 * events and any evictions it causes, by the next PublishLoads().
+		 */
+		static inline void QueueReload(const std::string& alias)
+		{
+			std::lock_guard<std::recursive_mutex> wlock(writeMutex);
+			if (!IsEvicted(alias) || !reloading.insert(alias).second) return;
+
+			std::string path;
+			{
+				std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+				Acquire(slock);
+				auto it = paths.find(alias);
+				if (it != paths.end()) path = it->second;
+			}
+
+			misses.fetch_add(1, std::memory_order_relaxed);
+
+			std::shared_ptr<PendingLoad> load = std::make_shared<PendingLoad>();
+			load->path = path;
+			load->alias = alias;
+			load->t = nullptr;
+			load->reload = true;
+			Submit(load);
+		}
+
+		//! Returns true if content was evicted and has not been loaded or unloaded since. Does not lock.
+		static inline bool IsEvicted(const std::string& alias)
+		{
+			bool e;
+			return evicted.Find(alias, e);
+		}
+
+		//! Constructs the content of a load on the loader pool and queues it for PublishLoads().
+		static inline void Submit(std::shared_ptr<PendingLoad> load)
+		{
+			const Source source = CurrentSource();
+			pendingCount.fetch_add(1, std::memory_order_relaxed);
+
+			ContentLoader::Pool().Submit([load, source]()
+			{
+				try
+				{
+					load->t = Construct(source, load->path, load->metadata);
+				}
+				catch (...)
+				{
+					load->error = std::current_exception();
+					stats.Add(ContentStatsRecorder::Failures);
+				}
+
+				std::lock_guard<std::mutex> lock(completedMutex);
+				completed.push_back(load);
+			});
+		}
+
+		static std::string contentPrefix;
+
+		//! Loaded content. Read without locking, written under a unique lock on mtx.
+		static SlotArray<T> slots;
+
+		//! Handles of loaded content by alias. Read without locking, written under a unique lock on mtx.
+		static ReadMostlyMap<std::string, ContentHandle<T>> content;
+		static std::unordered_map<std::string, MetadataPtr> metadata;
+
+		//! Path, relative to the content prefix, each alias was loaded from.
+		static std::unordered_map<std::string, std::string> paths;
+		static VLK_SHARED_MUTEX_TYPE mtx;
+
+		//! Whether .metab caches are read and written for loose meta files.
+		static bool metadataCache;
+
+		//! Whether unloaded content is destroyed through the ContentReclaimer.
+		static std::atomic<bool> deferredDestruction;
+
+		/*!
+		 * Serializes changes to the registry, which are made on the main
+		 * thread, with reloads of evicted content being queued from any
+		 * thread.
+		 */
+		static std::recursive_mutex writeMutex;
+
+		//! Size and position in <tt>clock</tt> of a resident piece of content.
+		struct Resident
+		{
+			Size bytes;
+			Size clockIndex;
+		};
+
+		//! Every resident piece of content by alias. Guarded by writeMutex.
+		static std::unordered_map<std::string, Resident> sizes;
+		static std::atomic<Size> memoryUsage;
+		static std::atomic<Size> memoryBudget;
+
+		//! Aliases of resident content in the order the CLOCK hand visits them. Guarded by writeMutex.
+		static std::vector<std::string> clock;
+		static Size clockHand;
+
+		//! Aliases of evicted content, reloaded when next retrieved. Read without locking, written while holding writeMutex.
+		static ReadMostlyMap<std::string, bool> evicted;
+		static std::atomic<Size> evictedCount;
+
+		//! Aliases of evicted content with a reload queued. Guarded by writeMutex.
+		static std::unordered_set<std::string> reloading;
+
+		//! The thread that last set the memory budget, on which evicted content is reloaded synchronously. Guarded by writeMutex.
+		static std::thread::id budgetThread;
+
+		//! Striped, since every retrieval adds to it while a budget is set.
+		static StripedCounter hits;
+		static std::atomic<ULong> misses;
+		static std::atomic<ULong> evictions;
+
+		//! Statistics recorded if VLK_COMMON_CONTENT_STATS is defined.
+		static ContentStatsRecorder stats;
+
+		//! Archive content is loaded from, or nullptr to load loose files.
+		static std::shared_ptr<const ContentArchive> archive;
+
+		//! Mapped files or archives content constructed through vlk::MapContent refers to, by content.
+		static std::unordered_map<const T*, std::shared_ptr<const void>> mappings;
+		static std::mutex mappingMutex;
+
+		//! Asynchronous loads waiting for PublishLoads().
+		static std::vector<std::shared_ptr<PendingLoad>> completed;
+		static std::mutex completedMutex;
+		static std::atomic<Size> pendingCount;
+		public:
+
+		/*!
+		 * \brief An event sent whenever content of type T is loaded.
+		 *
+		 * \ts
+		 * May only be sent from the main thread.<br>
+		 * Resource locking must be handled externally.<br>
+		 * Shared access to the Content<T> class may be obtained.<br>
+		 */
+		struct LoadEvent
+		{
+			const T* const content;
+			const std::string alias;
+		};
+
+		/*!
+		 * \brief An event sent once per call to
+		 * <tt>vlk::Content<T>::LoadBatch(const std::vector<std::pair<std::string, std::string>>&)</tt>,
+		 * after the <tt>LoadEvent</tt>s of every piece of content it loaded.
+		 *
+		 * \ts
+		 * May only be sent from the main thread.<br>
+		 * Resource locking must be handled externally.<br>
+		 * Shared access to the Content<T> class may be obtained.<br>
+		 */
+		struct BatchLoadEvent
+		{
+			//! Content loaded by the batch and the aliases it was stored under, in manifest order.
+			const std::vector<std::pair<const T*, std::string>>& loaded;
+		};
+
+		/*!
+		 * \brief Result of
+		 * <tt>vlk::Content<T>::LoadBatch(const std::vector<std::pair<std::string, std::string>>&)</tt>.
+		 */
+		struct BatchResult
+		{
+			//! Number of entries whose content was loaded.
+			Size loaded;
+
+			//! Number of entries whose content could not be constructed.
+			Size failed;
+
+			//! Time spent constructing content and reading meta files on the loader pool.
+			std::chrono::steady_clock::duration constructTime;
+
+			//! Time spent storing content and sending events on the calling thread.
+			std::chrono::steady_clock::duration publishTime;
+		};
+
+		/*!
+		 * \brief An event sent whenever content of type T is unloaded.
+		 *
+		 * Sent while the content is still stored under its alias, before it
+		 * is removed or replaced, whether by unloading, eviction or any kind
+		 * of load.
+		 *
+		 * \ts
+		 * May only be sent from the main thread.<br>
+		 * Resource locking must be handled externally.<br>
+		 * Shared access to the Content<T> class may be obtained.<br>
+		 */
+		struct UnloadEvent
+		{
+			const T* const content;
+			const std::string alias;
+		};
+
+		/*!
+		 * \brief Changes the content prefix for this class.
+		 *
+		 * The content prefix is a string that is prepended to the <tt>path</tt>
+		 * argument of <tt>vlk::Content<T>::LoadContent(const std::string&,
+		 * const std::string&)</tt> when loading content from the disk. By
+		 * default, the content prefix is <tt>"content/"<tt>.
+		 *
+		 * \param prefix The new content prefix for this class, must end with a
+		 * trailing slash ('/') character.
+		 *
+		 * \throws std::invalid_argument if <tt>prefix</tt> does not end with a 
+		 * trailing slash ('/').
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 * Unique access to this class is required.<br>
+		 * This function may block the calling thread.<br>
+		 */
+		static inline void SetContentPrefix(const std::string& prefix)
+		{
+			std::unique_lock<VLK_SHARED_MUTEX_TYPE> ulock(mtx, std::defer_lock);
+			Acquire(ulock);
+			if ((*prefix.crbegin()) != '/')
+			{
+				throw std::invalid_argument("Prefix must end in a forward slash character.");
+				return;
+			}
+
+			contentPrefix = prefix;
+		}
+
+		/*!
+		 * \brief Gets the current content prefix of this class.
+		 *
+		 * The content prefix is a string that is prepended to the <tt>path</tt>
+		 * argument of <tt>vlk::Content<T>::LoadContent(const std::string&,
+		 * const std::string&)</tt> when loading content from the disk. By
+		 * default, the content prefix is <tt>"content/"<tt>.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 * Shared access to this class is required.<br>
+		 * This function may block the calling thread.<br>
+		 */
+		static inline std::string GetContentPrefix()
+		{
+			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+			Acquire(slock);
+			return contentPrefix;
+		}
+
+		/*!
+		 * \brief Sets the content archive content of this class is loaded from.
+		 *
+		 * While an archive is set, paths passed to the load functions are
+		 * looked up in the archive instead of on the disk, the content prefix
+		 * is ignored, and metadata is read from the archive. Content types
+		 * loaded from an archive must specialize vlk::MapContent<T>, and are
+		 * passed a view of the archive that stays valid until they are
+		 * destroyed. One archive may be shared by any number of content
+		 * types.
+		 *
+		 * Content that is already loaded is not affected.
+		 *
+		 * \param a The archive to load from, or nullptr to load loose files
+		 * again.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 * Unique access to this class is required.<br>
+		 * This function may block the calling thread.<br>
+		 *
+		 * \sa vlk::ContentArchive
+		 */
+		static inline void SetContentArchive(std::shared_ptr<const ContentArchive> a)
 		{
-			std::ifstream metaFile(path);
+			std::unique_lock<VLK_SHARED_MUTEX_TYPE> ulock(mtx, std::defer_lock);
+			Acquire(ulock);
+			archive = std::move(a);
+		}
 
-			if (!metaFile.good()) return;
+		/*!
+		 * \brief Gets the content archive content of this class is loaded
+		 * from, or nullptr if content is loaded from loose files.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 * Shared access to this class is required.<br>
+		 * This function may block the calling thread.<br>
+		 */
+		static inline std::shared_ptr<const ContentArchive> GetContentArchive()
+		{
+			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+			Acquire(slock);
+			return archive;
+		}
 
-			std::string str;
-			while (std::getline(metaFile, str))
-			{
-				//No data, on line
-				if (str.length() == 0) continue;
+		/*!
+		 * \brief Enables or disables binary metadata caches.
+		 *
+		 * While enabled, the first load of a <tt>.meta</tt> file writes a
+		 * pre-parsed copy next to it with the extension <tt>.metab</tt>.
+		 * Later loads map the <tt>.metab</tt> file instead of parsing the
+		 * text, as long as the <tt>.meta</tt> file has not changed since.
+		 * Disabled by default, since it writes to the content directory.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 * Unique access to this class is required.<br>
+		 * This function may block the calling thread.<br>
+		 */
+		static inline void SetMetadataCacheEnabled(bool enabled)
+		{
+			std::unique_lock<VLK_SHARED_MUTEX_TYPE> ulock(mtx, std::defer_lock);
+			Acquire(ulock);
+			metadataCache = enabled;
+		}
+
+		/*!
+		 * \brief Returns true if binary metadata caches are enabled.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 * Shared access to this class is required.<br>
+		 * This function may block the calling thread.<br>
+		 */
+		static inline bool IsMetadataCacheEnabled()
+		{
+			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+			Acquire(slock);
+			return metadataCache;
+		}
+
+		/*!
+		 * \brief Enables or disables deferred destruction of unloaded
+		 * content.
+		 *
+		 * While enabled, content that is unloaded or replaced is removed from
+		 * the registry immediately, but <tt>vlk::DestroyContent(T*)</tt> is
+		 * called later on the ContentReclaimer thread, once every EpochGuard
+		 * that was active when the content was removed has ended. A thread
+		 * may then keep using a pointer returned by
+		 * <tt>vlk::Content<T>::GetContent(const std::string&)</tt>, and the
+		 * views and metadata returned by the metadata accessors, for as long
+		 * as it stays inside the EpochGuard it obtained them in:
+		 *
+		 * \code
+		 * {
+		 * 	vlk::EpochGuard guard;
+		 * 	const Texture* t = vlk::Content<Texture>::GetContent("Player");
+		 * 	// t stays valid until guard is destroyed, even if "Player" is unloaded
+		 * }
+		 * \endcode
+		 *
+		 * Guards delay all reclamation through EpochDomain::Global(), so they
+		 * should be held briefly. <tt>vlk::DestroyContent(T*)</tt> must be
+		 * safe to call from the reclaimer thread. Disabled by default.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Does not lock.<br>
+		 *
+		 * \sa vlk::ContentReclaimer::Flush()
+		 */
+		static inline void SetDeferredDestructionEnabled(bool enabled)
+		{
+			deferredDestruction.store(enabled, std::memory_order_release);
+		}
+
+		/*!
+		 * \brief Returns true if deferred destruction of unloaded content is
+		 * enabled.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Does not lock.<br>
+		 */
+		static inline bool IsDeferredDestructionEnabled()
+		{
+			return deferredDestruction.load(std::memory_order_acquire);
+		}
+
+		/*!
+		 * \brief Counters describing how content is retrieved under a memory
+		 * budget.
+		 *
+		 * \sa vlk::Content<T>::GetCacheStats()
+		 */
+		struct CacheStats
+		{
+			//! Retrievals of resident content, counted while a budget is set.
+			ULong hits;
 
-				//Line is a comment
-				if (str[0] == '#') continue;
-				if (str[0] == '!') continue;
+			//! Retrievals of evicted content that reloaded it or queued a reload.
+			ULong misses;
 
-				Size split = str.find_first_of('=');
-				//No key or no value or no '=' character, continue ro next line
-				if (split == 0 | split == str.size() | split == std::string::npos) continue;
+			//! Content evicted to meet the budget.
+			ULong evictions;
+		};
 
-				metadata.insert(std::make_pair(
-					alias,
-					std::make_pair(
-						str.substr(0, split),
-						str.substr(split + 1))));
+		/*!
+		 * \brief Sets the memory budget for loaded content of type T.
+		 *
+		 * Loaded content is measured with <tt>vlk::ContentSize(const T&)</tt>.
+		 * While the total exceeds the budget, content that has not been
+		 * retrieved recently is evicted, using the CLOCK approximation of
+		 * least recently used: every retrieval sets a referenced bit, and
+		 * content whose bit has been clear for a full sweep of the clock hand
+		 * is evicted. Content just loaded is never evicted to make room for
+		 * itself.
+		 *
+		 * Evicted content sends an <tt>UnloadEvent</tt> and is destroyed like
+		 * unloaded content, but its alias is remembered. The thread calling
+		 * this function is taken to be the main thread: when it next calls
+		 * <tt>vlk::Content<T>::GetContent(const std::string&)</tt>, the
+		 * content is reloaded from the path it was loaded from, relative to
+		 * the current content prefix or archive, before the call returns.
+		 * Handles and metadata of evicted content are not valid until it has
+		 * been reloaded.
+		 *
+		 * Retrieving content never evicts other content, so content reloaded
+		 * by <tt>vlk::Content<T>::GetContent(const std::string&)</tt> may
+		 * exceed the budget until the next call to
+		 * <tt>vlk::Content<T>::PublishLoads()</tt>, a load, or this function.
+		 *
+		 * Other threads never load or destroy content. On them,
+		 * <tt>vlk::Content<T>::GetContent(const std::string&)</tt> returns
+		 * nullptr for evicted content and queues a reload, which the next
+		 * call to <tt>vlk::Content<T>::PublishLoads()</tt> publishes. Code
+		 * retrieving content by alias on other threads must therefore handle
+		 * nullptr for content that was loaded, unless no budget is set.
+		 *
+		 * Setting a lower budget evicts content immediately.
+		 *
+		 * \param bytes The budget in bytes, or 0 for no budget, which is the
+		 * default.
+		 *
+		 * \ts
+		 * Must only be called from the main thread.<br>
+		 * Resource locking is handled internally.<br>
+		 * Unique access to this class is required.<br>
+		 * This function may block the calling thread.<br>
+		 */
+		static inline void SetMemoryBudget(Size bytes)
+		{
+			{
+				std::lock_guard<std::recursive_mutex> wlock(writeMutex);
+				budgetThread = std::this_thread::get_id();
 			}
+
+			memoryBudget.store(bytes, std::memory_order_relaxed);
+			EnforceBudget(std::string());
 		}
 
-		static std::string contentPrefix;
-		static std::unordered_map<std::string, T*> content;
-		static std::unordered_multimap<std::string, std::pair<std::string, std::string>> metadata;
-		static VLK_SHARED_MUTEX_TYPE mtx;
-		public:
+		/*!
+		 * \brief Returns the memory budget for loaded content of type T, or 0
+		 * if there is none.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Does not lock.<br>
+		 */
+		static inline Size GetMemoryBudget()
+		{
+			return memoryBudget.load(std::memory_order_relaxed);
+		}
 
 		/*!
-		 * \brief An event sent whenever content of type T is loaded.
+		 * \brief Returns the total size of loaded content of type T, as
+		 * reported by <tt>vlk::ContentSize(const T&)</tt>.
 		 *
 		 * \ts
-		 * May only be sent from the main thread.<br>
-		 * Resource locking must be handled externally.<br>
-		 * Shared access to the Content<T> class may be obtained.<br>
+		 * May be called from any thread.<br>
+		 * Does not lock.<br>
 		 */
-		struct LoadEvent
+		static inline Size GetMemoryUsage()
 		{
-			const T* const content;
-			const std::string alias;
-		};
+			return memoryUsage.load(std::memory_order_relaxed);
+		}
 
 		/*!
-		 * \brief An event sent whenever content of type T is unloaded.
+		 * \brief Returns the hit, miss and eviction counters.
 		 *
 		 * \ts
-		 * May only be sent from the main thread.<br>
-		 * Resource locking must be handled externally.<br>
-		 * Shared access to the Content<T> class may be obtained.<br>
+		 * May be called from any thread.<br>
+		 * Does not lock.<br>
 		 */
-		struct UnloadEvent
+		static inline CacheStats GetCacheStats()
 		{
-			const T* const content;
-			const std::string alias;
-		};
+			return CacheStats
+			{
+				hits.Load(),
+				misses.load(std::memory_order_relaxed),
+				evictions.load(std::memory_order_relaxed)
+			};
+		}
 
 		/*!
-		 * \brief Changes the content prefix for this class.
+		 * \brief Resets the hit, miss and eviction counters to zero.
 		 *
-		 * The content prefix is a string that is prepended to the <tt>path</tt>
-		 * argument of <tt>vlk::Content<T>::LoadContent(const std::string&,
-		 * const std::string&)</tt> when loading content from the disk. By
-		 * default, the content prefix is <tt>"content/"<tt>.
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Does not lock.<br>
+		 */
+		static inline void ResetCacheStats()
+		{
+			hits.Reset();
+			misses.store(0, std::memory_order_relaxed);
+			evictions.store(0, std::memory_order_relaxed);
+		}
+
+		/*!
+		 * \brief Returns the statistics of content of type T.
 		 *
-		 * \param prefix The new content prefix for this class, must end with a
-		 * trailing slash ('/') character.
+		 * Counters and latency histograms are only recorded if
+		 * <tt>VLK_COMMON_CONTENT_STATS</tt> is defined, in every translation
+		 * unit, otherwise recording compiles to nothing and they are always
+		 * zero. The number of loaded pieces of content and their memory usage
+		 * are always reported.
 		 *
-		 * \throws std::invalid_argument if <tt>prefix</tt> does not end with a 
-		 * trailing slash ('/').
+		 * \code
+		 * std::cout << vlk::Content<Texture>::GetStats().ToJson("Texture") << std::endl;
+		 * \endcode
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 * Shared access to this class is required.<br>
+		 * This function may block the calling thread.<br>
+		 */
+		static inline ContentStats GetStats()
+		{
+			ContentStats out = ContentStats();
+			stats.Snapshot(out);
+
+			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+			Acquire(slock);
+			out.loaded = content.Count();
+			out.memoryUsage = memoryUsage.load(std::memory_order_relaxed);
+			return out;
+		}
+
+		/*!
+		 * \brief Resets the counters and latency histograms of content of
+		 * type T to zero.
 		 *
 		 * \ts
 		 * May be called from any thread.<br>
+		 * Does not lock.<br>
+		 */
+		static inline void ResetStats()
+		{
+			stats.Reset();
+		}
+
+		//TODO: Metadata guide
+		/*!
+		 * \brief Loads content from the disk.
+		 *
+		 * This function calls the template functions
+		 * <tt>vlk::ConstructContent(const std::string)</tt> and
+		 * <tt>vlk::DestroyContent(T*)</tt> internally. These functions must 
+		 * be specialized before they can be invoked. If vlk::MapContent<T> is
+		 * specialized, the file is mapped into memory and
+		 * <tt>vlk::ConstructContent(const std::string&, const ContentView&)</tt>
+		 * is called instead.
+		 *
+		 * This function will also load metadata from a corresponding meta file
+		 * if one is found. See the guide on metadata files for information on
+		 * how to write one.
+		 *
+		 * This function sends a <tt>LoadEvent</tt> if the
+		 * content is loaded successfully.
+		 *
+		 * \param path The path to the file to load the content from, relative
+		 * to the current content prefix.
+		 *
+		 * \param alias The alias to assign the content once loaded. This
+		 * string will be used as the key to retrieve the content with
+		 * <tt>vlk::Content<T>::GetContent(const std::string&)</tt>.
+		 *
+		 * \returns true if the content loads successfully, false otherwise.
+		 *
+		 * \ts
+		 * Must only be called from the main thread.<br>
 		 * Resource locking is handled internally.<br>
 		 * Unique access to this class is required.<br>
 		 * This function may block the calling thread.<br>
+		 *
+		 * \sa vlk::Content<T>::SetContentPrefix(const std::string&)
+		 * \sa vlk::Content<T>::GetContentPrefix()
+		 * \sa vlk::Content<T>::UnloadContent(const std::string&)
 		 */
-		static inline void SetContentPrefix(const std::string& prefix)
+		static inline bool LoadContent(const std::string& path, const std::string& alias)
 		{
-			std::unique_lock<VLK_SHARED_MUTEX_TYPE> ulock(mtx);
-			if ((*prefix.crbegin()) != '/')
+			//Construct without holding the lock, so lookups are not blocked by disk access
+			MetadataPtr meta;
+			T* t = Construct(CurrentSource(), path, meta);
+
+			//Content construction failed
+			if (!t) return false;
+
+			Publish(t, path, alias, std::move(meta));
+
+			return true;
+		}
+
+		/*!
+		 * \brief Loads content from the disk on a loader thread.
+		 *
+		 * <tt>vlk::ConstructContent(const std::string&)</tt> and reading the
+		 * meta file run on the pool returned by vlk::ContentLoader::Pool().
+		 * The constructed content is then queued until the main thread calls
+		 * <tt>vlk::Content<T>::PublishLoads()</tt>, which stores it under
+		 * <tt>alias</tt> and sends the <tt>LoadEvent</tt> in the same way as
+		 * <tt>vlk::Content<T>::LoadContent(const std::string&, const std::string&)</tt>.
+		 * Until then the content can not be retrieved.
+		 *
+		 * If several loads for the same alias are in flight, the one
+		 * published last replaces the others.
+		 *
+		 * \param path The path to the file to load the content from, relative
+		 * to the content prefix at the time of this call.
+		 *
+		 * \param alias The alias to assign the content once loaded.
+		 *
+		 * \returns A future that becomes ready when the load is published. It
+		 * holds a handle to the content, or a null handle if construction
+		 * failed. If <tt>vlk::ConstructContent(const std::string&)</tt>
+		 * threw, the future rethrows the exception. The main thread must
+		 * not wait on the future without calling
+		 * <tt>vlk::Content<T>::PublishLoads()</tt>.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 * <tt>vlk::ConstructContent(const std::string&)</tt> must be safe to
+		 * call concurrently for different paths.<br>
+		 *
+		 * \sa vlk::Content<T>::PublishLoads()
+		 * \sa vlk::ContentLoader::SetThreadCount(Size)
+		 */
+		static inline std::future<ContentHandle<T>> LoadContentAsync(const std::string& path, const std::string& alias)
+		{
+			std::shared_ptr<PendingLoad> load = std::make_shared<PendingLoad>();
+			load->path = path;
+			load->alias = alias;
+			load->t = nullptr;
+			std::future<ContentHandle<T>> future = load->promise.get_future();
+
+			Submit(load);
+			return future;
+		}
+
+		/*!
+		 * \brief Publishes every asynchronous load that has finished
+		 * constructing its content.
+		 *
+		 * Intended to be called once per frame. Loads are published in the
+		 * order they finished. This includes reloads of evicted content
+		 * queued by <tt>vlk::Content<T>::GetContent(const std::string&)</tt>
+		 * on threads other than the main thread, unless the content was loaded or unloaded meanwhile, along with the
+		 * evictions they cause. Then evicts content to meet the memory budget,
+		 * which content reloaded by
+		 * <tt>vlk::Content<T>::GetContent(const std::string&)</tt> on the main
+		 * thread may have exceeded.
+		 *
+		 * \returns The number of loads completed by this call, including
+		 * failed ones.
+		 *
+		 * \ts
+		 * Must only be called from the main thread.<br>
+		 * Resource locking is handled internally.<br>
+		 * Unique access to this class is required.<br>
+		 * This function may block the calling thread.<br>
+		 *
+		 * \sa vlk::Content<T>::LoadContentAsync(const std::string&, const std::string&)
+		 */
+		static inline Size PublishLoads()
+		{
+			std::vector<std::shared_ptr<PendingLoad>> ready;
+
+			{
+				std::lock_guard<std::mutex> lock(completedMutex);
+				ready.swap(completed);
+			}
+
+			for (std::shared_ptr<PendingLoad>& load : ready)
+			{
+				if (load->error)
+				{
+					if (load->t) Destroy(load->t);
+					load->promise.set_exception(load->error);
+				}
+				else if (!load->t)
+				{
+					load->promise.set_value(ContentHandle<T>());
+				}
+				else if (load->reload && !IsEvicted(load->alias))
+				{
+					// Loaded or unloaded since the reload was queued
+					Destroy(load->t);
+					load->promise.set_value(ContentHandle<T>());
+				}
+				else
+				{
+					if (load->reload) stats.Add(ContentStatsRecorder::Reloads);
+					load->promise.set_value(Publish(load->t, load->path, load->alias, std::move(load->metadata)));
+				}
+
+				if (load->reload)
+				{
+					std::lock_guard<std::recursive_mutex> wlock(writeMutex);
+					reloading.erase(load->alias);
+				}
+
+				pendingCount.fetch_sub(1, std::memory_order_relaxed);
+			}
+
+			EnforceBudget(std::string());
+
+			return ready.size();
+		}
+
+		/*!
+		 * \brief Loads many pieces of content at once.
+		 *
+		 * Every entry is constructed, and its meta file read, in parallel on
+		 * the pool returned by vlk::ContentLoader::Pool(), with the calling
+		 * thread helping. The results are then stored under a single unique
+		 * lock. Events are sent in the same order as by LoadContent(): an
+		 * <tt>UnloadEvent</tt> for every piece of content about to be
+		 * replaced, while it is still stored, then, once the results are
+		 * stored and the replaced content destroyed, a <tt>LoadEvent</tt> for
+		 * every loaded entry, then a single <tt>BatchLoadEvent</tt>.
+		 *
+		 * If several entries share an alias, only the last one is loaded.
+		 *
+		 * \param entries Pairs of a path, relative to the content prefix, and
+		 * the alias to store the content under.
+		 *
+		 * \returns The number of loaded and failed entries and the time spent
+		 * in each phase.
+		 *
+		 * \throws Rethrows the first exception thrown by
+		 * <tt>vlk::ConstructContent(const std::string&)</tt>, after destroying
+		 * everything constructed by the batch. Nothing is stored in that case.
+		 *
+		 * \ts
+		 * Must only be called from the main thread.<br>
+		 * Resource locking is handled internally.<br>
+		 * Unique access to this class is required.<br>
+		 * This function may block the calling thread.<br>
+		 * <tt>vlk::ConstructContent(const std::string&)</tt> must be safe to
+		 * call concurrently for different paths.<br>
+		 *
+		 * \sa vlk::Content<T>::LoadManifest(const std::string&)
+		 */
+		static inline BatchResult LoadBatch(const std::vector<std::pair<std::string, std::string>>& entries)
+		{
+			typedef std::chrono::steady_clock Clock;
+			const Clock::time_point start = Clock::now();
+			const Source source = CurrentSource();
+			const Size count = entries.size();
+
+			//Only the last entry for each alias is loaded
+			std::vector<bool> skipped(count, false);
+			{
+				std::unordered_map<std::string, Size> last;
+				for (Size i = 0; i < count; i++)
+				{
+					auto it = last.find(entries[i].second);
+					if (it != last.end())
+					{
+						skipped[it->second] = true;
+						it->second = i;
+					}
+					else
+					{
+						last.insert(std::make_pair(entries[i].second, i));
+					}
+				}
+			}
+
+			std::vector<T*> constructed(count, nullptr);
+			std::vector<MetadataPtr> meta(count);
+
+			try
+			{
+				ContentLoader::Pool().ParallelFor(count, 1, [&](Size begin, Size end)
+				{
+					for (Size i = begin; i < end; i++)
+					{
+						if (skipped[i]) continue;
+						constructed[i] = Construct(source, entries[i].first, meta[i]);
+					}
+				});
+			}
+			catch (...)
+			{
+				stats.Add(ContentStatsRecorder::Failures);
+				for (T* t : constructed) if (t) Destroy(t);
+				throw;
+			}
+
+			const Clock::time_point constructedAt = Clock::now();
+
+			BatchResult result;
+			result.loaded = 0;
+			result.failed = 0;
+
+			std::vector<std::pair<const T*, std::string>> loaded;
+			std::vector<std::pair<T*, std::string>> replaced;
+			std::vector<MetadataPtr> replacedMeta;
+
+			std::lock_guard<std::recursive_mutex> wlock(writeMutex);
+
+			{
+				std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+				Acquire(slock);
+
+				for (Size i = 0; i < count; i++)
+				{
+					if (skipped[i] || !constructed[i]) continue;
+
+					ContentHandle<T> existing;
+					if (content.Find(entries[i].second, existing))
+					{
+						vlk::SendEvent(UnloadEvent{slots.Get(existing.index, existing.generation), entries[i].second});
+					}
+				}
+			}
+
 			{
-				throw std::invalid_argument("Prefix must end in a forward slash character.");
-				return;
+				std::unique_lock<VLK_SHARED_MUTEX_TYPE> ulock(mtx, std::defer_lock);
+				Acquire(ulock);
+
+				for (Size i = 0; i < count; i++)
+				{
+					if (skipped[i]) continue;
+
+					if (!constructed[i])
+					{
+						result.failed++;
+						continue;
+					}
+
+					const std::string& alias = entries[i].second;
+					ContentHandle<T> existing;
+					if (content.Find(alias, existing))
+					{
+						replaced.push_back(std::make_pair(slots.Get(existing.index, existing.generation), alias));
+						replacedMeta.push_back(TakeMetadata(alias));
+						slots.Free(existing.index);
+					}
+
+					content.Insert(alias, Allocate(constructed[i]));
+
+					if (meta[i]) metadata[alias] = std::move(meta[i]);
+					paths[alias] = entries[i].first;
+					AddResident(alias, ContentSize(*constructed[i]));
+
+					loaded.push_back(std::make_pair(constructed[i], alias));
+					result.loaded++;
+				}
 			}
 
-			contentPrefix = prefix;
-		}
+			for (Size i = 0; i < replaced.size(); i++) Release(replaced[i].first, std::move(replacedMeta[i]));
 
-		/*!
-		 * \brief Gets the current content prefix of this class.
-		 *
-		 * The content prefix is a string that is prepended to the <tt>path</tt>
-		 * argument of <tt>vlk::Content<T>::LoadContent(const std::string&,
-		 * const std::string&)</tt> when loading content from the disk. By
-		 * default, the content prefix is <tt>"content/"<tt>.
-		 *
-		 * \ts
-		 * May be called from any thread.<br>
-		 * Resource locking is handled internally.<br>
-		 * Shared access to this class is required.<br>
-		 * This function may block the calling thread.<br>
-		 */
-		static inline std::string GetContentPrefix()
-		{
-			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx);
-			return contentPrefix;
+			stats.Add(ContentStatsRecorder::Loads, result.loaded);
+			stats.Add(ContentStatsRecorder::Reloads, replaced.size());
+
+			for (const std::pair<const T*, std::string>& l : loaded)
+			{
+				vlk::SendEvent(LoadEvent{l.first, l.second});
+			}
+
+			vlk::SendEvent(BatchLoadEvent{loaded});
+
+			EnforceBudget(std::string());
+
+			result.constructTime = constructedAt - start;
+			result.publishTime = Clock::now() - constructedAt;
+			return result;
 		}
 
-		//TODO: Metadata guide
 		/*!
-		 * \brief Loads content from the disk.
-		 *
-		 * This function calls the template functions
-		 * <tt>vlk::ConstructContent(const std::string)</tt> and
-		 * <tt>vlk::DestroyContent(T*)</tt> internally. These functions must 
-		 * be specialized before they can be invoked.
-		 *
-		 * This function will also load metadata from a corresponding meta file
-		 * if one is found. See the guide on metadata files for information on
-		 * how to write one.
+		 * \brief Loads every piece of content listed in a manifest file.
 		 *
-		 * This function sends a <tt>LoadEvent</tt> if the
-		 * content is loaded successfully.
+		 * Each line of the manifest has the form <tt>alias=path</tt>, with
+		 * <tt>path</tt> relative to the content prefix. Empty lines and lines
+		 * starting with <tt>'#'</tt> or <tt>'!'</tt> are ignored, as are lines
+		 * without an alias or a path.
 		 *
-		 * \param path The path to the file to load the content from, relative
-		 * to the current content prefix.
+		 * If a content archive is set, the manifest is read from the archive.
 		 *
-		 * \param alias The alias to assign the content once loaded. This
-		 * string will be used as the key to retrieve the content with
-		 * <tt>vlk::Content<T>::GetContent(const std::string&)</tt>.
+		 * \param file Path to the manifest, relative to the content prefix.
 		 *
-		 * \returns true if the content loads successfully, false otherwise.
+		 * \throws std::runtime_error if the manifest could not be opened.
 		 *
 		 * \ts
 		 * Must only be called from the main thread.<br>
@@ -212,53 +1771,48 @@ namespace vlk
 		 * Unique access to this class is required.<br>
 		 * This function may block the calling thread.<br>
 		 *
-		 * \sa vlk::Content<T>::SetContentPrefix(const std::string&)
-		 * \sa vlk::Content<T>::GetContentPrefix()
-		 * \sa vlk::Content<T>::UnloadContent(const std::string&)
+		 * \sa vlk::Content<T>::LoadBatch(const std::vector<std::pair<std::string, std::string>>&)
 		 */
-		static inline bool LoadContent(const std::string& path, const std::string& alias)
+		static inline BatchResult LoadManifest(const std::string& file)
 		{
-			std::unique_lock<VLK_SHARED_MUTEX_TYPE> ulock(mtx, std::defer_lock);
-			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx);
-
-			T* t = vlk::ConstructContent<T>(contentPrefix + path);
+			const Source source = CurrentSource();
+			std::vector<std::pair<std::string, std::string>> lines;
 
-			//Content construction failed
-			if (!t) return false;
-
-			//erase existing entry
-			auto it = content.find(alias);
-			if (it != content.end())
+			//Fields are alias=path, LoadBatch takes (path, alias)
+			auto add = [&](const char* alias, Size aliasSize, const char* path, Size pathSize)
 			{
-				SendEvent(UnloadEvent{it->second, alias});
+				lines.push_back(std::make_pair(std::string(path, pathSize), std::string(alias, aliasSize)));
+			};
 
-				slock.unlock();
-				ulock.lock();
-
-				//erase any existing metadata
-				metadata.erase(alias);
-
-				vlk::DestroyContent(it->second);
+			if (source.archive)
+			{
+				ContentArchive::Entry entry;
+				if (!source.archive->Find(file, entry)) throw std::runtime_error("Could not open content manifest " + file);
 
-				//insert new content
-				it->second = t;
+				ContentMetadata::ForEachField(reinterpret_cast<const char*>(entry.data), entry.size, add);
 			}
 			else
 			{
-				slock.unlock();
-				ulock.lock();
-				//insert new content
-				content.insert(std::make_pair(alias, t));
-			}
-
-			//Load metadata
-			LoadMetadata(contentPrefix + path + ".meta", alias);
+				MappedFile manifest(source.prefix + file);
+				if (!manifest.IsOpen()) throw std::runtime_error("Could not open content manifest " + file);
 
-			ulock.unlock();
+				ContentMetadata::ForEachField(reinterpret_cast<const char*>(manifest.Data()), manifest.Length(), add);
+			}
 
-			vlk::SendEvent(LoadEvent{t, alias});
+			return LoadBatch(lines);
+		}
 
-			return true;
+		/*!
+		 * \brief Returns the number of asynchronous loads that have not been
+		 * published yet.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Does not lock.<br>
+		 */
+		static inline Size PendingLoadCount()
+		{
+			return pendingCount.load(std::memory_order_relaxed);
 		}
 
 		/*!
@@ -266,7 +1820,9 @@ namespace vlk
 		 *
 		 * This function calls the template function
 		 * <tt>vlk::DestroyContent(T*)</tt> internally. This function must 
-		 * be specialized before it can be invoked.
+		 * be specialized before it can be invoked. The content is destroyed
+		 * after the registry lock has been released, or later on another
+		 * thread if deferred destruction is enabled.
 		 *
 		 * This function sends an <tt>UnloadEvent</tt> if the
 		 * content is unloaded successfully.
@@ -285,45 +1841,154 @@ namespace vlk
 		 */
 		static inline bool UnloadContent(const std::string& alias)
 		{
-			//Find content 
-			std::unique_lock<VLK_SHARED_MUTEX_TYPE> ulock(mtx, std::defer_lock);
-			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx);
-			auto it = content.find(alias);
+			return Remove(alias, false);
+		}
 
-			//Check if content does not exist
-			if (it == content.end()) return false;
+		/*!
+		 * \brief Retrieves loaded content.
+		 *
+		 * The lookup takes no lock and, unless a memory budget is set,
+		 * performs no atomic read-modify-write operation, so concurrent
+		 * lookups from many threads do not contend with each other or with
+		 * loads and unloads. While a budget is set, each hit is counted on
+		 * one of several counters picked per thread.
+		 *
+		 * If the content was evicted to meet the memory budget and this is
+		 * the main thread, which set the budget, it is reloaded from its path
+		 * before returning, sending its <tt>LoadEvent</tt>. Other content is
+		 * not evicted in turn until the next call to
+		 * <tt>vlk::Content<T>::PublishLoads()</tt>, so pointers retrieved
+		 * earlier stay valid. On any other thread, nullptr is returned and a
+		 * reload is queued on the pool returned by
+		 * vlk::ContentLoader::Pool(), which the next call to
+		 * <tt>vlk::Content<T>::PublishLoads()</tt> publishes, so retrieving
+		 * content never runs events on those threads. Whether a missing alias
+		 * was evicted is looked up without locking.
+		 *
+		 * \param alias The alias of the loaded content to get.
+		 *
+		 * \return A pointer to an instance of T or nullptr if no content with
+		 * the provided alias was found.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Does not lock, unless the content was evicted.<br>
+		 * On the main thread, this function may block while evicted content
+		 * is reloaded.<br>
+		 * The returned content is destroyed when it is unloaded, replaced or
+		 * evicted, which only happens on the main thread and never within a
+		 * retrieval, unless deferred destruction is enabled and the caller is
+		 * inside an EpochGuard.<br>
+		 *
+		 * \sa vlk::Content<T>::Resolve(const std::string&)
+		 * \sa vlk::Content<T>::SetMemoryBudget(Size)
+		 */
+		static inline const T* GetContent(const std::string& alias)
+		{
+			ContentHandle<T> handle;
+			if (content.Find(alias, handle)) return GetContent(handle);
 
-			vlk::SendEvent(UnloadEvent{it->second, alias});
-			slock.unlock();
-			ulock.lock();
+			stats.Add(ContentStatsRecorder::Lookups);
+			stats.Add(ContentStatsRecorder::Misses);
 
-			metadata.erase(alias);
-			vlk::DestroyContent<T>(it->second);
-			content.erase(alias);
+			//Content evicted to meet the memory budget is reloaded on demand
+			if (evictedCount.load(std::memory_order_relaxed) != 0 && IsEvicted(alias)) return Reload(alias);
+			return nullptr;
+		}
 
-			return true;
+		/*!
+		 * \brief Retrieves loaded content by handle.
+		 *
+		 * Unlike the alias overload, this does not hash the alias or search
+		 * for it.
+		 *
+		 * \param handle A handle obtained from
+		 * <tt>vlk::Content<T>::Resolve(const std::string&)</tt>.
+		 *
+		 * \return A pointer to an instance of T or nullptr if the handle is
+		 * null, or its content has been unloaded or replaced.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Does not lock.<br>
+		 */
+		static inline const T* GetContent(ContentHandle<T> handle)
+		{
+			const T* t = slots.Get(handle.index, handle.generation);
+
+			stats.Add(ContentStatsRecorder::Lookups);
+			if (t == nullptr) stats.Add(ContentStatsRecorder::Misses);
+
+			if (t != nullptr && memoryBudget.load(std::memory_order_relaxed) != 0)
+			{
+				slots.Touch(handle.index);
+				hits.Add();
+			}
+
+			return t;
 		}
 
 		/*!
-		 * \brief Retrieves loaded content.
+		 * \brief Gets a handle to loaded content.
 		 *
-		 * \param alias The alias of the loaded content to get.
+		 * The handle stays valid until the content is unloaded or new content
+		 * is loaded under the same alias.
 		 *
-		 * \return A pointer to an instance of T or nullptr if no content with
+		 * \param alias The alias of the loaded content.
+		 *
+		 * \return A handle to the content, or a null handle if no content with
 		 * the provided alias was found.
 		 *
 		 * \ts
-		 * Must only be called from the main thread.<br>
+		 * May be called from any thread.<br>
+		 * Does not lock.<br>
+		 */
+		static inline ContentHandle<T> Resolve(const std::string& alias)
+		{
+			ContentHandle<T> handle;
+			content.Find(alias, handle);
+			return handle;
+		}
+
+		/*!
+		 * \brief Gets the path loaded content was loaded from.
+		 *
+		 * \returns The path, relative to the content prefix at the time the
+		 * content was loaded, or an empty string if no content with the
+		 * provided alias was found.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
 		 * Resource locking is handled internally.<br>
-		 * Shared access to this class is required.<br>
-		 * This function may block the calling thread.<br>
 		 */
-		static inline const T* GetContent(const std::string& alias)
+		static inline std::string GetContentPath(const std::string& alias)
+		{
+			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+			Acquire(slock);
+			auto it = paths.find(alias);
+			return (it == paths.end()) ? std::string() : it->second;
+		}
+
+		/*!
+		 * \brief Gets the aliases of all content loaded from a path.
+		 *
+		 * \param path A path relative to the content prefix, as passed to
+		 * <tt>vlk::Content<T>::LoadContent(const std::string&, const std::string&)</tt>.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 */
+		static inline std::vector<std::string> GetAliasesLoadedFrom(const std::string& path)
 		{
-			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx);
-			auto it = content.find(alias);
-			if (it == content.end()) return nullptr;
-			return it->second;
+			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+			Acquire(slock);
+			std::vector<std::string> aliases;
+			for (const std::pair<const std::string, std::string>& p : paths)
+			{
+				if (p.second == path) aliases.push_back(p.first);
+			}
+			return aliases;
 		}
 
 		/*!
@@ -337,14 +2002,141 @@ namespace vlk
 		 */
 		static inline std::string GetMetadata(const std::string& alias, const std::string& key)
 		{
-			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx);
-			auto search = metadata.equal_range(alias);
-			for (auto it = search.first; it != search.second; it++)
-			{
-				if (it->second.first == key) return it->second.second;
-			}
+			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+			Acquire(slock);
+			auto it = metadata.find(alias);
+			if (it == metadata.end()) return "";
+
+			const char* value;
+			Size size;
+			if (!it->second->Find(key, value, size)) return "";
+
+			return std::string(value, size);
+		}
+
+		/*!
+		 * \brief Gets a metadata value associated with a piece of content,
+		 * without copying it.
+		 *
+		 * The view stays valid until the content is unloaded or new content
+		 * is loaded under the same alias.
+		 *
+		 * Every call hashes the alias and key and takes a shared lock on the
+		 * registry, and an alias or key passed as a string literal is copied
+		 * into a temporary <tt>std::string</tt>. Hot paths should look the
+		 * metadata up once with FindMetadata(const std::string&), and read it
+		 * through key ids from MetadataKeys::Intern().
+		 *
+		 * \returns The value of the metadata field, or an empty view if
+		 * either the content or the key were not found.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 */
+		static inline MetadataView GetMetadataView(const std::string& alias, const std::string& key)
+		{
+			MetadataView value;
+			GetTypedMetadata(alias, key, value, &ContentMetadata::GetView<std::string>);
+			return value;
+		}
+
+		/*!
+		 * \brief Gets a metadata value associated with a piece of content as
+		 * an integer.
+		 *
+		 * The value is converted when the metadata is loaded, but the lookup
+		 * costs as much as GetMetadataView(const std::string&, const std::string&).
+		 *
+		 * \returns The value of the metadata field, or <tt>defaultValue</tt>
+		 * if the content or the key were not found or the value is not an
+		 * integer.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Resource locking is handled internally.<br>
+		 */
+		static inline Long GetMetadataInt(const std::string& alias, const std::string& key, Long defaultValue = 0)
+		{
+			Long value = defaultValue;
+			GetTypedMetadata(alias, key, value, &ContentMetadata::GetInt<std::string>);
+			return value;
+		}
+
+		/*!
+		 * \brief Gets a metadata value associated with a piece of content as
+		 * a floating point number.
+		 *
+		 * \returns The value of the metadata field, or <tt>defaultValue</tt>
+		 * if the content or the key were not found or the value is not a
+		 * number.
+		 *
+		 * \sa GetMetadataInt(const std::string&, const std::string&, Long)
+		 */
+		static inline Float GetMetadataFloat(const std::string& alias, const std::string& key, Float defaultValue = 0)
+		{
+			Double value = defaultValue;
+			GetTypedMetadata(alias, key, value, &ContentMetadata::GetFloat<std::string>);
+			return static_cast<Float>(value);
+		}
+
+		/*!
+		 * \brief Gets a metadata value associated with a piece of content as
+		 * a boolean.
+		 *
+		 * <tt>true</tt>, <tt>yes</tt>, <tt>on</tt> and <tt>1</tt> are read as
+		 * true, and <tt>false</tt>, <tt>no</tt>, <tt>off</tt> and <tt>0</tt>
+		 * as false, ignoring case.
+		 *
+		 * \returns The value of the metadata field, or <tt>defaultValue</tt>
+		 * if the content or the key were not found or the value is not a
+		 * boolean.
+		 *
+		 * \sa GetMetadataInt(const std::string&, const std::string&, Long)
+		 */
+		static inline bool GetMetadataBool(const std::string& alias, const std::string& key, bool defaultValue = false)
+		{
+			bool value = defaultValue;
+			GetTypedMetadata(alias, key, value, &ContentMetadata::GetBool<std::string>);
+			return value;
+		}
+
+		/*!
+		 * \brief Gets all metadata associated with a piece of content.
+		 *
+		 * Hot paths can look the metadata up once, and read fields through
+		 * key ids obtained from MetadataKeys::Intern() without hashing any
+		 * string, locking or allocating:
+		 *
+		 * \code
+		 * static const vlk::UInt frameCount = vlk::MetadataKeys::Intern("frameCount");
+		 * const vlk::ContentMetadata* meta = vlk::Content<Sprite>::FindMetadata("Sprites/PlayerWalk");
+		 *
+		 * vlk::Long frames = 1;
+		 * if (meta) meta->GetInt(frameCount, frames);
+		 * \endcode
+		 *
+		 * \returns The metadata, or nullptr if the content was not found or
+		 * has no metadata. The metadata stays valid until the content is
+		 * unloaded or new content is loaded under the same alias.
+		 */
+		static inline const ContentMetadata* FindMetadata(const std::string& alias)
+		{
+			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+			Acquire(slock);
+			auto it = metadata.find(alias);
+			return (it == metadata.end()) ? nullptr : it->second.get();
+		}
 
-			return "";
+		private:
+		template <typename V>
+		static inline void GetTypedMetadata(const std::string& alias, const std::string& key, V& out,
+			bool (ContentMetadata::*get)(const std::string&, V&) const)
+		{
+			std::shared_lock<VLK_SHARED_MUTEX_TYPE> slock(mtx, std::defer_lock);
+			Acquire(slock);
+			auto it = metadata.find(alias);
+			if (it != metadata.end()) (it->second.get()->*get)(key, out);
 		}
 	};
 
@@ -352,13 +2144,91 @@ namespace vlk
 	std::string Content<T>::contentPrefix = "content/";
 
 	template <typename T>
-	std::unordered_map<std::string, T*> Content<T>::content;
+	SlotArray<T> Content<T>::slots;
+
+	template <typename T>
+	ReadMostlyMap<std::string, ContentHandle<T>> Content<T>::content;
+
+	template <typename T>
+	std::unordered_map<std::string, typename Content<T>::MetadataPtr> Content<T>::metadata;
+
+	template <typename T>
+	std::unordered_map<std::string, std::string> Content<T>::paths;
+
+	template <typename T>
+	bool Content<T>::metadataCache = false;
+
+	template <typename T>
+	std::atomic<bool> Content<T>::deferredDestruction(false);
+
+	template <typename T>
+	std::recursive_mutex Content<T>::writeMutex;
+
+	template <typename T>
+	std::unordered_map<std::string, typename Content<T>::Resident> Content<T>::sizes;
+
+	template <typename T>
+	std::atomic<Size> Content<T>::memoryUsage(0);
+
+	template <typename T>
+	std::atomic<Size> Content<T>::memoryBudget(0);
+
+	template <typename T>
+	std::vector<std::string> Content<T>::clock;
 
 	template <typename T>
-	std::unordered_multimap<std::string, std::pair<std::string, std::string>> Content<T>::metadata;
+	Size Content<T>::clockHand = 0;
+
+	template <typename T>
+	ReadMostlyMap<std::string, bool> Content<T>::evicted;
+
+	template <typename T>
+	std::atomic<Size> Content<T>::evictedCount(0);
+
+	template <typename T>
+	std::unordered_set<std::string> Content<T>::reloading;
+
+	template <typename T>
+	std::thread::id Content<T>::budgetThread;
+
+	template <typename T>
+	StripedCounter Content<T>::hits;
+
+	template <typename T>
+	std::atomic<ULong> Content<T>::misses(0);
+
+	template <typename T>
+	std::atomic<ULong> Content<T>::evictions(0);
+
+	template <typename T>
+	ContentStatsRecorder Content<T>::stats;
 
 	template <typename T>
 	VLK_SHARED_MUTEX_TYPE Content<T>::mtx;
+
+	template <typename T>
+	std::shared_ptr<const ContentArchive> Content<T>::archive;
+
+	template <typename T>
+	std::unordered_map<const T*, std::shared_ptr<const void>> Content<T>::mappings;
+
+	template <typename T>
+	std::mutex Content<T>::mappingMutex;
+
+	template <typename T>
+	std::vector<std::shared_ptr<typename Content<T>::PendingLoad>> Content<T>::completed;
+
+	template <typename T>
+	std::mutex Content<T>::completedMutex;
+
+	template <typename T>
+	std::atomic<Size> Content<T>::pendingCount(0);
+
+	template <typename T>
+	inline const T* ContentHandle<T>::Get() const
+	{
+		return Content<T>::GetContent(*this);
+	}
 }
 
 #endif
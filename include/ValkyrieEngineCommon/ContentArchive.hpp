@@ -0,0 +1,319 @@
+/*!
+ * \file ContentArchive.hpp
+ * \brief Packed content archives holding many content files and their metadata.
+ */
+
+#ifndef VLK_CONTENT_ARCHIVE_HPP
+#define VLK_CONTENT_ARCHIVE_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include "ValkyrieEngineCommon/MappedFile.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vlk
+{
+	/*!
+	 * \brief Binary layout of content archives, shared by ContentArchive and
+	 * ContentArchiveWriter.
+	 *
+	 * An archive consists of
+	 * - a Header,
+	 * - an index of <tt>entryCount</tt> IndexEntry records sorted by path,
+	 * - a string table holding every path and metadata block,
+	 * - the content of every file, each starting at a multiple of Alignment.
+	 *
+	 * All values are stored in the byte order of the machine that wrote the
+	 * archive, which is checked through Header::byteOrder.
+	 */
+	namespace ContentArchiveFormat
+	{
+		//! Alignment of the content of each file, relative to the start of the archive.
+		constexpr Size Alignment = 64;
+
+		constexpr char Magic[8] = { 'V', 'L', 'K', 'P', 'A', 'C', 'K', '\0' };
+		constexpr UInt Version = 1;
+		constexpr UInt ByteOrder = 0x01020304;
+
+		struct Header
+		{
+			char magic[8];
+			UInt version;
+			UInt byteOrder;
+			ULong entryCount;
+			ULong indexOffset;
+			ULong stringsOffset;
+			ULong stringsSize;
+		};
+
+		struct IndexEntry
+		{
+			//! Offset of the path, relative to the string table.
+			ULong pathOffset;
+			ULong pathSize;
+
+			//! Offset of the content, relative to the start of the archive.
+			ULong dataOffset;
+			ULong dataSize;
+
+			//! Offset of the metadata block, relative to the string table.
+			ULong metadataOffset;
+			ULong metadataSize;
+		};
+	}
+
+	/*!
+	 * \brief A read-only content archive.
+	 *
+	 * The whole archive is mapped into memory when it is opened. Opening
+	 * reads only the header, and looking up a file is a binary search of the
+	 * index, so the cost of opening an archive does not depend on the number
+	 * of files it holds.
+	 *
+	 * Archives are built with ContentArchiveWriter, or the
+	 * <tt>ValkyrieContentPacker</tt> tool.
+	 *
+	 * \ts
+	 * An opened archive is immutable, all members may be called from any
+	 * thread.<br>
+	 */
+	class ContentArchive
+	{
+		MappedFile file;
+		ContentArchiveFormat::Header header;
+
+		[[noreturn]] static inline void Corrupt()
+		{
+			throw std::runtime_error("Content archive is corrupt.");
+		}
+
+		//! Returns true if <tt>[offset, offset + size)</tt> lies within <tt>[0, limit)</tt>.
+		static inline bool InRange(ULong offset, ULong size, ULong limit)
+		{
+			return offset <= limit && size <= limit - offset;
+		}
+
+		inline ContentArchiveFormat::IndexEntry ReadEntry(Size i) const
+		{
+			ContentArchiveFormat::IndexEntry e;
+			std::memcpy(&e, file.Data() + header.indexOffset + i * sizeof(e), sizeof(e));
+
+			if (!InRange(e.pathOffset, e.pathSize, header.stringsSize) ||
+				!InRange(e.metadataOffset, e.metadataSize, header.stringsSize) ||
+				!InRange(e.dataOffset, e.dataSize, file.Length()))
+			{
+				Corrupt();
+			}
+
+			return e;
+		}
+
+		inline const char* Strings() const
+		{
+			return reinterpret_cast<const char*>(file.Data() + header.stringsOffset);
+		}
+
+		public:
+		//! A file stored in an archive. Remains valid while the archive exists.
+		struct Entry
+		{
+			//! The content of the file, or nullptr if it is empty.
+			const UByte* data;
+			Size size;
+
+			//! The text of the metadata file of the file, in the same format as a <tt>.meta</tt> file.
+			const char* metadata;
+			Size metadataSize;
+		};
+
+		/*!
+		 * \brief Opens and maps an archive.
+		 *
+		 * \param path Path to the archive file.
+		 *
+		 * \throws std::runtime_error if the file can not be opened or is not
+		 * a valid archive.
+		 */
+		inline explicit ContentArchive(const std::string& path) : file(path), header()
+		{
+			using namespace ContentArchiveFormat;
+
+			if (!file.IsOpen()) throw std::runtime_error("Could not open content archive " + path);
+			if (file.Length() < sizeof(Header)) Corrupt();
+
+			std::memcpy(&header, file.Data(), sizeof(Header));
+
+			if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) throw std::runtime_error(path + " is not a content archive.");
+			if (header.byteOrder != ByteOrder) throw std::runtime_error(path + " was written with a different byte order.");
+			if (header.version != Version) throw std::runtime_error(path + " has an unsupported content archive version.");
+
+			if (header.entryCount > file.Length() / sizeof(IndexEntry) ||
+				!InRange(header.indexOffset, header.entryCount * sizeof(IndexEntry), file.Length()) ||
+				!InRange(header.stringsOffset, header.stringsSize, file.Length()))
+			{
+				Corrupt();
+			}
+		}
+
+		ContentArchive(const ContentArchive&) = delete;
+		ContentArchive& operator=(const ContentArchive&) = delete;
+
+		//! Returns the number of files in the archive.
+		inline Size Count() const { return static_cast<Size>(header.entryCount); }
+
+		//! Returns the path of the file at position <tt>i</tt> of the index. Paths are sorted.
+		inline std::string Path(Size i) const
+		{
+			if (i >= Count()) throw std::out_of_range("Content archive entry index out of range.");
+			const ContentArchiveFormat::IndexEntry e = ReadEntry(i);
+			return std::string(Strings() + e.pathOffset, e.pathSize);
+		}
+
+		/*!
+		 * \brief Looks up a file.
+		 *
+		 * \param path Path of the file, relative to the directory the archive was built from, using '/' as separator.
+		 * \param out Set to the file if it is found.
+		 *
+		 * \return true if the file was found.
+		 *
+		 * \throws std::runtime_error if the index of the archive is corrupt.
+		 */
+		inline bool Find(const std::string& path, Entry& out) const
+		{
+			Size lo = 0;
+			Size hi = Count();
+
+			while (lo < hi)
+			{
+				const Size mid = lo + (hi - lo) / 2;
+				const ContentArchiveFormat::IndexEntry e = ReadEntry(mid);
+
+				const Size n = std::min<Size>(path.size(), e.pathSize);
+				int c = std::memcmp(Strings() + e.pathOffset, path.data(), n);
+				if (c == 0) c = (e.pathSize < path.size()) ? -1 : (e.pathSize > path.size()) ? 1 : 0;
+
+				if (c == 0)
+				{
+					out.data = (e.dataSize > 0) ? file.Data() + e.dataOffset : nullptr;
+					out.size = static_cast<Size>(e.dataSize);
+					out.metadata = Strings() + e.metadataOffset;
+					out.metadataSize = static_cast<Size>(e.metadataSize);
+					return true;
+				}
+
+				if (c < 0) lo = mid + 1;
+				else hi = mid;
+			}
+
+			return false;
+		}
+	};
+
+	/*!
+	 * \brief Builds content archives.
+	 *
+	 * \sa vlk::ContentArchive
+	 */
+	class ContentArchiveWriter
+	{
+		struct Pending
+		{
+			std::string path;
+			std::vector<UByte> data;
+			std::string metadata;
+		};
+
+		std::vector<Pending> entries;
+
+		public:
+		/*!
+		 * \brief Adds a file to the archive.
+		 *
+		 * \param path Path used to look up the file.
+		 * \param data Content of the file.
+		 * \param metadata Text of the metadata file of the file, may be empty.
+		 */
+		inline void Add(const std::string& path, std::vector<UByte> data, std::string metadata)
+		{
+			entries.push_back(Pending{path, std::move(data), std::move(metadata)});
+		}
+
+		//! Returns the number of files added so far.
+		inline Size Count() const { return entries.size(); }
+
+		/*!
+		 * \brief Writes the archive to a file.
+		 *
+		 * \throws std::invalid_argument if two files were added with the same path.
+		 * \throws std::runtime_error if the file could not be written.
+		 */
+		inline void Write(const std::string& path)
+		{
+			using namespace ContentArchiveFormat;
+
+			std::sort(entries.begin(), entries.end(), [](const Pending& a, const Pending& b) { return a.path < b.path; });
+			for (Size i = 1; i < entries.size(); i++)
+			{
+				if (entries[i].path == entries[i - 1].path) throw std::invalid_argument("Duplicate content archive path " + entries[i].path);
+			}
+
+			std::vector<IndexEntry> index(entries.size());
+			std::string strings;
+
+			for (Size i = 0; i < entries.size(); i++)
+			{
+				index[i].pathOffset = strings.size();
+				index[i].pathSize = entries[i].path.size();
+				strings += entries[i].path;
+
+				index[i].metadataOffset = strings.size();
+				index[i].metadataSize = entries[i].metadata.size();
+				strings += entries[i].metadata;
+			}
+
+			Header header;
+			std::memcpy(header.magic, Magic, sizeof(Magic));
+			header.version = Version;
+			header.byteOrder = ByteOrder;
+			header.entryCount = entries.size();
+			header.indexOffset = sizeof(Header);
+			header.stringsOffset = header.indexOffset + index.size() * sizeof(IndexEntry);
+			header.stringsSize = strings.size();
+
+			ULong offset = header.stringsOffset + header.stringsSize;
+			for (Size i = 0; i < entries.size(); i++)
+			{
+				offset = (offset + Alignment - 1) / Alignment * Alignment;
+				index[i].dataOffset = offset;
+				index[i].dataSize = entries[i].data.size();
+				offset += index[i].dataSize;
+			}
+
+			std::ofstream out(path, std::ios::binary | std::ios::trunc);
+			if (!out.good()) throw std::runtime_error("Could not open " + path + " for writing.");
+
+			out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+			out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(IndexEntry));
+			out.write(strings.data(), strings.size());
+
+			ULong written = header.stringsOffset + header.stringsSize;
+			for (Size i = 0; i < entries.size(); i++)
+			{
+				static const char padding[Alignment] = { };
+				out.write(padding, index[i].dataOffset - written);
+				out.write(reinterpret_cast<const char*>(entries[i].data.data()), entries[i].data.size());
+				written = index[i].dataOffset + index[i].dataSize;
+			}
+
+			if (!out.good()) throw std::runtime_error("Could not write content archive " + path);
+		}
+	};
+}
+
+#endif
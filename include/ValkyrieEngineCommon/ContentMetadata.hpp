@@ -0,0 +1,643 @@
+/*!
+ * \file ContentMetadata.hpp
+ * \brief Compact storage for the metadata of content.
+ */
+
+#ifndef VLK_CONTENT_METADATA_HPP
+#define VLK_CONTENT_METADATA_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include "ValkyrieEngineCommon/MappedFile.hpp"
+#include "ValkyrieEngineCommon/ReadMostlyMap.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace vlk
+{
+	/*!
+	 * \brief Process-wide table of interned metadata keys.
+	 *
+	 * Every distinct key is assigned a small integer id once, so metadata
+	 * stores and compares ids instead of strings.
+	 *
+	 * \ts
+	 * May be called from any thread.<br>
+	 * Find() does not lock, Intern() locks only when adding a new key.<br>
+	 */
+	class MetadataKeys
+	{
+		struct Table
+		{
+			ReadMostlyMap<std::string, UInt> ids;
+			std::deque<std::string> names;
+			std::mutex mutex;
+		};
+
+		static inline Table& Instance()
+		{
+			static Table table;
+			return table;
+		}
+
+		public:
+		/*!
+		 * \brief Looks up the id of a key without adding it.
+		 *
+		 * \return true if the key has been interned.
+		 */
+		static inline bool Find(const std::string& key, UInt& id)
+		{
+			return Instance().ids.Find(key, id);
+		}
+
+		//! Returns the id of a key, assigning a new one if the key has not been interned yet.
+		static inline UInt Intern(const std::string& key)
+		{
+			Table& t = Instance();
+			UInt id;
+			if (t.ids.Find(key, id)) return id;
+
+			std::lock_guard<std::mutex> lock(t.mutex);
+			if (t.ids.Find(key, id)) return id;
+
+			id = static_cast<UInt>(t.names.size());
+			t.names.push_back(key);
+			t.ids.Insert(key, id);
+			return id;
+		}
+
+		//! Returns the key an id was assigned to.
+		static inline std::string Name(UInt id)
+		{
+			Table& t = Instance();
+			std::lock_guard<std::mutex> lock(t.mutex);
+			if (id >= t.names.size()) throw std::out_of_range("Unknown metadata key id.");
+			return t.names[id];
+		}
+	};
+
+	/*!
+	 * \brief A non-owning view of a metadata value.
+	 *
+	 * Valid as long as the metadata it was obtained from. The value is not
+	 * null-terminated.
+	 */
+	struct MetadataView
+	{
+		const char* data;
+		Size size;
+
+		//! Constructs a view of an empty value.
+		inline VLK_CXX14_CONSTEXPR MetadataView() : data(""), size(0) { }
+		inline VLK_CXX14_CONSTEXPR MetadataView(const char* d, Size s) : data(d), size(s) { }
+
+		inline bool Empty() const { return size == 0; }
+
+		//! Copies the value into a string.
+		inline std::string ToString() const { return std::string(data, size); }
+
+		inline bool operator==(const MetadataView& other) const
+		{
+			return size == other.size && std::memcmp(data, other.data, size) == 0;
+		}
+
+		inline bool operator!=(const MetadataView& other) const { return !(*this == other); }
+
+		inline bool operator==(const char* other) const { return *this == MetadataView(other, std::strlen(other)); }
+		inline bool operator!=(const char* other) const { return !(*this == other); }
+
+#if __cplusplus >= 201703L
+		inline operator std::string_view() const { return std::string_view(data, size); }
+#endif
+	};
+
+	/*!
+	 * \brief The metadata fields of a single piece of content.
+	 *
+	 * Keys are interned through MetadataKeys and stored with the offset and
+	 * size of their value in a flat array sorted by key id, so a lookup is a
+	 * binary search over a few integers. Values are stored back to back,
+	 * either in a single string owned by the metadata or in a memory-mapped
+	 * <tt>.metab</tt> cache file.
+	 *
+	 * Values that read as integers, floating point numbers or booleans are
+	 * converted once when the metadata is loaded, so the typed accessors
+	 * neither parse nor allocate. Spaces, tabs and carriage returns around a
+	 * value are ignored by these conversions.
+	 *
+	 * If a key appears more than once, its first value is kept.
+	 *
+	 * \ts
+	 * Immutable once constructed, all const members may be called from any thread.<br>
+	 */
+	class ContentMetadata
+	{
+		struct Field
+		{
+			UInt key;
+			UInt offset;
+			UInt size;
+
+			//! Combination of the Has* flags, for each conversion of the value that succeeded.
+			UInt types;
+			bool boolValue;
+			Long intValue;
+			Double floatValue;
+		};
+
+		static VLK_CXX14_CONSTEXPR UInt HasInt = 1;
+		static VLK_CXX14_CONSTEXPR UInt HasFloat = 2;
+		static VLK_CXX14_CONSTEXPR UInt HasBool = 4;
+
+		struct BinaryHeader
+		{
+			char magic[8];
+			UInt version;
+			UInt byteOrder;
+			ULong count;
+			ULong stringsSize;
+
+			//! Modification time, in nanoseconds, and size of the meta file the cache was built from.
+			Long sourceTime;
+			ULong sourceSize;
+		};
+
+		struct BinaryField
+		{
+			UInt keyOffset;
+			UInt keySize;
+			UInt valueOffset;
+			UInt valueSize;
+		};
+
+		static VLK_CXX14_CONSTEXPR UInt BinaryVersion = 2;
+		static VLK_CXX14_CONSTEXPR UInt BinaryByteOrder = 0x01020304;
+
+		static inline const char* BinaryMagic() { return "VLKMETA"; }
+
+		std::vector<Field> fields;
+		std::string arena;
+
+		//! Mapped cache file the values are stored in, or nullptr if they are stored in arena.
+		std::shared_ptr<const MappedFile> mapped;
+		const char* mappedValues;
+
+		inline const char* Values() const
+		{
+			return mapped ? mappedValues : arena.data();
+		}
+
+		//! Returns true if <tt>[begin, end)</tt> equals the lower case <tt>word</tt>, ignoring ASCII case.
+		static inline bool EqualsIgnoreCase(const char* begin, const char* end, const char* word)
+		{
+			for (; begin != end; begin++, word++)
+			{
+				char c = *begin;
+				if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+				if (*word == '\0' || c != *word) return false;
+			}
+
+			return *word == '\0';
+		}
+
+		//! Converts the value of a field to every type it can be read as.
+		inline void Convert(Field& f) const
+		{
+			const char* begin = Values() + f.offset;
+			const char* end = begin + f.size;
+			while (begin != end && (*begin == ' ' || *begin == '\t' || *begin == '\r')) begin++;
+			while (end != begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) end--;
+
+			f.types = 0;
+			f.boolValue = false;
+			f.intValue = 0;
+			f.floatValue = 0;
+
+			const Size length = static_cast<Size>(end - begin);
+			if (length == 0) return;
+
+			if (EqualsIgnoreCase(begin, end, "true") || EqualsIgnoreCase(begin, end, "yes") || EqualsIgnoreCase(begin, end, "on"))
+			{
+				f.types |= HasBool;
+				f.boolValue = true;
+			}
+			else if (EqualsIgnoreCase(begin, end, "false") || EqualsIgnoreCase(begin, end, "no") || EqualsIgnoreCase(begin, end, "off"))
+			{
+				f.types |= HasBool;
+			}
+
+			// strtoll and strtod need a terminated string, no number is this long
+			char buffer[64];
+			if (length >= sizeof(buffer)) return;
+			std::memcpy(buffer, begin, length);
+			buffer[length] = '\0';
+
+			char* parsed;
+			errno = 0;
+			const long long i = std::strtoll(buffer, &parsed, 10);
+			if (parsed == buffer + length && errno == 0)
+			{
+				f.types |= HasInt;
+				f.intValue = static_cast<Long>(i);
+
+				if (i == 0 || i == 1)
+				{
+					f.types |= HasBool;
+					f.boolValue = (i == 1);
+				}
+			}
+
+			errno = 0;
+			const double d = std::strtod(buffer, &parsed);
+			if (parsed == buffer + length && errno == 0)
+			{
+				f.types |= HasFloat;
+				f.floatValue = static_cast<Double>(d);
+			}
+		}
+
+		//! Sorts fields by key, keeping the first of any duplicate keys, and converts their values.
+		inline void Finish()
+		{
+			std::stable_sort(fields.begin(), fields.end(), [](const Field& a, const Field& b) { return a.key < b.key; });
+			fields.erase(
+				std::unique(fields.begin(), fields.end(), [](const Field& a, const Field& b) { return a.key == b.key; }),
+				fields.end());
+
+			for (Field& f : fields) Convert(f);
+		}
+
+		inline const Field* Lookup(UInt key) const
+		{
+			auto it = std::lower_bound(fields.begin(), fields.end(), key, [](const Field& f, UInt k) { return f.key < k; });
+			return (it == fields.end() || it->key != key) ? nullptr : &*it;
+		}
+
+		inline const Field* Lookup(const std::string& key) const
+		{
+			UInt id;
+			return MetadataKeys::Find(key, id) ? Lookup(id) : nullptr;
+		}
+
+		inline ContentMetadata() : fields(), arena(), mapped(), mappedValues(nullptr) { }
+
+		/*!
+		 * Maps a cache file written by WriteCache(). Values are read from the
+		 * mapping without being copied. Returns nullptr if the file does not
+		 * exist, is not a valid cache file, or was built from a different
+		 * version of the meta file.
+		 */
+		static inline std::unique_ptr<ContentMetadata> LoadCache(const std::string& path, Long sourceTime, ULong sourceSize)
+		{
+			std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(path);
+			if (!file->IsOpen() || file->Length() < sizeof(BinaryHeader)) return nullptr;
+
+			BinaryHeader header;
+			std::memcpy(&header, file->Data(), sizeof(header));
+
+			if (std::memcmp(header.magic, BinaryMagic(), sizeof(header.magic)) != 0 ||
+				header.version != BinaryVersion ||
+				header.byteOrder != BinaryByteOrder ||
+				header.sourceTime != sourceTime ||
+				header.sourceSize != sourceSize ||
+				header.count > (file->Length() - sizeof(BinaryHeader)) / sizeof(BinaryField) ||
+				header.stringsSize != file->Length() - sizeof(BinaryHeader) - header.count * sizeof(BinaryField))
+			{
+				return nullptr;
+			}
+
+			const UByte* table = file->Data() + sizeof(BinaryHeader);
+			const char* strings = reinterpret_cast<const char*>(table + header.count * sizeof(BinaryField));
+
+			std::unique_ptr<ContentMetadata> m(new ContentMetadata());
+			m->fields.reserve(static_cast<Size>(header.count));
+
+			for (Size i = 0; i < header.count; i++)
+			{
+				BinaryField b;
+				std::memcpy(&b, table + i * sizeof(BinaryField), sizeof(b));
+
+				if (ULong(b.keyOffset) + b.keySize > header.stringsSize ||
+					ULong(b.valueOffset) + b.valueSize > header.stringsSize)
+				{
+					return nullptr;
+				}
+
+				m->fields.push_back(Field{
+					MetadataKeys::Intern(std::string(strings + b.keyOffset, b.keySize)),
+					b.valueOffset,
+					b.valueSize,
+					0, false, 0, 0});
+			}
+
+			m->mappedValues = strings;
+			m->mapped = std::move(file);
+			m->Finish();
+			return m;
+		}
+
+		//! Writes the metadata to a cache file. Returns true if the file was written.
+		inline bool WriteCache(const std::string& path, Long sourceTime, ULong sourceSize) const
+		{
+			std::vector<BinaryField> table;
+			std::string strings;
+
+			for (const Field& f : fields)
+			{
+				const std::string key = MetadataKeys::Name(f.key);
+				BinaryField b;
+				b.keyOffset = static_cast<UInt>(strings.size());
+				b.keySize = static_cast<UInt>(key.size());
+				strings += key;
+				b.valueOffset = static_cast<UInt>(strings.size());
+				b.valueSize = f.size;
+				strings.append(Values() + f.offset, f.size);
+				table.push_back(b);
+			}
+
+			BinaryHeader header;
+			std::memcpy(header.magic, BinaryMagic(), sizeof(header.magic));
+			header.version = BinaryVersion;
+			header.byteOrder = BinaryByteOrder;
+			header.count = table.size();
+			header.stringsSize = strings.size();
+			header.sourceTime = sourceTime;
+			header.sourceSize = sourceSize;
+
+			// Written under a temporary name and renamed, so a cache mapped by another load is never truncated
+			const std::string temp = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+			{
+				std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+				if (!out.good()) return false;
+
+				out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(BinaryField));
+				out.write(strings.data(), strings.size());
+
+				if (!out.good())
+				{
+					out.close();
+					std::remove(temp.c_str());
+					return false;
+				}
+			}
+
+#ifdef _WIN32
+			std::remove(path.c_str());
+#endif
+			if (std::rename(temp.c_str(), path.c_str()) != 0)
+			{
+				std::remove(temp.c_str());
+				return false;
+			}
+
+			return true;
+		}
+
+		public:
+		ContentMetadata(const ContentMetadata&) = delete;
+		ContentMetadata& operator=(const ContentMetadata&) = delete;
+
+		/*!
+		 * \brief Calls <tt>f(key, keySize, value, valueSize)</tt> for every
+		 * field of text in the <tt>.meta</tt> format.
+		 *
+		 * Each line holds a key and a value separated by the first '='
+		 * character. Empty lines, lines starting with '#' or '!', and lines
+		 * without a key or '=' are skipped.
+		 */
+		template <typename F>
+		static inline void ForEachField(const char* text, Size size, F f)
+		{
+			const char* end = text + size;
+			while (text < end)
+			{
+				const char* lineEnd = std::find(text, end, '\n');
+				const char* split = std::find(text, lineEnd, '=');
+
+				//Empty lines, comments, and lines without a key or '=' character
+				if (text != lineEnd && *text != '#' && *text != '!' && split != text && split != lineEnd)
+				{
+					f(text, static_cast<Size>(split - text), split + 1, static_cast<Size>(lineEnd - split - 1));
+				}
+
+				text = (lineEnd == end) ? end : lineEnd + 1;
+			}
+		}
+
+		/*!
+		 * \brief Parses metadata from text in the <tt>.meta</tt> format.
+		 *
+		 * \sa ForEachField(const char*, Size, F)
+		 */
+		static inline std::unique_ptr<ContentMetadata> Parse(const char* text, Size size)
+		{
+			std::unique_ptr<ContentMetadata> m(new ContentMetadata());
+			m->arena.reserve(size);
+
+			ForEachField(text, size, [&](const char* key, Size keySize, const char* value, Size valueSize)
+			{
+				m->fields.push_back(Field{
+					MetadataKeys::Intern(std::string(key, keySize)),
+					static_cast<UInt>(m->arena.size()),
+					static_cast<UInt>(valueSize),
+					0, false, 0, 0});
+				m->arena.append(value, valueSize);
+			});
+
+			m->Finish();
+			return m;
+		}
+
+		/*!
+		 * \brief Loads the metadata of a content file.
+		 *
+		 * Reads <tt>file.meta</tt>. If <tt>useCache</tt> is true and
+		 * <tt>file.metab</tt> was built from the current version of
+		 * <tt>file.meta</tt>, judged by its modification time and size, the
+		 * cache is mapped instead of parsing the text. Otherwise the text is
+		 * parsed and, if <tt>useCache</tt> is true, the cache is written for
+		 * the next load. Failing to write the cache is not an error.
+		 *
+		 * \return The metadata, or nullptr if the content file has no meta file.
+		 */
+		static inline std::unique_ptr<ContentMetadata> Load(const std::string& file, bool useCache)
+		{
+			const std::string metaPath = file + ".meta";
+			const std::string cachePath = file + ".metab";
+
+			Long metaTime;
+			ULong metaSize;
+			if (!FileStamp(metaPath, metaTime, metaSize)) return nullptr;
+
+			if (useCache)
+			{
+				std::unique_ptr<ContentMetadata> cached = LoadCache(cachePath, metaTime, metaSize);
+				if (cached) return cached;
+			}
+
+			// Meta files are small, reading them is cheaper than mapping them
+			std::ifstream in(metaPath, std::ios::binary);
+			if (!in.good()) return nullptr;
+
+			std::string text(static_cast<Size>(metaSize), '\0');
+			in.read(&text[0], text.size());
+			text.resize(static_cast<Size>(in.gcount()));
+
+			std::unique_ptr<ContentMetadata> m = Parse(text.data(), text.size());
+			if (useCache) m->WriteCache(cachePath, metaTime, metaSize);
+			return m;
+		}
+
+		/*!
+		 * Gets the modification time and size of a file. Returns false if the
+		 * file does not exist.
+		 *
+		 * The time has the finest resolution the platform reports, in
+		 * nanoseconds, so a meta file rewritten within the same second with
+		 * the same length is still told apart.
+		 */
+		static inline bool FileStamp(const std::string& path, Long& time, ULong& size)
+		{
+#ifdef _WIN32
+			WIN32_FILE_ATTRIBUTE_DATA data;
+			if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data)) return false;
+
+			// 100 nanosecond intervals
+			time = static_cast<Long>((static_cast<ULong>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime) * 100;
+			size = (static_cast<ULong>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+#else
+			struct stat st;
+			if (stat(path.c_str(), &st) != 0) return false;
+
+	#ifdef __APPLE__
+			const Long nanoseconds = static_cast<Long>(st.st_mtimespec.tv_nsec);
+	#else
+			const Long nanoseconds = static_cast<Long>(st.st_mtim.tv_nsec);
+	#endif
+			time = static_cast<Long>(st.st_mtime) * 1000000000 + nanoseconds;
+			size = static_cast<ULong>(st.st_size);
+#endif
+			return true;
+		}
+
+		//! Returns the number of distinct keys.
+		inline Size Count() const { return fields.size(); }
+
+		/*!
+		 * \brief Looks up the value of an interned key.
+		 *
+		 * \param key Id of the key, from MetadataKeys.
+		 * \param value Set to the first character of the value. The value is not null-terminated.
+		 * \param size Set to the length of the value.
+		 *
+		 * \return true if the key was found.
+		 */
+		inline bool Find(UInt key, const char*& value, Size& size) const
+		{
+			const Field* f = Lookup(key);
+			if (f == nullptr) return false;
+
+			value = Values() + f->offset;
+			size = f->size;
+			return true;
+		}
+
+		//! Looks up the value of a key. \sa Find(UInt, const char*&, Size&) const
+		inline bool Find(const std::string& key, const char*& value, Size& size) const
+		{
+			UInt id;
+			return MetadataKeys::Find(key, id) && Find(id, value, size);
+		}
+
+		/*!
+		 * \brief Gets the value of a key.
+		 *
+		 * \tparam K Either the id of a key from MetadataKeys, or a <tt>std::string</tt>.
+		 *
+		 * \return true if the key was found.
+		 */
+		template <typename K>
+		inline bool GetView(const K& key, MetadataView& out) const
+		{
+			const Field* f = Lookup(key);
+			if (f == nullptr) return false;
+
+			out = MetadataView(Values() + f->offset, f->size);
+			return true;
+		}
+
+		/*!
+		 * \brief Gets the value of a key as an integer.
+		 *
+		 * \return true if the key was found and its value is a base 10 integer.
+		 */
+		template <typename K>
+		inline bool GetInt(const K& key, Long& out) const
+		{
+			const Field* f = Lookup(key);
+			if (f == nullptr || !(f->types & HasInt)) return false;
+
+			out = f->intValue;
+			return true;
+		}
+
+		/*!
+		 * \brief Gets the value of a key as a floating point number.
+		 *
+		 * \return true if the key was found and its value is a number.
+		 */
+		template <typename K>
+		inline bool GetFloat(const K& key, Double& out) const
+		{
+			const Field* f = Lookup(key);
+			if (f == nullptr || !(f->types & HasFloat)) return false;
+
+			out = f->floatValue;
+			return true;
+		}
+
+		/*!
+		 * \brief Gets the value of a key as a boolean.
+		 *
+		 * <tt>true</tt>, <tt>yes</tt>, <tt>on</tt> and <tt>1</tt> are read as
+		 * true, and <tt>false</tt>, <tt>no</tt>, <tt>off</tt> and <tt>0</tt>
+		 * as false, ignoring case.
+		 *
+		 * \return true if the key was found and its value is a boolean.
+		 */
+		template <typename K>
+		inline bool GetBool(const K& key, bool& out) const
+		{
+			const Field* f = Lookup(key);
+			if (f == nullptr || !(f->types & HasBool)) return false;
+
+			out = f->boolValue;
+			return true;
+		}
+	};
+}
+
+#endif
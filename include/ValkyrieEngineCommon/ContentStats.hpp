@@ -0,0 +1,437 @@
+/*!
+ * \file ContentStats.hpp
+ * \brief Counters and latency histograms describing the work done by vlk::Content<T>.
+ */
+
+#ifndef VLK_CONTENT_STATS_HPP
+#define VLK_CONTENT_STATS_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace vlk
+{
+	/*!
+	 * \brief A snapshot of a latency histogram with power of two buckets.
+	 *
+	 * Bucket 0 counts samples of 0ns, bucket <tt>i > 0</tt> counts samples
+	 * in <tt>[2^(i-1), 2^i)</tt> nanoseconds. The last bucket also counts
+	 * every longer sample.
+	 */
+	struct LatencyHistogram
+	{
+		static VLK_CXX14_CONSTEXPR Size BucketCount = 40;
+
+		ULong buckets[BucketCount];
+
+		//! Number of samples.
+		ULong count;
+
+		ULong totalNanoseconds;
+		ULong maxNanoseconds;
+
+		//! Returns the bucket a sample falls into.
+		static inline Size BucketOf(ULong nanoseconds)
+		{
+			Size bucket = 0;
+			while (nanoseconds != 0 && bucket < BucketCount - 1)
+			{
+				nanoseconds >>= 1;
+				bucket++;
+			}
+
+			return bucket;
+		}
+
+		//! Returns the exclusive upper bound of a bucket in nanoseconds.
+		static inline ULong UpperBound(Size bucket)
+		{
+			return ULong(1) << bucket;
+		}
+
+		//! Returns the mean sample in nanoseconds, or 0 if there are none.
+		inline ULong MeanNanoseconds() const
+		{
+			return (count == 0) ? 0 : totalNanoseconds / count;
+		}
+
+		/*!
+		 * \brief Estimates a percentile of the samples.
+		 *
+		 * \param p The percentile, between 0 and 1.
+		 *
+		 * \returns The upper bound of the bucket holding the percentile,
+		 * capped to the longest sample, or 0 if there are no samples.
+		 */
+		inline ULong PercentileNanoseconds(Double p) const
+		{
+			if (count == 0) return 0;
+
+			const Double target = std::max<Double>(1, p * static_cast<Double>(count));
+			ULong seen = 0;
+			for (Size i = 0; i < BucketCount; i++)
+			{
+				seen += buckets[i];
+				if (static_cast<Double>(seen) >= target) return std::min(UpperBound(i), maxNanoseconds);
+			}
+
+			return maxNanoseconds;
+		}
+	};
+
+	/*!
+	 * \brief A snapshot of the statistics of vlk::Content<T>.
+	 *
+	 * Counters and histograms are only recorded if
+	 * <tt>VLK_COMMON_CONTENT_STATS</tt> is defined, otherwise they are
+	 * always zero.
+	 *
+	 * \sa vlk::Content<T>::GetStats()
+	 */
+	struct ContentStats
+	{
+		//! Returns true if statistics are recorded in this build.
+		static inline constexpr bool Enabled()
+		{
+#ifdef VLK_COMMON_CONTENT_STATS
+			return true;
+#else
+			return false;
+#endif
+		}
+
+		//! Content stored, by any kind of load.
+		ULong loads;
+
+		//! Loads that replaced content stored under the same alias, or brought back evicted content.
+		ULong reloads;
+
+		//! Content removed by unloading or eviction.
+		ULong unloads;
+
+		//! Loads whose content could not be constructed, or whose construction threw on a loader thread.
+		ULong failures;
+
+		//! Retrievals through GetContent.
+		ULong lookups;
+
+		//! Retrievals that found no loaded content.
+		ULong misses;
+
+		//! Number of loaded pieces of content.
+		Size loaded;
+
+		//! Memory used by loaded content, as reported by vlk::ContentSize.
+		Size memoryUsage;
+
+		//! Time spent in vlk::ConstructContent.
+		LatencyHistogram construct;
+
+		//! Time spent in vlk::DestroyContent.
+		LatencyHistogram destroy;
+
+		//! Time spent reading and parsing meta files.
+		LatencyHistogram metadataParse;
+
+		//! Time spent waiting to lock the registry.
+		LatencyHistogram lockWait;
+
+		/*!
+		 * \brief Formats the statistics as a JSON object.
+		 *
+		 * Histograms list their non-empty buckets as
+		 * <tt>[upperBoundNs, count]</tt> pairs.
+		 *
+		 * \param type Name of the content type, written as the
+		 * <tt>"type"</tt> member.
+		 */
+		inline std::string ToJson(const std::string& type) const
+		{
+			std::string out = "{\"type\":";
+			AppendString(out, type);
+			out += ",\"enabled\":";
+			out += Enabled() ? "true" : "false";
+
+			AppendMember(out, "loaded", loaded);
+			AppendMember(out, "memoryUsage", memoryUsage);
+			AppendMember(out, "loads", loads);
+			AppendMember(out, "reloads", reloads);
+			AppendMember(out, "unloads", unloads);
+			AppendMember(out, "failures", failures);
+			AppendMember(out, "lookups", lookups);
+			AppendMember(out, "misses", misses);
+
+			AppendHistogram(out, "construct", construct);
+			AppendHistogram(out, "destroy", destroy);
+			AppendHistogram(out, "metadataParse", metadataParse);
+			AppendHistogram(out, "lockWait", lockWait);
+
+			out += '}';
+			return out;
+		}
+
+		private:
+		static inline void AppendNumber(std::string& out, ULong n)
+		{
+			char buffer[24];
+			std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(n));
+			out += buffer;
+		}
+
+		static inline void AppendMember(std::string& out, const char* name, ULong n)
+		{
+			out += ",\"";
+			out += name;
+			out += "\":";
+			AppendNumber(out, n);
+		}
+
+		static inline void AppendString(std::string& out, const std::string& s)
+		{
+			out += '"';
+			for (char c : s)
+			{
+				if (c == '"' || c == '\\')
+				{
+					out += '\\';
+					out += c;
+				}
+				else if (static_cast<unsigned char>(c) < 0x20)
+				{
+					char buffer[8];
+					std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+					out += buffer;
+				}
+				else
+				{
+					out += c;
+				}
+			}
+			out += '"';
+		}
+
+		static inline void AppendHistogram(std::string& out, const char* name, const LatencyHistogram& h)
+		{
+			out += ",\"";
+			out += name;
+			out += "\":{\"count\":";
+			AppendNumber(out, h.count);
+			AppendMember(out, "totalNs", h.totalNanoseconds);
+			AppendMember(out, "meanNs", h.MeanNanoseconds());
+			AppendMember(out, "maxNs", h.maxNanoseconds);
+			AppendMember(out, "p50Ns", h.PercentileNanoseconds(0.5));
+			AppendMember(out, "p99Ns", h.PercentileNanoseconds(0.99));
+			out += ",\"buckets\":[";
+
+			bool first = true;
+			for (Size i = 0; i < LatencyHistogram::BucketCount; i++)
+			{
+				if (h.buckets[i] == 0) continue;
+				if (!first) out += ',';
+				first = false;
+
+				out += '[';
+				AppendNumber(out, LatencyHistogram::UpperBound(i));
+				out += ',';
+				AppendNumber(out, h.buckets[i]);
+				out += ']';
+			}
+
+			out += "]}";
+		}
+	};
+
+	/*!
+	 * \brief A counter spread over several cache lines, picked per thread,
+	 * so threads adding to it concurrently do not contend on it.
+	 *
+	 * \ts
+	 * Every member may be called from any thread.<br>
+	 * Does not lock.<br>
+	 */
+	class StripedCounter
+	{
+		static VLK_CXX14_CONSTEXPR Size StripeCount = 8;
+
+		struct alignas(64) Stripe
+		{
+			std::atomic<ULong> value;
+		};
+
+		Stripe stripes[StripeCount];
+
+		public:
+		inline StripedCounter() { Reset(); }
+
+		//! Returns the index of the stripe the calling thread adds to, less than 8.
+		static inline Size LocalStripe()
+		{
+			static std::atomic<Size> next(0);
+			thread_local Size stripe = next.fetch_add(1, std::memory_order_relaxed) % StripeCount;
+			return stripe;
+		}
+
+		inline void Add(ULong n = 1)
+		{
+			stripes[LocalStripe()].value.fetch_add(n, std::memory_order_relaxed);
+		}
+
+		//! Returns the sum of every stripe.
+		inline ULong Load() const
+		{
+			ULong total = 0;
+			for (const Stripe& s : stripes) total += s.value.load(std::memory_order_relaxed);
+			return total;
+		}
+
+		inline void Reset()
+		{
+			for (Stripe& s : stripes) s.value.store(0, std::memory_order_relaxed);
+		}
+	};
+
+	/*!
+	 * \brief Records the statistics of one content type.
+	 *
+	 * Used by vlk::Content<T>. Unless <tt>VLK_COMMON_CONTENT_STATS</tt> is
+	 * defined, calls to it compile to nothing and every counter and
+	 * histogram stays zero. The macro must be defined the same way in every
+	 * translation unit, as the inline functions recording statistics
+	 * depend on it.
+	 *
+	 * Counters are spread over several cache lines, picked per thread, so
+	 * threads retrieving content concurrently do not contend on them.
+	 *
+	 * \ts
+	 * Every member may be called from any thread.<br>
+	 * Does not lock.<br>
+	 */
+	class ContentStatsRecorder
+	{
+		public:
+		enum Counter
+		{
+			Loads,
+			Reloads,
+			Unloads,
+			Failures,
+			Lookups,
+			Misses,
+			CounterCount
+		};
+
+		enum Latency
+		{
+			Construct,
+			Destroy,
+			MetadataParse,
+			LockWait,
+			LatencyCount
+		};
+
+		typedef std::chrono::steady_clock::time_point Timestamp;
+
+		private:
+		static VLK_CXX14_CONSTEXPR Size StripeCount = 8;
+
+		struct alignas(64) Stripe
+		{
+			std::atomic<ULong> counters[CounterCount];
+		};
+
+		struct alignas(64) Histogram
+		{
+			std::atomic<ULong> buckets[LatencyHistogram::BucketCount];
+			std::atomic<ULong> count;
+			std::atomic<ULong> totalNanoseconds;
+			std::atomic<ULong> maxNanoseconds;
+		};
+
+		Stripe stripes[StripeCount];
+		Histogram histograms[LatencyCount];
+
+		public:
+		inline ContentStatsRecorder() { Reset(); }
+
+		inline void Add(Counter c, ULong n = 1)
+		{
+			if (!ContentStats::Enabled()) return;
+			stripes[StripedCounter::LocalStripe()].counters[c].fetch_add(n, std::memory_order_relaxed);
+		}
+
+		//! Returns the current time, or does not read the clock if statistics are disabled.
+		inline Timestamp Start() const
+		{
+			return ContentStats::Enabled() ? std::chrono::steady_clock::now() : Timestamp();
+		}
+
+		//! Records the time elapsed since <tt>start</tt>.
+		inline void Record(Latency l, Timestamp start)
+		{
+			if (!ContentStats::Enabled()) return;
+
+			const ULong ns = static_cast<ULong>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+			Histogram& h = histograms[l];
+
+			h.buckets[LatencyHistogram::BucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+			h.count.fetch_add(1, std::memory_order_relaxed);
+			h.totalNanoseconds.fetch_add(ns, std::memory_order_relaxed);
+
+			ULong max = h.maxNanoseconds.load(std::memory_order_relaxed);
+			while (ns > max && !h.maxNanoseconds.compare_exchange_weak(max, ns, std::memory_order_relaxed)) { }
+		}
+
+		//! Copies the counters and histograms into <tt>out</tt>.
+		inline void Snapshot(ContentStats& out) const
+		{
+			ULong totals[CounterCount] = { };
+			for (const Stripe& s : stripes)
+			{
+				for (Size c = 0; c < CounterCount; c++) totals[c] += s.counters[c].load(std::memory_order_relaxed);
+			}
+
+			out.loads = totals[Loads];
+			out.reloads = totals[Reloads];
+			out.unloads = totals[Unloads];
+			out.failures = totals[Failures];
+			out.lookups = totals[Lookups];
+			out.misses = totals[Misses];
+
+			Copy(histograms[Construct], out.construct);
+			Copy(histograms[Destroy], out.destroy);
+			Copy(histograms[MetadataParse], out.metadataParse);
+			Copy(histograms[LockWait], out.lockWait);
+		}
+
+		inline void Reset()
+		{
+			for (Stripe& s : stripes)
+			{
+				for (std::atomic<ULong>& c : s.counters) c.store(0, std::memory_order_relaxed);
+			}
+
+			for (Histogram& h : histograms)
+			{
+				for (std::atomic<ULong>& b : h.buckets) b.store(0, std::memory_order_relaxed);
+				h.count.store(0, std::memory_order_relaxed);
+				h.totalNanoseconds.store(0, std::memory_order_relaxed);
+				h.maxNanoseconds.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		private:
+		static inline void Copy(const Histogram& h, LatencyHistogram& out)
+		{
+			for (Size i = 0; i < LatencyHistogram::BucketCount; i++) out.buckets[i] = h.buckets[i].load(std::memory_order_relaxed);
+			out.count = h.count.load(std::memory_order_relaxed);
+			out.totalNanoseconds = h.totalNanoseconds.load(std::memory_order_relaxed);
+			out.maxNanoseconds = h.maxNanoseconds.load(std::memory_order_relaxed);
+		}
+	};
+}
+
+#endif
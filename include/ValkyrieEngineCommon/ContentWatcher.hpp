@@ -0,0 +1,447 @@
+/*!
+ * \file ContentWatcher.hpp
+ * \brief Watching content directories for changed files, and hot reloading content.
+ */
+
+#ifndef VLK_CONTENT_WATCHER_HPP
+#define VLK_CONTENT_WATCHER_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include "ValkyrieEngineCommon/Content.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <dirent.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vlk
+{
+	/*!
+	 * \brief Reports files that were written in a directory tree.
+	 *
+	 * A background thread receives change notifications from the operating
+	 * system, so directories are only scanned when they are first watched.
+	 * A file is reported once no further change to it has been seen for the
+	 * debounce interval, so the burst of writes an editor or exporter makes
+	 * while saving a file is reported as a single change. Directories
+	 * created or moved into the tree after the watcher started are watched
+	 * as well, and files already in them are reported.
+	 *
+	 * If more changes arrive at once than the operating system can queue,
+	 * the whole tree is scanned again and every file in it is reported, so no
+	 * change is lost.
+	 *
+	 * Only supported on Linux, where it is built on inotify.
+	 *
+	 * \ts
+	 * May be constructed and destroyed from any thread.<br>
+	 * Poll() may be called from any thread.<br>
+	 */
+	class ContentWatcher
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		std::string root;
+		Clock::duration debounce;
+
+		//! Files that changed but have not been quiet for the debounce interval yet. Only used by the watcher thread.
+		std::unordered_map<std::string, Clock::time_point> changing;
+
+		std::vector<std::string> settled;
+		std::mutex settledMutex;
+
+#ifdef __linux__
+		int notifyFd;
+		int stopFd;
+
+		//! Set if the watcher thread stopped because waiting for events failed.
+		std::atomic<bool> failed;
+
+		//! Directory of each watch, relative to the root. Only used by the watcher thread after construction.
+		std::unordered_map<int, std::string> directories;
+		std::thread thread;
+
+		static VLK_CXX14_CONSTEXPR uint32_t FileEvents = IN_CLOSE_WRITE | IN_MOVED_TO;
+		static VLK_CXX14_CONSTEXPR uint32_t DirectoryEvents = IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+		/*!
+		 * Watches a directory, relative to the root and either empty or
+		 * ending in '/', and every directory below it. If
+		 * <tt>reportFiles</tt> is true, every file found is reported as
+		 * changed.
+		 */
+		inline void Watch(const std::string& directory, bool reportFiles)
+		{
+			const std::string full = root + directory;
+			const int wd = inotify_add_watch(notifyFd, full.empty() ? "." : full.c_str(), FileEvents | DirectoryEvents);
+			if (wd < 0) return;
+			directories[wd] = directory;
+
+			DIR* dir = opendir(full.empty() ? "." : full.c_str());
+			if (dir == nullptr) return;
+
+			std::vector<std::string> children;
+			while (dirent* entry = readdir(dir))
+			{
+				const std::string name = entry->d_name;
+				if (name == "." || name == "..") continue;
+
+				bool isDirectory = (entry->d_type == DT_DIR);
+				if (entry->d_type == DT_UNKNOWN)
+				{
+					struct stat st;
+					isDirectory = stat((full + name).c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+				}
+
+				if (isDirectory) children.push_back(name);
+				else if (reportFiles) changing[directory + name] = Clock::now();
+			}
+			closedir(dir);
+
+			for (const std::string& child : children) Watch(directory + child + "/", reportFiles);
+		}
+
+		//! Stops watching a directory, relative to the root and ending in '/', and every directory below it.
+		inline void Unwatch(const std::string& directory)
+		{
+			for (auto it = directories.begin(); it != directories.end();)
+			{
+				if (it->second.compare(0, directory.size(), directory) == 0)
+				{
+					inotify_rm_watch(notifyFd, it->first);
+					it = directories.erase(it);
+				}
+				else
+				{
+					it++;
+				}
+			}
+		}
+
+		inline void ReadEvents()
+		{
+			alignas(inotify_event) char buffer[4096];
+			ssize_t length;
+
+			while ((length = read(notifyFd, buffer, sizeof(buffer))) > 0)
+			{
+				ProcessEvents(buffer, length);
+			}
+		}
+
+		inline void ProcessEvents(const char* buffer, ssize_t length)
+		{
+			const Clock::time_point now = Clock::now();
+
+			for (ssize_t offset = 0; offset < length;)
+			{
+				const inotify_event* e = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += sizeof(inotify_event) + e->len;
+
+				// Events were dropped, so any file may have changed and any directory may be new
+				if (e->mask & IN_Q_OVERFLOW)
+				{
+					directories.clear();
+					Watch("", true);
+					continue;
+				}
+
+				if (e->mask & (IN_IGNORED | IN_DELETE_SELF))
+				{
+					directories.erase(e->wd);
+					continue;
+				}
+
+				auto it = directories.find(e->wd);
+				if (it == directories.end()) continue;
+
+				// Moves below the root are handled through IN_MOVED_FROM first, so this is the root itself leaving its path
+				if (e->mask & IN_MOVE_SELF)
+				{
+					const std::string moved = it->second;
+					Unwatch(moved);
+					continue;
+				}
+
+				if (e->len == 0) continue;
+
+				const std::string path = it->second + e->name;
+
+				if (e->mask & IN_ISDIR)
+				{
+					// A directory moved within the tree is watched again under its new path
+					if (e->mask & IN_MOVED_FROM) Unwatch(path + "/");
+					if (e->mask & (IN_CREATE | IN_MOVED_TO)) Watch(path + "/", true);
+				}
+				else if (e->mask & FileEvents)
+				{
+					changing[path] = now;
+				}
+			}
+		}
+
+		//! Moves files that have been quiet for the debounce interval to the settled list.
+		inline void Settle()
+		{
+			const Clock::time_point now = Clock::now();
+			std::lock_guard<std::mutex> lock(settledMutex);
+
+			for (auto it = changing.begin(); it != changing.end();)
+			{
+				if (now - it->second >= debounce)
+				{
+					settled.push_back(it->first);
+					it = changing.erase(it);
+				}
+				else
+				{
+					it++;
+				}
+			}
+		}
+
+		inline void Run()
+		{
+			while (true)
+			{
+				// Sleep until an event arrives or the next pending change settles
+				int timeout = -1;
+				if (!changing.empty())
+				{
+					Clock::time_point next = Clock::time_point::max();
+					for (const std::pair<const std::string, Clock::time_point>& c : changing) next = std::min(next, c.second + debounce);
+
+					const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - Clock::now()).count() + 1;
+					timeout = static_cast<int>(std::max<decltype(wait)>(wait, 0));
+				}
+
+				pollfd fds[2] = { { notifyFd, POLLIN, 0 }, { stopFd, POLLIN, 0 } };
+				if (poll(fds, 2, timeout) < 0)
+				{
+					if (errno == EINTR) continue;
+					failed.store(true, std::memory_order_release);
+					return;
+				}
+
+				if (fds[1].revents & POLLIN) return;
+				if (fds[0].revents & POLLIN) ReadEvents();
+
+				Settle();
+			}
+		}
+#endif
+
+		public:
+		//! Returns true if watching directories is supported on this platform.
+		static inline bool IsSupported()
+		{
+#ifdef __linux__
+			return true;
+#else
+			return false;
+#endif
+		}
+
+		/*!
+		 * \brief Starts watching a directory and every directory below it.
+		 *
+		 * \param directory Path of the directory. Reported paths are relative
+		 * to it, so a content prefix such as <tt>"content/"</tt> may be passed
+		 * as is.
+		 * \param debounceInterval Time a file must go without changes before
+		 * it is reported.
+		 *
+		 * \throws std::runtime_error if watching is not supported or the
+		 * directory can not be watched.
+		 */
+		inline explicit ContentWatcher(const std::string& directory, std::chrono::milliseconds debounceInterval = std::chrono::milliseconds(100)) :
+			root(directory),
+			debounce(debounceInterval),
+			changing(),
+			settled(),
+			settledMutex()
+		{
+			if (!root.empty() && root.back() != '/') root += '/';
+
+#ifdef __linux__
+			notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+			if (notifyFd < 0) throw std::runtime_error("Could not initialize inotify.");
+
+			stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+			if (stopFd < 0)
+			{
+				close(notifyFd);
+				throw std::runtime_error("Could not create an eventfd.");
+			}
+
+			failed.store(false, std::memory_order_relaxed);
+
+			Watch("", false);
+			if (directories.empty())
+			{
+				close(notifyFd);
+				close(stopFd);
+				throw std::runtime_error("Could not watch content directory " + directory);
+			}
+
+			thread = std::thread([this]() { Run(); });
+#else
+			throw std::runtime_error("Watching content directories is only supported on Linux.");
+#endif
+		}
+
+		ContentWatcher(const ContentWatcher&) = delete;
+		ContentWatcher& operator=(const ContentWatcher&) = delete;
+
+		//! Stops watching. Changes that have not been reported yet are discarded.
+		inline ~ContentWatcher()
+		{
+#ifdef __linux__
+			const uint64_t one = 1;
+			if (write(stopFd, &one, sizeof(one)) < 0) { }
+			thread.join();
+
+			close(notifyFd);
+			close(stopFd);
+#endif
+		}
+
+		/*!
+		 * \brief Returns true if the watcher stopped because waiting for
+		 * changes failed. No further changes are reported in that case.
+		 */
+		inline bool HasFailed() const
+		{
+#ifdef __linux__
+			return failed.load(std::memory_order_acquire);
+#else
+			return false;
+#endif
+		}
+
+		/*!
+		 * \brief Returns the files that were written since the last call and
+		 * have since been quiet for the debounce interval.
+		 *
+		 * \returns Sorted paths relative to the watched directory, using '/'
+		 * as separator. Each path appears at most once.
+		 */
+		inline std::vector<std::string> Poll()
+		{
+			std::vector<std::string> out;
+
+			{
+				std::lock_guard<std::mutex> lock(settledMutex);
+				out.swap(settled);
+			}
+
+			std::sort(out.begin(), out.end());
+			out.erase(std::unique(out.begin(), out.end()), out.end());
+			return out;
+		}
+	};
+
+	/*!
+	 * \brief Reloads content of type T when the files it was loaded from
+	 * change.
+	 *
+	 * Hot reloading is opt-in: constructing a ContentHotReload<T> starts a
+	 * ContentWatcher on the content prefix of Content<T>. Each call to
+	 * Update() starts an asynchronous reload, through
+	 * <tt>vlk::Content<T>::LoadContentAsync(const std::string&, const std::string&)</tt>,
+	 * for every alias whose file or <tt>.meta</tt> file has changed. The new
+	 * content is constructed on a loader thread and swapped in by the next
+	 * call to <tt>vlk::Content<T>::PublishLoads()</tt>, which sends the usual
+	 * <tt>UnloadEvent</tt> and <tt>LoadEvent</tt>. Content whose reload fails
+	 * to construct is left in place.
+	 *
+	 * Only loose files are watched. Content loaded from a content archive, or
+	 * from a content prefix other than the one at construction, is not
+	 * reloaded.
+	 *
+	 * \code
+	 * vlk::ContentHotReload<Texture> reload;
+	 *
+	 * // Once per frame
+	 * reload.Update();
+	 * vlk::Content<Texture>::PublishLoads();
+	 * \endcode
+	 *
+	 * \ts
+	 * Update() must only be called from the main thread.<br>
+	 */
+	template <typename T>
+	class ContentHotReload
+	{
+		ContentWatcher watcher;
+
+		static inline bool EndsWith(const std::string& s, const char* suffix)
+		{
+			const Size n = std::char_traits<char>::length(suffix);
+			return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+		}
+
+		public:
+		/*!
+		 * \brief Starts watching the current content prefix of Content<T>.
+		 *
+		 * \throws std::runtime_error if watching is not supported or the
+		 * content prefix can not be watched.
+		 */
+		inline explicit ContentHotReload(std::chrono::milliseconds debounceInterval = std::chrono::milliseconds(100)) :
+			watcher(Content<T>::GetContentPrefix(), debounceInterval)
+		{ }
+
+		/*!
+		 * \brief Starts reloading content whose files have changed.
+		 *
+		 * \returns The number of reloads started.
+		 */
+		inline Size Update()
+		{
+			if (Content<T>::GetContentArchive()) return 0;
+
+			// A content file and its meta file changing together reload the content once
+			std::vector<std::string> paths;
+			for (std::string path : watcher.Poll())
+			{
+				// Binary metadata caches, and their temporary files, are written by loads themselves
+				if (path.find(".metab") != std::string::npos) continue;
+				if (EndsWith(path, ".meta")) path.resize(path.size() - 5);
+				paths.push_back(path);
+			}
+
+			std::sort(paths.begin(), paths.end());
+			paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+
+			Size started = 0;
+			for (const std::string& path : paths)
+			{
+				for (const std::string& alias : Content<T>::GetAliasesLoadedFrom(path))
+				{
+					Content<T>::LoadContentAsync(path, alias);
+					started++;
+				}
+			}
+
+			return started;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,242 @@
+/*!
+ * \file Epoch.hpp
+ * \brief Epoch-based reclamation for data structures with lock-free readers.
+ */
+
+#ifndef VLK_EPOCH_HPP
+#define VLK_EPOCH_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace vlk
+{
+	/*!
+	 * \brief Defers destruction of shared objects until no reader can still
+	 * be using them.
+	 *
+	 * Readers wrap every access to shared data in an EpochGuard. Entering a
+	 * guard publishes the current epoch in a slot owned by the calling thread,
+	 * which is a plain store to a cache line no other thread writes to, so
+	 * readers never contend with each other.
+	 *
+	 * Writers first make an object unreachable, then pass a function that
+	 * destroys it to Retire(). The object is destroyed once every reader that
+	 * might have seen it has left its guard.
+	 *
+	 * A single process-wide domain is shared by every user, see Global().
+	 */
+	class EpochDomain
+	{
+		/*!
+		 * Per-thread reader state. Slots are never freed, only reused by later threads.
+		 *
+		 * Padded by a cache line on either side instead of aligned, as
+		 * <tt>new</tt> only guarantees the alignment of std::max_align_t
+		 * before C++17. The lines holding the fields then never hold another
+		 * allocation.
+		 */
+		struct Slot
+		{
+			char padBefore[64];
+
+			//! Epoch the owning thread entered its outermost guard at, or zero.
+			std::atomic<Size> epoch;
+
+			//! True while owned by a thread.
+			std::atomic<bool> owned;
+
+			//! Nesting depth of guards on the owning thread.
+			Size depth;
+
+			Slot* next;
+
+			char padAfter[64];
+
+			inline Slot() : epoch(0), owned(true), depth(0), next(nullptr) { }
+		};
+
+		//! Releases the slot of a thread when the thread exits.
+		struct SlotOwner
+		{
+			Slot* slot;
+
+			inline SlotOwner() : slot(nullptr) { }
+
+			inline ~SlotOwner()
+			{
+				if (slot != nullptr) slot->owned.store(false, std::memory_order_release);
+			}
+		};
+
+		//! Current epoch. Starts at one since zero marks an inactive slot.
+		std::atomic<Size> epoch;
+
+		//! Head of the list of every slot ever created.
+		std::atomic<Slot*> slots;
+		std::mutex slotMutex;
+
+		std::vector<std::pair<Size, std::function<void()>>> retired;
+		std::mutex retireMutex;
+
+		inline EpochDomain() : epoch(1), slots(nullptr), slotMutex(), retired(), retireMutex() { }
+
+		inline Slot& LocalSlot()
+		{
+			static thread_local SlotOwner owner;
+			if (owner.slot != nullptr) return *owner.slot;
+
+			for (Slot* s = slots.load(std::memory_order_acquire); s != nullptr; s = s->next)
+			{
+				bool expected = false;
+				if (s->owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+				{
+					owner.slot = s;
+					return *s;
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(slotMutex);
+			Slot* s = new Slot();
+			s->next = slots.load(std::memory_order_relaxed);
+			slots.store(s, std::memory_order_release);
+			owner.slot = s;
+			return *s;
+		}
+
+		//! Returns the oldest epoch any reader is in, or the maximum value if no reader is active.
+		inline Size OldestActiveEpoch() const
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			Size oldest = std::numeric_limits<Size>::max();
+			for (Slot* s = slots.load(std::memory_order_acquire); s != nullptr; s = s->next)
+			{
+				const Size e = s->epoch.load(std::memory_order_acquire);
+				if (e != 0) oldest = std::min(oldest, e);
+			}
+
+			return oldest;
+		}
+
+		public:
+		EpochDomain(const EpochDomain&) = delete;
+		EpochDomain& operator=(const EpochDomain&) = delete;
+
+		//! Destroys every retired object. No reader may be active.
+		inline ~EpochDomain()
+		{
+			for (std::pair<Size, std::function<void()>>& r : retired) r.second();
+
+			Slot* s = slots.load(std::memory_order_acquire);
+			while (s != nullptr)
+			{
+				Slot* next = s->next;
+				delete s;
+				s = next;
+			}
+		}
+
+		//! Returns the process-wide epoch domain.
+		static inline EpochDomain& Global()
+		{
+			static EpochDomain domain;
+			return domain;
+		}
+
+		/*!
+		 * \brief Marks the calling thread as reading shared data.
+		 *
+		 * Prefer EpochGuard over calling this directly. Calls may be nested.
+		 */
+		inline void Enter()
+		{
+			Slot& s = LocalSlot();
+			if (s.depth++ != 0) return;
+
+			s.epoch.store(epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+
+			// Orders the store above before any read of shared data, pairs with OldestActiveEpoch()
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+		}
+
+		//! Ends a call to Enter().
+		inline void Leave()
+		{
+			Slot& s = LocalSlot();
+			if (--s.depth != 0) return;
+
+			s.epoch.store(0, std::memory_order_release);
+		}
+
+		/*!
+		 * \brief Schedules an object for destruction.
+		 *
+		 * The object must already be unreachable for new readers. The
+		 * function is called once no reader that entered before this call is
+		 * still active, either by this or a later call to Retire() or
+		 * Collect(). It must not call Retire() or Collect() itself.
+		 *
+		 * \param destroy Function destroying the object.
+		 */
+		inline void Retire(std::function<void()> destroy)
+		{
+			{
+				std::lock_guard<std::mutex> lock(retireMutex);
+				retired.push_back(std::make_pair(epoch.fetch_add(1, std::memory_order_acq_rel), std::move(destroy)));
+			}
+
+			Collect();
+		}
+
+		/*!
+		 * \brief Destroys every retired object that no reader can be using anymore.
+		 *
+		 * \return The number of objects still waiting to be destroyed.
+		 */
+		inline Size Collect()
+		{
+			std::vector<std::function<void()>> ready;
+			Size remaining;
+
+			{
+				std::lock_guard<std::mutex> lock(retireMutex);
+				const Size oldest = OldestActiveEpoch();
+
+				auto split = std::partition(retired.begin(), retired.end(),
+					[oldest](const std::pair<Size, std::function<void()>>& r) { return r.first >= oldest; });
+
+				for (auto it = split; it != retired.end(); it++) ready.push_back(std::move(it->second));
+				retired.erase(split, retired.end());
+				remaining = retired.size();
+			}
+
+			for (std::function<void()>& f : ready) f();
+			return remaining;
+		}
+	};
+
+	/*!
+	 * \brief Marks the calling thread as reading shared data protected by an
+	 * EpochDomain for the lifetime of the guard.
+	 */
+	class EpochGuard
+	{
+		EpochDomain& domain;
+
+		public:
+		inline explicit EpochGuard(EpochDomain& d = EpochDomain::Global()) : domain(d) { domain.Enter(); }
+		inline ~EpochGuard() { domain.Leave(); }
+
+		EpochGuard(const EpochGuard&) = delete;
+		EpochGuard& operator=(const EpochGuard&) = delete;
+	};
+}
+
+#endif
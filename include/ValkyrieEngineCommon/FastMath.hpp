@@ -0,0 +1,538 @@
+/*!
+ * \file FastMath.hpp
+ * \brief Fast approximations of trigonometric functions and reciprocal
+ * square roots, with bounded error.
+ *
+ *	The functions in this file trade a small, documented amount of accuracy
+ *	for speed, and are only used where called explicitly. The runtime
+ *	overloads in VMath.hpp remain exact to the precision of the standard
+ *	library.
+ *
+ *	Each function has a batch overload operating on arrays, which processes
+ *	eight values per iteration with AVX2 and four with SSE2, chosen at
+ *	runtime through vlk::GetSIMDLevel(). AVX-512 CPUs use the AVX2 loop.
+ *	Batch overloads produce the same results as the scalar ones, except that
+ *	angles exactly halfway between two multiples of pi/2 may be reduced to
+ *	either, which changes results by at most the documented error.
+ *
+ *	Errors are measured against the double precision standard library
+ *	functions, see test/VMath/FastMath.cpp.
+ */
+
+#ifndef VLK_FAST_MATH_HPP
+#define VLK_FAST_MATH_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include "ValkyrieEngineCommon/SIMD.hpp"
+#include "ValkyrieEngineCommon/VMath.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace vlk
+{
+	/*!
+	 * \brief Coefficients shared by the scalar and batch approximations.
+	 */
+	namespace FastMathConstants
+	{
+		constexpr Float TwoOverPi = 0.636619772367581343f;
+
+		//! Largest angle reduced by vlk::SinCos(), keeping the quadrant <tt>angle * 2 / pi</tt> well within the range of Int.
+		constexpr Float SinCosMaxAngle = 1073741824.0f;
+
+		//! pi/2 split into three parts, the first two exactly representable with few significant bits, for Cody-Waite range reduction.
+		constexpr Float HalfPiA = 1.5703125f;
+		constexpr Float HalfPiB = 4.837512969970703125e-4f;
+		constexpr Float HalfPiC = 7.54978995489188216e-8f;
+
+		//! Minimax polynomial for sin(r) / r - 1 on [-pi/4, pi/4], in powers of r^2.
+		constexpr Float SinP1 = -1.6666654611e-1f;
+		constexpr Float SinP2 = 8.3321608736e-3f;
+		constexpr Float SinP3 = -1.9515295891e-4f;
+
+		//! Minimax polynomial for (cos(r) - 1 + r^2 / 2) / r^4 on [-pi/4, pi/4], in powers of r^2.
+		constexpr Float CosP1 = 4.166664568298827e-2f;
+		constexpr Float CosP2 = -1.388731625493765e-3f;
+		constexpr Float CosP3 = 2.443315711809948e-5f;
+
+		//! Minimax polynomial for atan(a) / a on [0, 1], in powers of a^2.
+		constexpr Float ATanP0 = 0.999996111594382f;
+		constexpr Float ATanP1 = -0.3331736815059275f;
+		constexpr Float ATanP2 = 0.19807816217712654f;
+		constexpr Float ATanP3 = -0.13233344097668515f;
+		constexpr Float ATanP4 = 0.07962370306812347f;
+		constexpr Float ATanP5 = -0.0336042435725542f;
+		constexpr Float ATanP6 = 0.006811800004260469f;
+
+		//! Polynomial for acos(a) / sqrt(1 - a) on [0, 1], from Abramowitz and Stegun 4.4.46.
+		constexpr Float ACosP0 = 1.5707963050f;
+		constexpr Float ACosP1 = -0.2145988016f;
+		constexpr Float ACosP2 = 0.0889789874f;
+		constexpr Float ACosP3 = -0.0501743046f;
+		constexpr Float ACosP4 = 0.0308918810f;
+		constexpr Float ACosP5 = -0.0170881256f;
+		constexpr Float ACosP6 = 0.0066700901f;
+		constexpr Float ACosP7 = -0.0012624911f;
+	}
+
+	/*!
+	 * \brief Calculates the sine and cosine of an angle at once.
+	 *
+	 * The angle is reduced to [-pi/4, pi/4] and both values are evaluated
+	 * with minimax polynomials, sharing the reduction.
+	 *
+	 * Maximum absolute error is 1e-7 for <tt>|angle| <= 8192</tt> and 1e-6
+	 * for <tt>|angle| <= 65536</tt>, and the maximum error relative to the
+	 * result is 2 ulp for <tt>|angle| <= pi</tt>. Accuracy degrades quickly
+	 * beyond <tt>|angle| = 65536</tt>. Both outputs are <tt>NaN</tt> if
+	 * <tt>angle</tt> is <tt>NaN</tt>, infinite or <tt>|angle| > 2^30</tt>.
+	 *
+	 * \param angle An angle, measured in radians.
+	 * \param sine Set to the sine of <tt>angle</tt>.
+	 * \param cosine Set to the cosine of <tt>angle</tt>.
+	 *
+	 * \sa vlk::Sin()
+	 * \sa vlk::Cos()
+	 */
+	inline void SinCos(Float angle, Float& sine, Float& cosine)
+	{
+		using namespace FastMathConstants;
+
+		// Also rejects NaN, whose conversion to Int would be undefined
+		if (!(std::abs(angle) <= SinCosMaxAngle))
+		{
+			sine = std::numeric_limits<Float>::quiet_NaN();
+			cosine = sine;
+			return;
+		}
+
+		const Int k = static_cast<Int>(angle * TwoOverPi + ((angle < 0) ? -0.5f : 0.5f));
+		const Float kf = static_cast<Float>(k);
+		const Float r = ((angle - kf * HalfPiA) - kf * HalfPiB) - kf * HalfPiC;
+		const Float z = r * r;
+
+		const Float s = r + r * z * (SinP1 + z * (SinP2 + z * SinP3));
+		const Float c = 1.0f - 0.5f * z + z * z * (CosP1 + z * (CosP2 + z * CosP3));
+
+		// Quadrant k swaps sine and cosine on odd quadrants and negates them on two of every four
+		const bool swap = (k & 1) != 0;
+		sine = swap ? c : s;
+		cosine = swap ? s : c;
+
+		if (k & 2) sine = -sine;
+		if ((k + 1) & 2) cosine = -cosine;
+	}
+
+	/*!
+	 * \brief Calculates the arc tangent of a coordinate measured from the
+	 * origin, like vlk::ATan2().
+	 *
+	 * Maximum absolute error is 6e-7 radians for finite arguments. Signed
+	 * zeros are handled like <tt>std::atan2</tt>, and <tt>FastATan2(0, 0)</tt>
+	 * is 0. Results are unspecified if both arguments are infinite.
+	 *
+	 * \param y The y-coordinate of the point.
+	 * \param x The x-coordinate of the point.
+	 *
+	 * \returns An angle in [-pi, pi], given in radians.
+	 */
+	inline Float FastATan2(Float y, Float x)
+	{
+		using namespace FastMathConstants;
+
+		const Float ax = std::abs(x);
+		const Float ay = std::abs(y);
+		const Float hi = std::max(ax, ay);
+		const Float a = (hi == 0) ? 0.0f : std::min(ax, ay) / hi;
+		const Float s = a * a;
+
+		Float r = a * (ATanP0 + s * (ATanP1 + s * (ATanP2 + s * (ATanP3 + s * (ATanP4 + s * (ATanP5 + s * ATanP6))))));
+		if (ay > ax) r = HalfPi - r;
+		if (std::signbit(x)) r = Pi - r;
+
+		return std::copysign(r, y);
+	}
+
+	/*!
+	 * \brief Calculates the arc cosine of a value, like vlk::ACos().
+	 *
+	 * Maximum absolute error is 5e-7 radians. Values outside [-1, 1] are
+	 * clamped to it, so the dot product of two unit vectors that rounds
+	 * slightly above 1 does not produce <tt>NaN</tt>.
+	 *
+	 * \param f A value in the range of [-1, 1].
+	 *
+	 * \returns An angle in [0, pi], given in radians.
+	 */
+	inline Float FastACos(Float f)
+	{
+		using namespace FastMathConstants;
+
+		const Float a = std::min(std::abs(f), 1.0f);
+		const Float p = ACosP0 + a * (ACosP1 + a * (ACosP2 + a * (ACosP3 + a * (ACosP4 + a * (ACosP5 + a * (ACosP6 + a * ACosP7))))));
+		const Float r = p * std::sqrt(1.0f - a);
+
+		return (f < 0) ? Pi - r : r;
+	}
+
+	#ifdef VLK_COMMON_SSE2
+	/*!
+	 * \brief Approximates the reciprocal square root of four floats.
+	 *
+	 * \copydetails vlk::FastInvSqrt(Float)
+	 */
+	inline __m128 FastInvSqrt(__m128 f)
+	{
+		// One Newton-Raphson step, y * (1.5 - 0.5 * f * y * y), doubles the 12 correct bits of the estimate
+		const __m128 y = _mm_rsqrt_ps(f);
+		const __m128 halfF = _mm_mul_ps(_mm_set1_ps(0.5f), f);
+		return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(halfF, _mm_mul_ps(y, y))));
+	}
+	#endif
+
+	/*!
+	 * \brief Approximates <tt>1 / Sqrt(f)</tt>.
+	 *
+	 * Refines the hardware estimate with one Newton-Raphson step, avoiding
+	 * both a square root and a division. Maximum relative error is 5e-7.
+	 *
+	 * \param f A positive, normal float. The result for zero, denormals and
+	 * infinity is <tt>NaN</tt> or infinite.
+	 */
+	inline Float FastInvSqrt(Float f)
+	{
+		#ifdef VLK_COMMON_SSE2
+		return _mm_cvtss_f32(FastInvSqrt(_mm_set_ss(f)));
+		#else
+		return 1.0f / std::sqrt(f);
+		#endif
+	}
+
+	/*!
+	 * \brief Loops applying the fast approximations to arrays with each
+	 * instruction set, chosen at runtime by the batch overloads.
+	 */
+	namespace FastMathKernels
+	{
+		#ifdef VLK_COMMON_RUNTIME_DISPATCH
+		VLK_COMMON_TARGET("sse2") inline void SinCosSSE2(const Float* angles, Float* sines, Float* cosines, Size n)
+		{
+			using namespace FastMathConstants;
+			Size i = 0;
+
+			const __m128i one = _mm_set1_epi32(1);
+			const __m128i two = _mm_set1_epi32(2);
+			const __m128 signBit = _mm_set1_ps(-0.0f);
+			const __m128 nan = _mm_set1_ps(std::numeric_limits<Float>::quiet_NaN());
+			for (; i + 4 <= n; i += 4)
+			{
+				const __m128 a = _mm_loadu_ps(angles + i);
+
+				// False for NaN, so lanes the scalar overload rejects are set to NaN below
+				const __m128 valid = _mm_cmple_ps(_mm_andnot_ps(signBit, a), _mm_set1_ps(SinCosMaxAngle));
+				const __m128i k = _mm_cvtps_epi32(_mm_mul_ps(a, _mm_set1_ps(TwoOverPi)));
+				const __m128 kf = _mm_cvtepi32_ps(k);
+
+				__m128 r = _mm_sub_ps(a, _mm_mul_ps(kf, _mm_set1_ps(HalfPiA)));
+				r = _mm_sub_ps(r, _mm_mul_ps(kf, _mm_set1_ps(HalfPiB)));
+				r = _mm_sub_ps(r, _mm_mul_ps(kf, _mm_set1_ps(HalfPiC)));
+				const __m128 z = _mm_mul_ps(r, r);
+
+				__m128 s = _mm_add_ps(_mm_set1_ps(SinP2), _mm_mul_ps(z, _mm_set1_ps(SinP3)));
+				s = _mm_add_ps(_mm_set1_ps(SinP1), _mm_mul_ps(z, s));
+				s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, z), s));
+
+				__m128 c = _mm_add_ps(_mm_set1_ps(CosP2), _mm_mul_ps(z, _mm_set1_ps(CosP3)));
+				c = _mm_add_ps(_mm_set1_ps(CosP1), _mm_mul_ps(z, c));
+				c = _mm_mul_ps(_mm_mul_ps(z, z), c);
+				c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), z)), c);
+
+				const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(k, one), one));
+				const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(k, two), 30));
+				const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(k, one), two), 30));
+
+				const __m128 sOut = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+				const __m128 cOut = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+
+				const __m128 sSigned = _mm_xor_ps(sOut, sinSign);
+				const __m128 cSigned = _mm_xor_ps(cOut, cosSign);
+
+				_mm_storeu_ps(sines + i, _mm_or_ps(_mm_and_ps(valid, sSigned), _mm_andnot_ps(valid, nan)));
+				_mm_storeu_ps(cosines + i, _mm_or_ps(_mm_and_ps(valid, cSigned), _mm_andnot_ps(valid, nan)));
+			}
+
+			for (; i < n; i++) SinCos(angles[i], sines[i], cosines[i]);
+		}
+
+		VLK_COMMON_TARGET("avx2") inline void SinCosAVX2(const Float* angles, Float* sines, Float* cosines, Size n)
+		{
+			using namespace FastMathConstants;
+			Size i = 0;
+
+			const __m256i one = _mm256_set1_epi32(1);
+			const __m256i two = _mm256_set1_epi32(2);
+			const __m256 signBit = _mm256_set1_ps(-0.0f);
+			const __m256 nan = _mm256_set1_ps(std::numeric_limits<Float>::quiet_NaN());
+			for (; i + 8 <= n; i += 8)
+			{
+				const __m256 a = _mm256_loadu_ps(angles + i);
+
+				// False for NaN, so lanes the scalar overload rejects are set to NaN below
+				const __m256 valid = _mm256_cmp_ps(_mm256_andnot_ps(signBit, a), _mm256_set1_ps(SinCosMaxAngle), _CMP_LE_OQ);
+				const __m256i k = _mm256_cvtps_epi32(_mm256_mul_ps(a, _mm256_set1_ps(TwoOverPi)));
+				const __m256 kf = _mm256_cvtepi32_ps(k);
+
+				__m256 r = _mm256_sub_ps(a, _mm256_mul_ps(kf, _mm256_set1_ps(HalfPiA)));
+				r = _mm256_sub_ps(r, _mm256_mul_ps(kf, _mm256_set1_ps(HalfPiB)));
+				r = _mm256_sub_ps(r, _mm256_mul_ps(kf, _mm256_set1_ps(HalfPiC)));
+				const __m256 z = _mm256_mul_ps(r, r);
+
+				__m256 s = _mm256_add_ps(_mm256_set1_ps(SinP2), _mm256_mul_ps(z, _mm256_set1_ps(SinP3)));
+				s = _mm256_add_ps(_mm256_set1_ps(SinP1), _mm256_mul_ps(z, s));
+				s = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, z), s));
+
+				__m256 c = _mm256_add_ps(_mm256_set1_ps(CosP2), _mm256_mul_ps(z, _mm256_set1_ps(CosP3)));
+				c = _mm256_add_ps(_mm256_set1_ps(CosP1), _mm256_mul_ps(z, c));
+				c = _mm256_mul_ps(_mm256_mul_ps(z, z), c);
+				c = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), z)), c);
+
+				const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(k, one), one));
+				const __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(k, two), 30));
+				const __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(k, one), two), 30));
+
+				const __m256 sSigned = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sinSign);
+				const __m256 cSigned = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosSign);
+
+				_mm256_storeu_ps(sines + i, _mm256_blendv_ps(nan, sSigned, valid));
+				_mm256_storeu_ps(cosines + i, _mm256_blendv_ps(nan, cSigned, valid));
+			}
+
+			for (; i < n; i++) SinCos(angles[i], sines[i], cosines[i]);
+		}
+
+		VLK_COMMON_TARGET("sse2") inline void ATan2SSE2(const Float* y, const Float* x, Float* out, Size n)
+		{
+			using namespace FastMathConstants;
+			Size i = 0;
+
+			const __m128 signBit = _mm_set1_ps(-0.0f);
+			for (; i + 4 <= n; i += 4)
+			{
+				const __m128 vy = _mm_loadu_ps(y + i);
+				const __m128 vx = _mm_loadu_ps(x + i);
+				const __m128 ax = _mm_andnot_ps(signBit, vx);
+				const __m128 ay = _mm_andnot_ps(signBit, vy);
+				const __m128 hi = _mm_max_ps(ax, ay);
+
+				// 0 / 0 is NaN, and is masked to 0
+				const __m128 a = _mm_and_ps(_mm_div_ps(_mm_min_ps(ax, ay), hi), _mm_cmpneq_ps(hi, _mm_setzero_ps()));
+				const __m128 s = _mm_mul_ps(a, a);
+
+				__m128 p = _mm_add_ps(_mm_set1_ps(ATanP5), _mm_mul_ps(s, _mm_set1_ps(ATanP6)));
+				p = _mm_add_ps(_mm_set1_ps(ATanP4), _mm_mul_ps(s, p));
+				p = _mm_add_ps(_mm_set1_ps(ATanP3), _mm_mul_ps(s, p));
+				p = _mm_add_ps(_mm_set1_ps(ATanP2), _mm_mul_ps(s, p));
+				p = _mm_add_ps(_mm_set1_ps(ATanP1), _mm_mul_ps(s, p));
+				p = _mm_add_ps(_mm_set1_ps(ATanP0), _mm_mul_ps(s, p));
+				__m128 r = _mm_mul_ps(a, p);
+
+				const __m128 swap = _mm_cmpgt_ps(ay, ax);
+				r = _mm_or_ps(_mm_and_ps(swap, _mm_sub_ps(_mm_set1_ps(HalfPi), r)), _mm_andnot_ps(swap, r));
+
+				const __m128 negative = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(vx), 31));
+				r = _mm_or_ps(_mm_and_ps(negative, _mm_sub_ps(_mm_set1_ps(Pi), r)), _mm_andnot_ps(negative, r));
+
+				_mm_storeu_ps(out + i, _mm_or_ps(r, _mm_and_ps(vy, signBit)));
+			}
+
+			for (; i < n; i++) out[i] = FastATan2(y[i], x[i]);
+		}
+
+		VLK_COMMON_TARGET("avx2") inline void ATan2AVX2(const Float* y, const Float* x, Float* out, Size n)
+		{
+			using namespace FastMathConstants;
+			Size i = 0;
+
+			const __m256 signBit = _mm256_set1_ps(-0.0f);
+			for (; i + 8 <= n; i += 8)
+			{
+				const __m256 vy = _mm256_loadu_ps(y + i);
+				const __m256 vx = _mm256_loadu_ps(x + i);
+				const __m256 ax = _mm256_andnot_ps(signBit, vx);
+				const __m256 ay = _mm256_andnot_ps(signBit, vy);
+				const __m256 hi = _mm256_max_ps(ax, ay);
+
+				// 0 / 0 is NaN, and is masked to 0
+				const __m256 a = _mm256_and_ps(_mm256_div_ps(_mm256_min_ps(ax, ay), hi), _mm256_cmp_ps(hi, _mm256_setzero_ps(), _CMP_NEQ_OQ));
+				const __m256 s = _mm256_mul_ps(a, a);
+
+				__m256 p = _mm256_add_ps(_mm256_set1_ps(ATanP5), _mm256_mul_ps(s, _mm256_set1_ps(ATanP6)));
+				p = _mm256_add_ps(_mm256_set1_ps(ATanP4), _mm256_mul_ps(s, p));
+				p = _mm256_add_ps(_mm256_set1_ps(ATanP3), _mm256_mul_ps(s, p));
+				p = _mm256_add_ps(_mm256_set1_ps(ATanP2), _mm256_mul_ps(s, p));
+				p = _mm256_add_ps(_mm256_set1_ps(ATanP1), _mm256_mul_ps(s, p));
+				p = _mm256_add_ps(_mm256_set1_ps(ATanP0), _mm256_mul_ps(s, p));
+				__m256 r = _mm256_mul_ps(a, p);
+
+				r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(HalfPi), r), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+				r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(Pi), r), vx);
+
+				_mm256_storeu_ps(out + i, _mm256_or_ps(r, _mm256_and_ps(vy, signBit)));
+			}
+
+			for (; i < n; i++) out[i] = FastATan2(y[i], x[i]);
+		}
+
+		VLK_COMMON_TARGET("sse2") inline void ACosSSE2(const Float* in, Float* out, Size n)
+		{
+			using namespace FastMathConstants;
+			Size i = 0;
+
+			const __m128 signBit = _mm_set1_ps(-0.0f);
+			const __m128 one = _mm_set1_ps(1.0f);
+			for (; i + 4 <= n; i += 4)
+			{
+				const __m128 f = _mm_loadu_ps(in + i);
+
+				// min returns its second operand if either is NaN, so NaN is kept
+				const __m128 a = _mm_min_ps(one, _mm_andnot_ps(signBit, f));
+
+				__m128 p = _mm_add_ps(_mm_set1_ps(ACosP6), _mm_mul_ps(a, _mm_set1_ps(ACosP7)));
+				p = _mm_add_ps(_mm_set1_ps(ACosP5), _mm_mul_ps(a, p));
+				p = _mm_add_ps(_mm_set1_ps(ACosP4), _mm_mul_ps(a, p));
+				p = _mm_add_ps(_mm_set1_ps(ACosP3), _mm_mul_ps(a, p));
+				p = _mm_add_ps(_mm_set1_ps(ACosP2), _mm_mul_ps(a, p));
+				p = _mm_add_ps(_mm_set1_ps(ACosP1), _mm_mul_ps(a, p));
+				p = _mm_add_ps(_mm_set1_ps(ACosP0), _mm_mul_ps(a, p));
+				const __m128 r = _mm_mul_ps(p, _mm_sqrt_ps(_mm_sub_ps(one, a)));
+
+				const __m128 negative = _mm_cmplt_ps(f, _mm_setzero_ps());
+				_mm_storeu_ps(out + i, _mm_or_ps(_mm_and_ps(negative, _mm_sub_ps(_mm_set1_ps(Pi), r)), _mm_andnot_ps(negative, r)));
+			}
+
+			for (; i < n; i++) out[i] = FastACos(in[i]);
+		}
+
+		VLK_COMMON_TARGET("avx2") inline void ACosAVX2(const Float* in, Float* out, Size n)
+		{
+			using namespace FastMathConstants;
+			Size i = 0;
+
+			const __m256 signBit = _mm256_set1_ps(-0.0f);
+			const __m256 one = _mm256_set1_ps(1.0f);
+			for (; i + 8 <= n; i += 8)
+			{
+				const __m256 f = _mm256_loadu_ps(in + i);
+
+				// min returns its second operand if either is NaN, so NaN is kept
+				const __m256 a = _mm256_min_ps(one, _mm256_andnot_ps(signBit, f));
+
+				__m256 p = _mm256_add_ps(_mm256_set1_ps(ACosP6), _mm256_mul_ps(a, _mm256_set1_ps(ACosP7)));
+				p = _mm256_add_ps(_mm256_set1_ps(ACosP5), _mm256_mul_ps(a, p));
+				p = _mm256_add_ps(_mm256_set1_ps(ACosP4), _mm256_mul_ps(a, p));
+				p = _mm256_add_ps(_mm256_set1_ps(ACosP3), _mm256_mul_ps(a, p));
+				p = _mm256_add_ps(_mm256_set1_ps(ACosP2), _mm256_mul_ps(a, p));
+				p = _mm256_add_ps(_mm256_set1_ps(ACosP1), _mm256_mul_ps(a, p));
+				p = _mm256_add_ps(_mm256_set1_ps(ACosP0), _mm256_mul_ps(a, p));
+				const __m256 r = _mm256_mul_ps(p, _mm256_sqrt_ps(_mm256_sub_ps(one, a)));
+
+				const __m256 negative = _mm256_cmp_ps(f, _mm256_setzero_ps(), _CMP_LT_OQ);
+				_mm256_storeu_ps(out + i, _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(Pi), r), negative));
+			}
+
+			for (; i < n; i++) out[i] = FastACos(in[i]);
+		}
+		#endif
+	}
+
+	/*!
+	 * \brief Calculates the sine and cosine of every angle of an array.
+	 *
+	 * Equivalent to <tt>SinCos(angles[i], sines[i], cosines[i])</tt> for
+	 * every <tt>i</tt>. <tt>sines</tt> or <tt>cosines</tt> may be the same
+	 * array as <tt>angles</tt>.
+	 *
+	 * \param angles An array of <tt>n</tt> angles, measured in radians.
+	 * \param sines An array of at least <tt>n</tt> floats.
+	 * \param cosines An array of at least <tt>n</tt> floats.
+	 * \param n The number of angles.
+	 */
+	inline void SinCos(const Float* angles, Float* sines, Float* cosines, Size n)
+	{
+		#ifdef VLK_COMMON_RUNTIME_DISPATCH
+		switch (GetSIMDLevel())
+		{
+			case SIMDLevel::AVX512:
+			case SIMDLevel::AVX2: FastMathKernels::SinCosAVX2(angles, sines, cosines, n); return;
+			case SIMDLevel::SSE2: FastMathKernels::SinCosSSE2(angles, sines, cosines, n); return;
+			case SIMDLevel::Scalar: break;
+		}
+		#endif
+
+		for (Size i = 0; i < n; i++)
+		{
+			SinCos(angles[i], sines[i], cosines[i]);
+		}
+	}
+
+	/*!
+	 * \brief Calculates the arc tangent of every coordinate of two arrays.
+	 *
+	 * Equivalent to <tt>out[i] = FastATan2(y[i], x[i])</tt> for every
+	 * <tt>i</tt>. <tt>out</tt> may be the same array as <tt>y</tt> or
+	 * <tt>x</tt>.
+	 *
+	 * \param y An array of <tt>n</tt> y-coordinates.
+	 * \param x An array of <tt>n</tt> x-coordinates.
+	 * \param out An array of at least <tt>n</tt> floats.
+	 * \param n The number of coordinates.
+	 */
+	inline void FastATan2(const Float* y, const Float* x, Float* out, Size n)
+	{
+		#ifdef VLK_COMMON_RUNTIME_DISPATCH
+		switch (GetSIMDLevel())
+		{
+			case SIMDLevel::AVX512:
+			case SIMDLevel::AVX2: FastMathKernels::ATan2AVX2(y, x, out, n); return;
+			case SIMDLevel::SSE2: FastMathKernels::ATan2SSE2(y, x, out, n); return;
+			case SIMDLevel::Scalar: break;
+		}
+		#endif
+
+		for (Size i = 0; i < n; i++)
+		{
+			out[i] = FastATan2(y[i], x[i]);
+		}
+	}
+
+	/*!
+	 * \brief Calculates the arc cosine of every value of an array.
+	 *
+	 * Equivalent to <tt>out[i] = FastACos(in[i])</tt> for every <tt>i</tt>.
+	 * <tt>out</tt> may be the same array as <tt>in</tt>.
+	 *
+	 * \param in An array of <tt>n</tt> values.
+	 * \param out An array of at least <tt>n</tt> floats.
+	 * \param n The number of values.
+	 */
+	inline void FastACos(const Float* in, Float* out, Size n)
+	{
+		#ifdef VLK_COMMON_RUNTIME_DISPATCH
+		switch (GetSIMDLevel())
+		{
+			case SIMDLevel::AVX512:
+			case SIMDLevel::AVX2: FastMathKernels::ACosAVX2(in, out, n); return;
+			case SIMDLevel::SSE2: FastMathKernels::ACosSSE2(in, out, n); return;
+			case SIMDLevel::Scalar: break;
+		}
+		#endif
+
+		for (Size i = 0; i < n; i++)
+		{
+			out[i] = FastACos(in[i]);
+		}
+	}
+}
+
+#endif
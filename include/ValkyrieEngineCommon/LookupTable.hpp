@@ -0,0 +1,333 @@
+/*!
+ * \file LookupTable.hpp
+ * \brief Lookup tables of sampled functions, generated at compile time.
+ *
+ *	Tables are filled through the constexpr overloads in VMath.hpp, so their
+ *	samples are baked into the binary with no startup cost. Lookups
+ *	interpolate linearly between samples and never call into the standard
+ *	library, trading a small, documented amount of accuracy for speed on
+ *	targets where libm is slow or unavailable.
+ */
+
+#ifndef VLK_LOOKUP_TABLE_HPP
+#define VLK_LOOKUP_TABLE_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include "ValkyrieEngineCommon/ConstexprWrapper.hpp"
+#include "ValkyrieEngineCommon/VMath.hpp"
+#include <array>
+#include <utility>
+
+namespace vlk
+{
+	namespace LookupTableDetail
+	{
+		//! Position of sample <tt>i</tt> of <tt>n</tt> spread evenly over [lo, hi].
+		VLK_CXX14_CONSTEXPR inline Float SamplePosition(Size i, Size n, Float lo, Float hi)
+		{
+			return (i + 1 == n) ? hi : lo + (hi - lo) * (static_cast<Float>(i) / static_cast<Float>(n - 1));
+		}
+
+		template <Size N, typename Fn, Size... I>
+		VLK_CXX14_CONSTEXPR inline std::array<Float, N> MakeTable(Fn fn, Float lo, Float hi, std::index_sequence<I...>)
+		{
+			return {{ static_cast<Float>(fn(ForceCXPR(SamplePosition(I, N, lo, hi))))... }};
+		}
+	}
+
+	/*!
+	 * \brief Samples a function at <tt>N</tt> points spread evenly over
+	 * [lo, hi], both included.
+	 *
+	 * \param fn A function object or pointer to a constexpr function, called
+	 * with a ConstexprWrapper<Float> holding each position. Since it converts
+	 * to <tt>const Float&</tt>, functions taking a Float are accepted as well.
+	 * C++14 lambdas are not constexpr, so they may only be used at runtime.
+	 *
+	 * \code
+	 * struct Square
+	 * {
+	 *	constexpr Float operator()(Float x) const { return x * x; }
+	 * };
+	 *
+	 * constexpr std::array<Float, 16> squares = vlk::MakeTable<16>(Square(), 0.0f, 1.0f);
+	 * \endcode
+	 *
+	 * \sa vlk::MakeLookupTable()
+	 */
+	template <Size N, typename Fn>
+	VLK_CXX14_CONSTEXPR inline std::array<Float, N> MakeTable(Fn fn, Float lo, Float hi)
+	{
+		VLK_STATIC_ASSERT_MSG(N >= 2, "A table needs at least two samples.");
+		return LookupTableDetail::MakeTable<N>(fn, lo, hi, std::make_index_sequence<N>());
+	}
+
+	/*!
+	 * \brief A function sampled at <tt>N</tt> points over [lo, hi], evaluated
+	 * by interpolating linearly between samples.
+	 *
+	 * The error of linear interpolation is at most <tt>h * h * M / 8</tt>,
+	 * where <tt>h = (hi - lo) / (N - 1)</tt> is the distance between samples
+	 * and <tt>M</tt> bounds the magnitude of the second derivative of the
+	 * function. Quadrupling <tt>N</tt> therefore divides the error by about
+	 * 16.
+	 *
+	 * \ts
+	 * Every member may be called from any thread.<br>
+	 */
+	template <Size N>
+	class LookupTable
+	{
+		std::array<Float, N> samples;
+		Float lo;
+		Float hi;
+		bool periodic;
+
+		//! Samples per unit of input.
+		Float scale;
+
+		//! Periods per unit of input.
+		Float frequency;
+
+		public:
+		/*!
+		 * \param values Samples spread evenly over [low, high], such as those
+		 * returned by vlk::MakeTable().
+		 * \param low The input of the first sample.
+		 * \param high The input of the last sample.
+		 * \param wrap If true, inputs are wrapped into [low, high) instead of
+		 * clamped to [low, high], for functions repeating with a period of
+		 * <tt>high - low</tt>.
+		 */
+		VLK_CXX14_CONSTEXPR inline LookupTable(const std::array<Float, N>& values, Float low, Float high, bool wrap = false) :
+			samples(values),
+			lo(low),
+			hi(high),
+			periodic(wrap),
+			scale(static_cast<Float>(N - 1) / (high - low)),
+			frequency(1.0f / (high - low))
+		{ }
+
+		/*!
+		 * \brief Interpolates the sampled function at <tt>x</tt>.
+		 *
+		 * Inputs outside of [lo, hi] are wrapped or clamped, depending on
+		 * whether the table is periodic. <tt>NaN</tt> returns the first sample.
+		 */
+		VLK_CXX14_CONSTEXPR inline Float operator()(Float x) const
+		{
+			Float t = (x - lo) * scale;
+
+			if (periodic)
+			{
+				// Keeps only the fraction of a period, without floor, which is a library call on some targets.
+				// Floats beyond 2^23 periods have no fraction, so they land on the first sample.
+				Float u = (x - lo) * frequency;
+				u = (u > -8388608.0f && u < 8388608.0f) ? u - static_cast<Float>(static_cast<Long>(u)) : 0.0f;
+
+				// Truncation rounds negative fractions up to zero. Shifting into (0, 2) and truncating again
+				// moves them forward by a period without a branch, which mispredicts on angles of random sign.
+				u += 1.0f;
+				u -= static_cast<Float>(static_cast<Int>(u));
+				t = u * static_cast<Float>(N - 1);
+			}
+
+			if (!(t > 0.0f)) return samples[0];
+			if (t >= static_cast<Float>(N - 1)) return samples[N - 1];
+
+			const Int i = static_cast<Int>(t);
+			const Float f = t - static_cast<Float>(i);
+			return samples[i] + f * (samples[i + 1] - samples[i]);
+		}
+
+		//! Returns the samples of the table.
+		VLK_CXX14_CONSTEXPR inline const std::array<Float, N>& Samples() const { return samples; }
+
+		//! Returns the lowest sampled input.
+		VLK_CXX14_CONSTEXPR inline Float Lo() const { return lo; }
+
+		//! Returns the highest sampled input.
+		VLK_CXX14_CONSTEXPR inline Float Hi() const { return hi; }
+
+		//! Returns true if inputs outside of [lo, hi] are wrapped rather than clamped.
+		VLK_CXX14_CONSTEXPR inline bool IsPeriodic() const { return periodic; }
+	};
+
+	/*!
+	 * \brief Samples a function at <tt>N</tt> points over [lo, hi] into a
+	 * lookup table.
+	 *
+	 * \copydetails vlk::MakeTable()
+	 */
+	template <Size N, typename Fn>
+	VLK_CXX14_CONSTEXPR inline LookupTable<N> MakeLookupTable(Fn fn, Float lo, Float hi, bool periodic = false)
+	{
+		return LookupTable<N>(MakeTable<N>(fn, lo, hi), lo, hi, periodic);
+	}
+
+	/*!
+	 * \brief Functions that may be sampled into a lookup table at compile
+	 * time.
+	 *
+	 * Each evaluates through the constexpr overloads of VMath.hpp, which are
+	 * slow at runtime; sample them into a table instead of calling them
+	 * directly.
+	 */
+	namespace TableFunctions
+	{
+		struct Sin
+		{
+			VLK_CXX14_CONSTEXPR inline Float operator()(ConstexprWrapper<Float> x) const { return vlk::Sin(x); }
+		};
+
+		struct Cos
+		{
+			VLK_CXX14_CONSTEXPR inline Float operator()(ConstexprWrapper<Float> x) const { return vlk::Cos(x); }
+		};
+	}
+
+	/*!
+	 * \brief Easing curves mapping a time in [0, 1] to a progress, with
+	 * <tt>f(0) = 0</tt> and <tt>f(1) = 1</tt>.
+	 *
+	 * Curves are constexpr, and meant to be sampled into an EasingTable.
+	 */
+	namespace Easing
+	{
+		//! Accelerates from and decelerates to rest along a cosine.
+		struct InOutSine
+		{
+			VLK_CXX14_CONSTEXPR inline Float operator()(ConstexprWrapper<Float> t) const
+			{
+				return (1.0f - static_cast<Float>(vlk::Cos(ForceCXPR(Pi * t)))) / 2.0f;
+			}
+		};
+
+		//! Starts slowly and accelerates exponentially.
+		struct InExpo
+		{
+			VLK_CXX14_CONSTEXPR inline Float operator()(ConstexprWrapper<Float> t) const
+			{
+				return (t.value <= 0.0f) ? 0.0f : static_cast<Float>(vlk::Pow(ForceCXPR(2.0f), ForceCXPR(10.0f * t - 10.0f)));
+			}
+		};
+
+		//! Starts quickly and decelerates exponentially.
+		struct OutExpo
+		{
+			VLK_CXX14_CONSTEXPR inline Float operator()(ConstexprWrapper<Float> t) const
+			{
+				return (t.value >= 1.0f) ? 1.0f : 1.0f - static_cast<Float>(vlk::Pow(ForceCXPR(2.0f), ForceCXPR(-10.0f * t)));
+			}
+		};
+
+		//! Overshoots the end and oscillates back to it, like a spring.
+		struct OutElastic
+		{
+			VLK_CXX14_CONSTEXPR inline Float operator()(ConstexprWrapper<Float> t) const
+			{
+				if (t.value <= 0.0f) return 0.0f;
+				if (t.value >= 1.0f) return 1.0f;
+
+				const Float decay = vlk::Pow(ForceCXPR(2.0f), ForceCXPR(-10.0f * t));
+				return decay * static_cast<Float>(vlk::Sin(ForceCXPR((10.0f * t - 0.75f) * (TwoPi / 3.0f)))) + 1.0f;
+			}
+		};
+
+		//! Bounces off the end a few times before coming to rest on it.
+		struct OutBounce
+		{
+			VLK_CXX14_CONSTEXPR inline Float operator()(ConstexprWrapper<Float> time) const
+			{
+				const Float n = 7.5625f;
+				const Float d = 2.75f;
+				Float t = time;
+
+				if (t < 1.0f / d) return n * t * t;
+				if (t < 2.0f / d)
+				{
+					t -= 1.5f / d;
+					return n * t * t + 0.75f;
+				}
+				if (t < 2.5f / d)
+				{
+					t -= 2.25f / d;
+					return n * t * t + 0.9375f;
+				}
+
+				t -= 2.625f / d;
+				return n * t * t + 0.984375f;
+			}
+		};
+	}
+
+	namespace LookupTableDetail
+	{
+		// Static data members of class templates have external linkage, so
+		// every translation unit shares one copy of each table. A constexpr
+		// variable template at namespace scope would be internal, and copied
+		// into each translation unit using it.
+		template <Size N>
+		struct SinTableStorage
+		{
+			static VLK_CXX14_CONSTEXPR LookupTable<N> table = MakeLookupTable<N>(TableFunctions::Sin(), 0.0f, TwoPi, true);
+		};
+
+		template <Size N>
+		VLK_CXX14_CONSTEXPR LookupTable<N> SinTableStorage<N>::table;
+
+		template <Size N>
+		struct CosTableStorage
+		{
+			static VLK_CXX14_CONSTEXPR LookupTable<N> table = MakeLookupTable<N>(TableFunctions::Cos(), 0.0f, TwoPi, true);
+		};
+
+		template <Size N>
+		VLK_CXX14_CONSTEXPR LookupTable<N> CosTableStorage<N>::table;
+
+		template <typename Curve, Size N>
+		struct EasingTableStorage
+		{
+			static VLK_CXX14_CONSTEXPR LookupTable<N> table = MakeLookupTable<N>(Curve(), 0.0f, 1.0f);
+		};
+
+		template <typename Curve, Size N>
+		VLK_CXX14_CONSTEXPR LookupTable<N> EasingTableStorage<Curve, N>::table;
+	}
+
+	/*!
+	 * \brief Sine of any angle, in radians, sampled at <tt>N</tt> points over
+	 * one period.
+	 *
+	 * Maximum absolute error is 7.6e-5 with the default of 256 samples and
+	 * 4.7e-6 with 1024, plus the error of wrapping large angles.
+	 *
+	 * \code
+	 * Float s = vlk::SinTable<>(angle);
+	 * \endcode
+	 */
+	template <Size N = 256>
+	VLK_CXX14_CONSTEXPR const LookupTable<N>& SinTable = LookupTableDetail::SinTableStorage<N>::table;
+
+	/*!
+	 * \brief Cosine of any angle, in radians, sampled at <tt>N</tt> points
+	 * over one period.
+	 *
+	 * \copydetails vlk::SinTable
+	 */
+	template <Size N = 256>
+	VLK_CXX14_CONSTEXPR const LookupTable<N>& CosTable = LookupTableDetail::CosTableStorage<N>::table;
+
+	/*!
+	 * \brief An easing curve from vlk::Easing sampled at <tt>N</tt> points
+	 * over [0, 1]. Times outside of it are clamped.
+	 *
+	 * \code
+	 * Float progress = vlk::EasingTable<vlk::Easing::OutBounce>(time);
+	 * \endcode
+	 */
+	template <typename Curve, Size N = 256>
+	VLK_CXX14_CONSTEXPR const LookupTable<N>& EasingTable = LookupTableDetail::EasingTableStorage<Curve, N>::table;
+}
+
+#endif
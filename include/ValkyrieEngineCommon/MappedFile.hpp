@@ -0,0 +1,161 @@
+/*!
+ * \file MappedFile.hpp
+ * \brief Read-only memory-mapped files.
+ */
+
+#ifndef VLK_MAPPED_FILE_HPP
+#define VLK_MAPPED_FILE_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vlk
+{
+	/*!
+	 * \brief A read-only view of the contents of a file, mapped into memory.
+	 *
+	 * Pages are read from the disk when first accessed and are shared with
+	 * the operating system's file cache, so mapping a file neither copies it
+	 * nor allocates heap memory for it.
+	 *
+	 * The file should not be modified while it is mapped.
+	 */
+	class MappedFile
+	{
+		const UByte* data;
+		Size size;
+		bool open;
+
+		inline void Close()
+		{
+			if (data != nullptr)
+			{
+#ifdef _WIN32
+				UnmapViewOfFile(data);
+#else
+				munmap(const_cast<UByte*>(data), size);
+#endif
+			}
+
+			data = nullptr;
+			size = 0;
+			open = false;
+		}
+
+		public:
+		//! Constructs a MappedFile that does not refer to any file.
+		inline MappedFile() : data(nullptr), size(0), open(false) { }
+
+		/*!
+		 * \brief Maps a file into memory.
+		 *
+		 * If the file can not be opened or mapped, IsOpen() returns false.
+		 *
+		 * \param path Path to the file.
+		 */
+		inline explicit MappedFile(const std::string& path) : data(nullptr), size(0), open(false)
+		{
+#ifdef _WIN32
+			HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) return;
+
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(file, &fileSize))
+			{
+				CloseHandle(file);
+				return;
+			}
+
+			size = static_cast<Size>(fileSize.QuadPart);
+			if (size > 0)
+			{
+				HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (mapping != nullptr)
+				{
+					data = static_cast<const UByte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+					CloseHandle(mapping);
+				}
+			}
+
+			CloseHandle(file);
+#else
+			const int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0) return;
+
+			struct stat st;
+			if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+			{
+				::close(fd);
+				return;
+			}
+
+			size = static_cast<Size>(st.st_size);
+			if (size > 0)
+			{
+				void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (p != MAP_FAILED) data = static_cast<const UByte*>(p);
+			}
+
+			// The mapping keeps its own reference to the file
+			::close(fd);
+#endif
+
+			// Empty files can not be mapped, but open successfully with no data
+			open = (size == 0) || (data != nullptr);
+			if (!open) size = 0;
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		inline MappedFile(MappedFile&& other) : data(other.data), size(other.size), open(other.open)
+		{
+			other.data = nullptr;
+			other.size = 0;
+			other.open = false;
+		}
+
+		inline MappedFile& operator=(MappedFile&& other)
+		{
+			if (this != &other)
+			{
+				Close();
+				std::swap(data, other.data);
+				std::swap(size, other.size);
+				std::swap(open, other.open);
+			}
+
+			return *this;
+		}
+
+		//! Unmaps the file.
+		inline ~MappedFile() { Close(); }
+
+		//! Returns true if the file was mapped successfully.
+		inline bool IsOpen() const { return open; }
+
+		//! Returns a pointer to the first byte of the file, or nullptr if the file is empty or not open.
+		inline const UByte* Data() const { return data; }
+
+		//! Returns the size of the file in bytes.
+		inline Size Length() const { return size; }
+	};
+}
+
+#endif
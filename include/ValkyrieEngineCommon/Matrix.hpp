@@ -7,6 +7,20 @@
 #include <limits>
 #include <type_traits>
 
+/*!
+ * \brief Smallest size of square MatrixBase for which Determinant() and
+ * Inverse() use LU decomposition instead of cofactor expansion.
+ *
+ * Only applies to floating point matrices, since elimination divides
+ * between elements. Other types always use cofactor expansion.
+ *
+ * Cofactor expansion grows factorially with the size of the matrix and LU
+ * decomposition grows cubically. May be defined before including this header.
+ */
+#ifndef VLK_COMMON_LU_THRESHOLD
+#define VLK_COMMON_LU_THRESHOLD 4
+#endif
+
 namespace vlk
 {
 	template <Size N, Size M, typename Val>
@@ -18,6 +32,30 @@ namespace vlk
 		typedef ColType DataType[N];
 		DataType data;
 
+		/*!
+		 * \brief LU decomposition of a square matrix with partial pivoting.
+		 *
+		 * Represents <tt>P * A = L * U</tt>, where <tt>P</tt> is a row
+		 * permutation, <tt>L</tt> is lower triangular with a unit diagonal and
+		 * <tt>U</tt> is upper triangular.
+		 *
+		 * \sa vlk::MatrixBase::Decompose() const
+		 */
+		struct LUDecomposition
+		{
+			/*!
+			 * \brief <tt>L</tt> and <tt>U</tt> packed into a single column-major
+			 * matrix. The unit diagonal of <tt>L</tt> is not stored.
+			 */
+			DataType lu;
+
+			//! Row <tt>i</tt> of <tt>P * A</tt> is row <tt>permutation[i]</tt> of <tt>A</tt>.
+			VectorBase<N, Size> permutation;
+
+			//! Parity of the permutation, or zero if the matrix is singular.
+			Val sign;
+		};
+
 		VLK_STATIC_ASSERT_MSG(std::is_arithmetic<Val>::value, "Val must be an arithmetic type");
 
 		VLK_CXX14_CONSTEXPR inline MatrixBase<N, M, Val>()
@@ -298,7 +336,7 @@ namespace vlk
 			return data[0][0] * data[1][1] - data[0][1] * data[1][0];
 		}
 
-		template <typename..., Size X = N, Size Y = M, std::enable_if_t<(X == Y) & (X > 2), Int> = 3>
+		template <typename..., Size X = N, Size Y = M, std::enable_if_t<(X == Y) & (X > 2) & ((X < VLK_COMMON_LU_THRESHOLD) | !std::is_floating_point<Val>::value), Int> = 3>
 		VLK_CXX14_CONSTEXPR inline Val Determinant() const
 		{
 			VLK_CXX14_CONSTEXPR Size S = X;
@@ -333,6 +371,12 @@ namespace vlk
 			return det;
 		}
 
+		template <typename..., Size X = N, Size Y = M, std::enable_if_t<(X == Y) & (X > 2) & (X >= VLK_COMMON_LU_THRESHOLD) & std::is_floating_point<Val>::value, Int> = 4>
+		VLK_CXX14_CONSTEXPR inline Val Determinant() const
+		{
+			return Determinant(Decompose());
+		}
+
 		/*!
 		 * \brief Returns the inverse of a matrix such that <tt>mat * mat.Inverse()</tt> is an identity matrix.
 		 *
@@ -367,7 +411,7 @@ namespace vlk
 			return SelfType({(*this) * (1.0 / data.Determinant())});
 		}
 
-		template <typename..., Size X = N, Size Y = M, std::enable_if_t<(X == Y) & (X > 2), Int> = 3>
+		template <typename..., Size X = N, Size Y = M, std::enable_if_t<(X == Y) & (X > 2) & ((X < VLK_COMMON_LU_THRESHOLD) | !std::is_floating_point<Val>::value), Int> = 3>
 		VLK_CXX14_CONSTEXPR inline SelfType Inverse() const
 		{
 			SelfType minors;
@@ -428,6 +472,155 @@ namespace vlk
 
 			return mat * (1.0 / determinant);
 		}
+
+		template <typename..., Size X = N, Size Y = M, std::enable_if_t<(X == Y) & (X > 2) & (X >= VLK_COMMON_LU_THRESHOLD) & std::is_floating_point<Val>::value, Int> = 4>
+		VLK_CXX14_CONSTEXPR inline SelfType Inverse() const
+		{
+			return Inverse(Decompose());
+		}
+
+		/*!
+		 * \brief Computes the LU decomposition of a square matrix using
+		 * Gaussian elimination with partial pivoting.
+		 *
+		 * The decomposition can be reused to calculate the determinant and
+		 * inverse of the matrix and to solve any number of linear systems in
+		 * <tt>O(N^2)</tt> each.
+		 *
+		 * \sa vlk::MatrixBase::Solve(const LUDecomposition&, const ColType&)
+		 */
+		template <typename..., Size X = N, Size Y = M, std::enable_if_t<X == Y, Int> = 0>
+		VLK_CXX14_CONSTEXPR inline LUDecomposition Decompose() const
+		{
+			LUDecomposition d {};
+			d.sign = static_cast<Val>(1);
+
+			for (Size n = 0; n < N; n++)
+			{
+				d.lu[n] = data[n];
+				d.permutation[n] = n;
+			}
+
+			for (Size k = 0; k < N; k++)
+			{
+				// Find the row with the largest magnitude in column k
+				Size pivot = k;
+				Val largest = d.lu[k][k] < 0 ? -d.lu[k][k] : d.lu[k][k];
+
+				for (Size r = k + 1; r < N; r++)
+				{
+					Val v = d.lu[k][r] < 0 ? -d.lu[k][r] : d.lu[k][r];
+					if (v > largest)
+					{
+						largest = v;
+						pivot = r;
+					}
+				}
+
+				if (largest == static_cast<Val>(0))
+				{
+					d.sign = static_cast<Val>(0);
+					continue;
+				}
+
+				if (pivot != k)
+				{
+					for (Size c = 0; c < N; c++)
+					{
+						Val tmp = d.lu[c][k];
+						d.lu[c][k] = d.lu[c][pivot];
+						d.lu[c][pivot] = tmp;
+					}
+
+					Size tmp = d.permutation[k];
+					d.permutation[k] = d.permutation[pivot];
+					d.permutation[pivot] = tmp;
+					d.sign = -d.sign;
+				}
+
+				for (Size r = k + 1; r < N; r++)
+				{
+					const Val f = d.lu[k][r] / d.lu[k][k];
+					d.lu[k][r] = f;
+
+					for (Size c = k + 1; c < N; c++)
+					{
+						d.lu[c][r] -= f * d.lu[c][k];
+					}
+				}
+			}
+
+			return d;
+		}
+
+		/*!
+		 * \brief Returns the determinant of a decomposed matrix.
+		 */
+		static VLK_CXX14_CONSTEXPR inline Val Determinant(const LUDecomposition& d)
+		{
+			Val det = d.sign;
+			for (Size n = 0; n < N; n++) det *= d.lu[n][n];
+			return det;
+		}
+
+		/*!
+		 * \brief Solves <tt>A * x = b</tt> for <tt>x</tt>, given the decomposition of <tt>A</tt>.
+		 *
+		 * If <tt>A</tt> is singular, the returned vector will contain infinite or <tt>NaN</tt> values.
+		 */
+		static VLK_CXX14_CONSTEXPR inline ColType Solve(const LUDecomposition& d, const ColType& b)
+		{
+			ColType x;
+
+			// Forward substitution, L * y = P * b
+			for (Size r = 0; r < N; r++)
+			{
+				Val sum = b[d.permutation[r]];
+				for (Size c = 0; c < r; c++) sum -= d.lu[c][r] * x[c];
+				x[r] = sum;
+			}
+
+			// Back substitution, U * x = y
+			for (Size r = N; r-- > 0;)
+			{
+				Val sum = x[r];
+				for (Size c = r + 1; c < N; c++) sum -= d.lu[c][r] * x[c];
+				x[r] = sum / d.lu[r][r];
+			}
+
+			return x;
+		}
+
+		/*!
+		 * \brief Solves <tt>A * x = b</tt> for <tt>x</tt>, where <tt>A</tt> is this matrix.
+		 *
+		 * Decomposes the matrix on every call. Use Decompose() and
+		 * Solve(const LUDecomposition&, const ColType&) when solving multiple
+		 * systems with the same matrix.
+		 */
+		template <typename..., Size X = N, Size Y = M, std::enable_if_t<X == Y, Int> = 0>
+		VLK_CXX14_CONSTEXPR inline ColType Solve(const ColType& b) const
+		{
+			return Solve(Decompose(), b);
+		}
+
+		/*!
+		 * \brief Returns the inverse of a decomposed matrix.
+		 */
+		static VLK_CXX14_CONSTEXPR inline SelfType Inverse(const LUDecomposition& d)
+		{
+			SelfType mat;
+
+			// Column n of the inverse solves A * x = e_n
+			for (Size n = 0; n < N; n++)
+			{
+				ColType e;
+				e[n] = static_cast<Val>(1);
+				mat[n] = Solve(d, e);
+			}
+
+			return mat;
+		}
 	};
 
 	/*!
@@ -741,6 +934,17 @@ namespace vlk
 		typedef DataType::ColType ColType;
 		DataType data;
 
+		#ifdef VLK_COMMON_SSE2
+		//! Multiplies the columns <tt>c0</tt> to <tt>c3</tt> of a matrix by the vector <tt>v</tt>.
+		static inline __m128 MultiplySSE(__m128 c0, __m128 c1, __m128 c2, __m128 c3, __m128 v)
+		{
+			__m128 r = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+			r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+			r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+			return _mm_add_ps(r, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+		}
+		#endif
+
 		public:
 
 		/*!
@@ -966,31 +1170,232 @@ namespace vlk
 
 		/*!
 		 * \brief multiplies a matrix by a vector
+		 *
+		 * Unrolled, and vectorized at runtime when SSE2 is available.
+		 *
+		 * \sa vlk::Matrix4::TransformPoints(const Vector4*, Vector4*, Size) const
 		 */
 		VLK_CXX14_CONSTEXPR inline Vector4 operator*(const Vector4& rhs) const
 		{
-			return Vector4(data * ColType({rhs[0], rhs[1], rhs[2], rhs[3]}));
+			#ifdef VLK_COMMON_SSE2
+			if (!VLK_IS_CONSTANT_EVALUATED())
+			{
+				Vector4 out;
+				_mm_store_ps(out.Data(), MultiplySSE(
+					data[0].ToSSE(), data[1].ToSSE(), data[2].ToSSE(), data[3].ToSSE(),
+					_mm_load_ps(rhs.Data())));
+				return out;
+			}
+			#endif
+
+			return Vector4(
+				data[0][0] * rhs[0] + data[1][0] * rhs[1] + data[2][0] * rhs[2] + data[3][0] * rhs[3],
+				data[0][1] * rhs[0] + data[1][1] * rhs[1] + data[2][1] * rhs[2] + data[3][1] * rhs[3],
+				data[0][2] * rhs[0] + data[1][2] * rhs[1] + data[2][2] * rhs[2] + data[3][2] * rhs[3],
+				data[0][3] * rhs[0] + data[1][3] * rhs[1] + data[2][3] * rhs[2] + data[3][3] * rhs[3]);
 		}
 
 		/*!
 		 * \brief multiplies two matricies
+		 *
+		 * Unrolled, and vectorized at runtime when SSE2 is available. With AVX
+		 * two columns of the result are computed at once. Every code path sums
+		 * in the same order, so results equal those of MatrixBase up to the
+		 * sign of zero results, since MatrixBase starts each sum from +0, and
+		 * up to floating-point contraction, if the compiler fuses the scalar
+		 * multiply-adds.
 		 */
 		VLK_CXX14_CONSTEXPR inline Matrix4 operator*(const Matrix4& rhs) const
 		{
-			return data * rhs.data;
+			#if defined(VLK_COMMON_AVX)
+			if (!VLK_IS_CONSTANT_EVALUATED())
+			{
+				Matrix4 out;
+				const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(data[0].Data()));
+				const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(data[1].Data()));
+				const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(data[2].Data()));
+				const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(data[3].Data()));
+
+				// Columns are contiguous, so one 256-bit register holds two of them
+				for (Size c = 0; c < 4; c += 2)
+				{
+					const __m256 v = _mm256_loadu_ps(rhs.data[c].Data());
+					__m256 r = _mm256_mul_ps(c0, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+					r = _mm256_add_ps(r, _mm256_mul_ps(c1, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+					r = _mm256_add_ps(r, _mm256_mul_ps(c2, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+					r = _mm256_add_ps(r, _mm256_mul_ps(c3, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+					_mm256_storeu_ps(out.data[c].Data(), r);
+				}
+
+				return out;
+			}
+			#elif defined(VLK_COMMON_SSE2)
+			if (!VLK_IS_CONSTANT_EVALUATED())
+			{
+				Matrix4 out;
+				const __m128 c0 = data[0].ToSSE();
+				const __m128 c1 = data[1].ToSSE();
+				const __m128 c2 = data[2].ToSSE();
+				const __m128 c3 = data[3].ToSSE();
+
+				for (Size c = 0; c < 4; c++)
+				{
+					_mm_store_ps(out.data[c].Data(), MultiplySSE(c0, c1, c2, c3, rhs.data[c].ToSSE()));
+				}
+
+				return out;
+			}
+			#endif
+
+			DataType tmp;
+			for (Size c = 0; c < 4; c++)
+			{
+				const ColType& r = rhs.data[c];
+				for (Size i = 0; i < 4; i++)
+				{
+					tmp[c][i] = data[0][i] * r[0] + data[1][i] * r[1] + data[2][i] * r[2] + data[3][i] * r[3];
+				}
+			}
+
+			return Matrix4(tmp);
+		}
+
+		/*!
+		 * \brief Multiplies <tt>n</tt> vectors by this matrix.
+		 *
+		 * Equivalent to <tt>out[i] = m * in[i]</tt> for every <tt>i</tt>, but
+		 * keeps the columns of the matrix in registers for the whole batch.
+		 * <tt>in</tt> and <tt>out</tt> may be the same array, but must not
+		 * otherwise overlap.
+		 *
+		 * \param in Array of <tt>n</tt> vectors to transform
+		 * \param out Array of <tt>n</tt> vectors to write the results to
+		 * \param n Number of vectors to transform
+		 */
+		inline void TransformPoints(const Vector4* in, Vector4* out, Size n) const
+		{
+			#ifdef VLK_COMMON_SSE2
+			const __m128 c0 = data[0].ToSSE();
+			const __m128 c1 = data[1].ToSSE();
+			const __m128 c2 = data[2].ToSSE();
+			const __m128 c3 = data[3].ToSSE();
+
+			for (Size i = 0; i < n; i++)
+			{
+				_mm_store_ps(out[i].Data(), MultiplySSE(c0, c1, c2, c3, _mm_load_ps(in[i].Data())));
+			}
+			#else
+			for (Size i = 0; i < n; i++)
+			{
+				out[i] = *this * in[i];
+			}
+			#endif
 		}
 
 		/*!
 		 * \brief Returns the inverse of this matrix so that <tt>m * !m</tt> is an identity matrix
+		 *
+		 * Uses a closed-form expansion over the twelve 2x2 sub-determinants of
+		 * the matrix rather than the generic cofactor expansion of MatrixBase.
+		 *
+		 * \sa vlk::Matrix4::InverseAffine() const
 		 */
 		VLK_CXX14_CONSTEXPR inline Matrix4 operator!() const
 		{
-			return data.Inverse();
+			// Treats data[i][j] as row i, column j. This inverts the transpose
+			// of the matrix, and writing the result back the same way transposes
+			// it again, as inverse(transpose(m)) == transpose(inverse(m)).
+			const Float s0 = data[0][0] * data[1][1] - data[1][0] * data[0][1];
+			const Float s1 = data[0][0] * data[1][2] - data[1][0] * data[0][2];
+			const Float s2 = data[0][0] * data[1][3] - data[1][0] * data[0][3];
+			const Float s3 = data[0][1] * data[1][2] - data[1][1] * data[0][2];
+			const Float s4 = data[0][1] * data[1][3] - data[1][1] * data[0][3];
+			const Float s5 = data[0][2] * data[1][3] - data[1][2] * data[0][3];
+
+			const Float c5 = data[2][2] * data[3][3] - data[3][2] * data[2][3];
+			const Float c4 = data[2][1] * data[3][3] - data[3][1] * data[2][3];
+			const Float c3 = data[2][1] * data[3][2] - data[3][1] * data[2][2];
+			const Float c2 = data[2][0] * data[3][3] - data[3][0] * data[2][3];
+			const Float c1 = data[2][0] * data[3][2] - data[3][0] * data[2][2];
+			const Float c0 = data[2][0] * data[3][1] - data[3][0] * data[2][1];
+
+			const Float inv = 1.0f / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+			DataType m;
+
+			m[0][0] = ( data[1][1] * c5 - data[1][2] * c4 + data[1][3] * c3) * inv;
+			m[0][1] = (-data[0][1] * c5 + data[0][2] * c4 - data[0][3] * c3) * inv;
+			m[0][2] = ( data[3][1] * s5 - data[3][2] * s4 + data[3][3] * s3) * inv;
+			m[0][3] = (-data[2][1] * s5 + data[2][2] * s4 - data[2][3] * s3) * inv;
+
+			m[1][0] = (-data[1][0] * c5 + data[1][2] * c2 - data[1][3] * c1) * inv;
+			m[1][1] = ( data[0][0] * c5 - data[0][2] * c2 + data[0][3] * c1) * inv;
+			m[1][2] = (-data[3][0] * s5 + data[3][2] * s2 - data[3][3] * s1) * inv;
+			m[1][3] = ( data[2][0] * s5 - data[2][2] * s2 + data[2][3] * s1) * inv;
+
+			m[2][0] = ( data[1][0] * c4 - data[1][1] * c2 + data[1][3] * c0) * inv;
+			m[2][1] = (-data[0][0] * c4 + data[0][1] * c2 - data[0][3] * c0) * inv;
+			m[2][2] = ( data[3][0] * s4 - data[3][1] * s2 + data[3][3] * s0) * inv;
+			m[2][3] = (-data[2][0] * s4 + data[2][1] * s2 - data[2][3] * s0) * inv;
+
+			m[3][0] = (-data[1][0] * c3 + data[1][1] * c1 - data[1][2] * c0) * inv;
+			m[3][1] = ( data[0][0] * c3 - data[0][1] * c1 + data[0][2] * c0) * inv;
+			m[3][2] = (-data[3][0] * s3 + data[3][1] * s1 - data[3][2] * s0) * inv;
+			m[3][3] = ( data[2][0] * s3 - data[2][1] * s1 + data[2][2] * s0) * inv;
+
+			return Matrix4(m);
+		}
+
+		/*!
+		 * \brief Returns the inverse of an affine transformation matrix.
+		 *
+		 * Faster than <tt>operator!</tt> for matrices composed only of
+		 * translations, rotations, scales, reflections and shears, such as those
+		 * returned by vlk::Transform3D::GetMatrix(). Inverts the upper 3x3 block
+		 * and applies the inverse to the translation column.
+		 *
+		 * \warning The result is undefined if the bottom row of this matrix is
+		 * not <tt>(0, 0, 0, 1)</tt>.
+		 */
+		VLK_CXX14_CONSTEXPR inline Matrix4 InverseAffine() const
+		{
+			// Rows of the inverse of the upper 3x3 block are the cross products of
+			// its columns, divided by the determinant.
+			const Vector3 c0(data[0][0], data[0][1], data[0][2]);
+			const Vector3 c1(data[1][0], data[1][1], data[1][2]);
+			const Vector3 c2(data[2][0], data[2][1], data[2][2]);
+			const Vector3 t(data[3][0], data[3][1], data[3][2]);
+
+			const Vector3 r0(Vector3::Cross(c1, c2));
+			const Vector3 r1(Vector3::Cross(c2, c0));
+			const Vector3 r2(Vector3::Cross(c0, c1));
+
+			const Float inv = 1.0f / Vector3::Dot(c0, r0);
+
+			return Matrix4(
+				r0[0] * inv, r0[1] * inv, r0[2] * inv, -Vector3::Dot(r0, t) * inv,
+				r1[0] * inv, r1[1] * inv, r1[2] * inv, -Vector3::Dot(r1, t) * inv,
+				r2[0] * inv, r2[1] * inv, r2[2] * inv, -Vector3::Dot(r2, t) * inv,
+				0.0f,        0.0f,        0.0f,         1.0f);
 		}
 
 		VLK_CXX14_CONSTEXPR inline Float Determinant() const
 		{
-			return data.Determinant();
+			const Float s0 = data[0][0] * data[1][1] - data[1][0] * data[0][1];
+			const Float s1 = data[0][0] * data[1][2] - data[1][0] * data[0][2];
+			const Float s2 = data[0][0] * data[1][3] - data[1][0] * data[0][3];
+			const Float s3 = data[0][1] * data[1][2] - data[1][1] * data[0][2];
+			const Float s4 = data[0][1] * data[1][3] - data[1][1] * data[0][3];
+			const Float s5 = data[0][2] * data[1][3] - data[1][2] * data[0][3];
+
+			const Float c5 = data[2][2] * data[3][3] - data[3][2] * data[2][3];
+			const Float c4 = data[2][1] * data[3][3] - data[3][1] * data[2][3];
+			const Float c3 = data[2][1] * data[3][2] - data[3][1] * data[2][2];
+			const Float c2 = data[2][0] * data[3][3] - data[3][0] * data[2][3];
+			const Float c1 = data[2][0] * data[3][2] - data[3][0] * data[2][2];
+			const Float c0 = data[2][0] * data[3][1] - data[3][0] * data[2][1];
+
+			return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
 		}
 
 		VLK_CXX14_CONSTEXPR inline Matrix4 Transpose() const
@@ -1163,8 +1568,8 @@ namespace vlk
 
 			return ForceCXPR(Matrix4(
 				 t * x * x + cosA,     t * x * y - z * sinA, t * x * z + y * sinA, 0.0f,
-				 t * x * y + z * sinA, t * y * y + cosA,     t * y * z + x * sinA, 0.0f,
-				 t * x * z + y * sinA, t * y * z + x * sinA, t * z * z + cosA,     0.0f,
+				 t * x * y + z * sinA, t * y * y + cosA,     t * y * z - x * sinA, 0.0f,
+				 t * x * z - y * sinA, t * y * z + x * sinA, t * z * z + cosA,     0.0f,
 				 0.0f,                 0.0f,                 0.0f,                 1.0f ));
 		}
 
@@ -1173,7 +1578,7 @@ namespace vlk
 		 *
 		 * \remark Constexpr-compatible overload. Do not use in runtime code.
 		 */
-		static inline ConstexprWrapper<Matrix4> CreateRotation(ConstexprWrapper<Float> angle, ConstexprWrapper<Vector3> axis)
+		static VLK_CXX14_CONSTEXPR inline ConstexprWrapper<Matrix4> CreateRotation(ConstexprWrapper<Float> angle, ConstexprWrapper<Vector3> axis)
 		{
 			Float cosA = Cos(angle);
 			Float sinA = Sin(angle);
@@ -1184,8 +1589,8 @@ namespace vlk
 
 			return ForceCXPR(Matrix4(
 				 t * x * x + cosA,     t * x * y - z * sinA, t * x * z + y * sinA, 0.0f,
-				 t * x * y + z * sinA, t * y * y + cosA,     t * y * z + x * sinA, 0.0f,
-				 t * x * z + y * sinA, t * y * z + x * sinA, t * z * z + cosA,     0.0f,
+				 t * x * y + z * sinA, t * y * y + cosA,     t * y * z - x * sinA, 0.0f,
+				 t * x * z - y * sinA, t * y * z + x * sinA, t * z * z + cosA,     0.0f,
 				 0.0f,                 0.0f,                 0.0f,                 1.0f ));
 		}
 
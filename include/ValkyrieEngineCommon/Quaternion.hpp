@@ -7,6 +7,7 @@
 #define VLK_QUATERNION_HPP
 
 #include "ValkyrieEngineCommon/Vector.hpp"
+#include <limits>
 #include <type_traits>
 
 namespace vlk
@@ -15,6 +16,9 @@ namespace vlk
 	{
 		// Ordered XYZW
 		VectorBase<4, Float> data;
+
+		VLK_CXX14_CONSTEXPR inline explicit Quaternion(const VectorBase<4, Float>& d) : data(d) { }
+
 		public:
 
 		VLK_CXX14_CONSTEXPR inline Float& X() { return data[0]; }
@@ -51,6 +55,110 @@ namespace vlk
 				W() * rhs.W() - X() * rhs.X() - Y() * rhs.Y() - Z() * rhs.Z());
 		}
 
+		/*!
+		 * \brief Returns the dot product of two quaternions.
+		 */
+		static VLK_CXX14_CONSTEXPR inline Float Dot(const Quaternion& lhs, const Quaternion& rhs)
+		{
+			return (lhs.X() * rhs.X()) + (lhs.Y() * rhs.Y()) + (lhs.Z() * rhs.Z()) + (lhs.W() * rhs.W());
+		}
+
+		/*!
+		 * \brief Returns the length (norm) of a quaternion. Rotations have a
+		 * length of 1.
+		 */
+		static inline Float Length(const Quaternion& q)
+		{
+			return Sqrt(Dot(q, q));
+		}
+
+		/*!
+		 * \copydoc vlk::Quaternion::Length(const Quaternion&)
+		 *
+		 * \cxpr
+		 */
+		static VLK_CXX14_CONSTEXPR inline ConstexprWrapper<Float> Length(ConstexprWrapper<Quaternion> q)
+		{
+			return Sqrt(ForceCXPR(Dot(*q, *q)));
+		}
+
+		/*!
+		 * \brief Returns a quaternion of length 1 with the same direction as
+		 * \c q.
+		 *
+		 * Products of many rotations slowly drift away from a length of 1 due
+		 * to rounding, which skews the rotations they represent. Normalizing
+		 * restores it.
+		 *
+		 * \warning If the provided quaternion has a length of zero, all
+		 * components of the returned quaternion will be <tt>NaN</tt>
+		 *
+		 * \sa #NormalizedSafe, #FastNormalized
+		 */
+		static inline Quaternion Normalized(const Quaternion& q)
+		{
+			return Quaternion(q.data / Length(q));
+		}
+
+		/*!
+		 * \copydoc vlk::Quaternion::Normalized(const Quaternion&)
+		 *
+		 * \cxpr
+		 */
+		static VLK_CXX14_CONSTEXPR inline ConstexprWrapper<Quaternion> Normalized(ConstexprWrapper<Quaternion> q)
+		{
+			return ForceCXPR(Quaternion(q->data / Length(q).value));
+		}
+
+		/*!
+		 * \brief Returns a quaternion of length 1 with the same direction as
+		 * \c q, or \c fallback if \c q has no direction.
+		 *
+		 * Equal to #Normalized except where its result would not be finite,
+		 * that is when the length of \c q is zero, infinite or <tt>NaN</tt>.
+		 * \c fallback is also returned when the square length of \c q
+		 * overflows, where #Normalized returns zero.
+		 */
+		static inline Quaternion NormalizedSafe(const Quaternion& q, const Quaternion& fallback = Quaternion())
+		{
+			const Float length = Length(q);
+			return (length > 0.0f && length <= std::numeric_limits<Float>::max()) ? Quaternion(q.data / length) : fallback;
+		}
+
+		/*!
+		 * \brief Approximates a quaternion of length 1 with the same direction
+		 * as \c q.
+		 *
+		 * Multiplies by vlk::FastInvSqrt() of the square length instead of
+		 * taking a square root and dividing, so the length of the result
+		 * differs from 1 by at most 1e-6. Recent x86 cores divide about as
+		 * quickly, so whether this is faster than #Normalized depends on the
+		 * CPU.
+		 *
+		 * Quaternions whose square length is not a normal float, such as the
+		 * zero quaternion, produce the identity rotation instead of
+		 * <tt>NaN</tt>.
+		 */
+		static inline Quaternion FastNormalized(const Quaternion& q)
+		{
+			const Float sq = Dot(q, q);
+			if (!(sq >= std::numeric_limits<Float>::min() && sq <= std::numeric_limits<Float>::max())) return Quaternion();
+
+			return Quaternion(q.data * FastInvSqrt(sq));
+		}
+
+		/*!
+		 * \brief Approximates a quaternion of length 1 for every quaternion of
+		 * an array.
+		 *
+		 * Equivalent to <tt>out[i] = FastNormalized(in[i])</tt> for every
+		 * <tt>i</tt>. <tt>out</tt> may be the same array as <tt>in</tt>.
+		 */
+		static inline void FastNormalized(const Quaternion* in, Quaternion* out, Size n)
+		{
+			for (Size i = 0; i < n; i++) out[i] = FastNormalized(in[i]);
+		}
+
 		/*!
 		 * \brief Constructs a quaternion representing a rotation of <tt>angle</tt> radians around an arbitrary axis <tt>axis</tt>.
 		 *
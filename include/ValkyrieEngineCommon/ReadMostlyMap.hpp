@@ -0,0 +1,243 @@
+/*!
+ * \file ReadMostlyMap.hpp
+ * \brief Hash map with lock-free lookups for read-mostly registries.
+ */
+
+#ifndef VLK_READ_MOSTLY_MAP_HPP
+#define VLK_READ_MOSTLY_MAP_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include "ValkyrieEngineCommon/Epoch.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace vlk
+{
+	/*!
+	 * \brief A hash map whose lookups take no lock and perform no atomic
+	 * read-modify-write operation.
+	 *
+	 * The map is a table of buckets, each holding a singly linked list of
+	 * nodes. Lookups follow atomic pointers from the current table to a node
+	 * and read its value inside an EpochGuard. Writers link and unlink nodes
+	 * with single pointer stores and replace the whole table when it grows, so
+	 * a reader always sees either the state before or after a write. Unlinked
+	 * nodes and old tables are destroyed through EpochDomain::Global() once no
+	 * lookup can still reach them.
+	 *
+	 * Any number of threads may call Find() concurrently with each other and
+	 * with one writer. Calls to Insert(), Erase() and Clear() must be
+	 * serialized externally.
+	 *
+	 * \tparam Key Key type, hashed with <tt>std::hash<Key></tt>.
+	 * \tparam Val Value type. Must be trivially copyable, as values are stored in <tt>std::atomic<Val></tt>.
+	 */
+	template <typename Key, typename Val>
+	class ReadMostlyMap
+	{
+		VLK_STATIC_ASSERT_MSG(std::is_trivially_copyable<Val>::value, "Val must be trivially copyable");
+
+		struct Node
+		{
+			const Size hash;
+			const Key key;
+			std::atomic<Val> value;
+			std::atomic<Node*> next;
+
+			inline Node(Size h, const Key& k, Val v, Node* n) : hash(h), key(k), value(v), next(n) { }
+		};
+
+		struct Table
+		{
+			const Size bucketCount;
+			std::unique_ptr<std::atomic<Node*>[]> buckets;
+
+			inline explicit Table(Size n) : bucketCount(n), buckets(new std::atomic<Node*>[n])
+			{
+				for (Size i = 0; i < n; i++) buckets[i].store(nullptr, std::memory_order_relaxed);
+			}
+
+			inline std::atomic<Node*>& Bucket(Size hash) { return buckets[hash & (bucketCount - 1)]; }
+		};
+
+		std::atomic<Table*> table;
+		Size count;
+
+		//! Deletes every node of a table and the table itself. No reader may be able to reach either.
+		static inline void DestroyTable(Table* t, bool nodes)
+		{
+			if (nodes)
+			{
+				for (Size i = 0; i < t->bucketCount; i++)
+				{
+					Node* n = t->buckets[i].load(std::memory_order_relaxed);
+					while (n != nullptr)
+					{
+						Node* next = n->next.load(std::memory_order_relaxed);
+						delete n;
+						n = next;
+					}
+				}
+			}
+
+			delete t;
+		}
+
+		//! Replaces the table with one of <tt>bucketCount</tt> buckets holding copies of every node.
+		inline void Rehash(Size bucketCount)
+		{
+			Table* old = table.load(std::memory_order_relaxed);
+			Table* t = new Table(bucketCount);
+
+			for (Size i = 0; i < old->bucketCount; i++)
+			{
+				for (Node* n = old->buckets[i].load(std::memory_order_relaxed); n != nullptr; n = n->next.load(std::memory_order_relaxed))
+				{
+					std::atomic<Node*>& b = t->Bucket(n->hash);
+					b.store(new Node(n->hash, n->key, n->value.load(std::memory_order_relaxed), b.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+				}
+			}
+
+			// Readers still in the old table keep following its own nodes
+			table.store(t, std::memory_order_release);
+			EpochDomain::Global().Retire([old]() { DestroyTable(old, true); });
+		}
+
+		public:
+		inline ReadMostlyMap() : table(new Table(16)), count(0) { }
+
+		ReadMostlyMap(const ReadMostlyMap&) = delete;
+		ReadMostlyMap& operator=(const ReadMostlyMap&) = delete;
+
+		//! Destroys the map. No reader may be active.
+		inline ~ReadMostlyMap()
+		{
+			DestroyTable(table.load(std::memory_order_acquire), true);
+		}
+
+		/*!
+		 * \brief Looks up the value of a key.
+		 *
+		 * \param key The key to look up.
+		 * \param out Set to the value of <tt>key</tt> if it is found, otherwise left unchanged.
+		 *
+		 * \return true if <tt>key</tt> was found.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Does not lock.<br>
+		 */
+		inline bool Find(const Key& key, Val& out) const
+		{
+			const Size hash = std::hash<Key>()(key);
+			EpochGuard guard;
+
+			Table* t = table.load(std::memory_order_acquire);
+			for (Node* n = t->Bucket(hash).load(std::memory_order_acquire); n != nullptr; n = n->next.load(std::memory_order_acquire))
+			{
+				if (n->hash == hash && n->key == key)
+				{
+					out = n->value.load(std::memory_order_acquire);
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		/*!
+		 * \brief Inserts a key or replaces its value.
+		 *
+		 * \param previous If not <tt>nullptr</tt> and <tt>key</tt> was already
+		 * present, set to the value it replaced.
+		 *
+		 * \return true if <tt>key</tt> was inserted, false if its value was replaced.
+		 */
+		inline bool Insert(const Key& key, Val value, Val* previous = nullptr)
+		{
+			const Size hash = std::hash<Key>()(key);
+			Table* t = table.load(std::memory_order_relaxed);
+			std::atomic<Node*>& b = t->Bucket(hash);
+
+			for (Node* n = b.load(std::memory_order_relaxed); n != nullptr; n = n->next.load(std::memory_order_relaxed))
+			{
+				if (n->hash == hash && n->key == key)
+				{
+					if (previous != nullptr) *previous = n->value.load(std::memory_order_relaxed);
+					n->value.store(value, std::memory_order_release);
+					return false;
+				}
+			}
+
+			b.store(new Node(hash, key, value, b.load(std::memory_order_relaxed)), std::memory_order_release);
+			if (++count > t->bucketCount) Rehash(t->bucketCount * 2);
+			return true;
+		}
+
+		/*!
+		 * \brief Removes a key.
+		 *
+		 * \param previous If not <tt>nullptr</tt> and <tt>key</tt> was present, set to its value.
+		 *
+		 * \return true if <tt>key</tt> was present.
+		 */
+		inline bool Erase(const Key& key, Val* previous = nullptr)
+		{
+			const Size hash = std::hash<Key>()(key);
+			Table* t = table.load(std::memory_order_relaxed);
+
+			std::atomic<Node*>* link = &t->Bucket(hash);
+			for (Node* n = link->load(std::memory_order_relaxed); n != nullptr; n = link->load(std::memory_order_relaxed))
+			{
+				if (n->hash == hash && n->key == key)
+				{
+					if (previous != nullptr) *previous = n->value.load(std::memory_order_relaxed);
+
+					// Readers standing on n can still follow its next pointer
+					link->store(n->next.load(std::memory_order_relaxed), std::memory_order_release);
+					EpochDomain::Global().Retire([n]() { delete n; });
+					count--;
+					return true;
+				}
+
+				link = &n->next;
+			}
+
+			return false;
+		}
+
+		//! Removes every key.
+		inline void Clear()
+		{
+			Table* old = table.exchange(new Table(16), std::memory_order_acq_rel);
+			count = 0;
+			EpochDomain::Global().Retire([old]() { DestroyTable(old, true); });
+		}
+
+		//! Returns the number of keys in the map. Must be serialized with writers.
+		inline Size Count() const { return count; }
+
+		/*!
+		 * \brief Calls <tt>f(key, value)</tt> for every key in the map.
+		 *
+		 * Must be serialized with writers, and <tt>f</tt> must not modify the map.
+		 */
+		template <typename F>
+		inline void ForEach(F f) const
+		{
+			Table* t = table.load(std::memory_order_acquire);
+			for (Size i = 0; i < t->bucketCount; i++)
+			{
+				for (Node* n = t->buckets[i].load(std::memory_order_acquire); n != nullptr; n = n->next.load(std::memory_order_acquire))
+				{
+					f(n->key, n->value.load(std::memory_order_acquire));
+				}
+			}
+		}
+	};
+}
+
+#endif
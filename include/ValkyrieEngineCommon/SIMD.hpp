@@ -0,0 +1,183 @@
+/*!
+ * \file SIMD.hpp
+ * \brief Instruction set detection for SIMD-accelerated code paths.
+ *
+ *	SIMD code paths are selected at compile time based on the instruction
+ *	sets enabled for the target and are only ever taken at runtime. Functions
+ *	that are also <tt>constexpr</tt> fall back to their scalar implementation
+ *	during constant evaluation, so compile-time results are unaffected.
+ *
+ *	Bulk kernels operating on arrays are additionally compiled for wider
+ *	instruction sets than the target enables, and the widest one the CPU
+ *	supports is selected at runtime, see vlk::GetSIMDLevel().
+ *
+ *	Defining <tt>VLK_COMMON_DISABLE_SIMD</tt> before including any header of
+ *	this library forces every function onto its scalar implementation.
+ */
+
+#ifndef VLK_SIMD_HPP
+#define VLK_SIMD_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include <atomic>
+
+#ifndef VLK_COMMON_DISABLE_SIMD
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define VLK_COMMON_SSE2 1
+		#include <emmintrin.h>
+	#endif
+
+	#if defined(__AVX__)
+		#define VLK_COMMON_AVX 1
+		#include <immintrin.h>
+	#endif
+
+	#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+		#define VLK_COMMON_RUNTIME_DISPATCH 1
+		#define VLK_COMMON_TARGET(isa) __attribute__((target(isa)))
+		#include <immintrin.h>
+	#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		#define VLK_COMMON_RUNTIME_DISPATCH 1
+		#include <immintrin.h>
+		#include <intrin.h>
+	#endif
+#endif
+
+/*!
+ * \brief Compiles a function for an instruction set the target does not
+ * enable, so it may only be called after checking the CPU supports it.
+ *
+ * MSVC accepts every intrinsic in every function, so this expands to
+ * nothing there.
+ */
+#ifndef VLK_COMMON_TARGET
+	#define VLK_COMMON_TARGET(isa)
+#endif
+
+#if defined(__has_builtin)
+	#if __has_builtin(__builtin_is_constant_evaluated)
+		#define VLK_COMMON_HAS_IS_CONSTANT_EVALUATED 1
+	#endif
+#endif
+
+#if !defined(VLK_COMMON_HAS_IS_CONSTANT_EVALUATED)
+	#if (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+		#define VLK_COMMON_HAS_IS_CONSTANT_EVALUATED 1
+	#endif
+#endif
+
+/*!
+ * \brief Evaluates to true if the enclosing function is being evaluated as
+ * part of a constant expression.
+ *
+ * If the compiler offers no way to detect constant evaluation, this always
+ * evaluates to true so <tt>constexpr</tt> functions never take a SIMD path.
+ */
+#ifdef VLK_COMMON_HAS_IS_CONSTANT_EVALUATED
+	#define VLK_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+	#define VLK_IS_CONSTANT_EVALUATED() true
+#endif
+
+namespace vlk
+{
+	/*!
+	 * \brief Instruction sets bulk kernels can be dispatched to at runtime,
+	 * from narrowest to widest.
+	 */
+	enum class SIMDLevel
+	{
+		Scalar,
+		SSE2,
+		AVX2,
+		AVX512
+	};
+
+	/*!
+	 * \brief Returns the widest instruction set supported by both the CPU and
+	 * the operating system.
+	 *
+	 * Always returns SIMDLevel::Scalar if <tt>VLK_COMMON_DISABLE_SIMD</tt> is
+	 * defined or the target is not x86.
+	 */
+	inline SIMDLevel DetectSIMDLevel()
+	{
+		#if defined(VLK_COMMON_RUNTIME_DISPATCH) && defined(_MSC_VER) && !defined(__clang__)
+		int info[4];
+		__cpuid(info, 0);
+		const int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		const bool sse2 = (info[3] & (1 << 26)) != 0;
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+
+		// The operating system must save the YMM and ZMM registers on context switches
+		const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+		if (maxLeaf >= 7 && (xcr0 & 0x6) == 0x6)
+		{
+			__cpuidex(info, 7, 0);
+			if ((info[1] & (1 << 16)) != 0 && (xcr0 & 0xE6) == 0xE6) return SIMDLevel::AVX512;
+			if ((info[1] & (1 << 5)) != 0) return SIMDLevel::AVX2;
+		}
+
+		return sse2 ? SIMDLevel::SSE2 : SIMDLevel::Scalar;
+		#elif defined(VLK_COMMON_RUNTIME_DISPATCH)
+		// Also checks that the operating system saves the wider registers
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f")) return SIMDLevel::AVX512;
+		if (__builtin_cpu_supports("avx2")) return SIMDLevel::AVX2;
+		if (__builtin_cpu_supports("sse2")) return SIMDLevel::SSE2;
+		return SIMDLevel::Scalar;
+		#else
+		return SIMDLevel::Scalar;
+		#endif
+	}
+
+	namespace SIMDDispatch
+	{
+		inline std::atomic<SIMDLevel>& Level()
+		{
+			static std::atomic<SIMDLevel> level(DetectSIMDLevel());
+			return level;
+		}
+	}
+
+	/*!
+	 * \brief Returns the instruction set bulk kernels are dispatched to.
+	 *
+	 * Defaults to the result of DetectSIMDLevel().
+	 *
+	 * \ts
+	 * May be called from any thread.<br>
+	 * Does not lock.<br>
+	 */
+	inline SIMDLevel GetSIMDLevel()
+	{
+		return SIMDDispatch::Level().load(std::memory_order_relaxed);
+	}
+
+	/*!
+	 * \brief Limits the instruction set bulk kernels are dispatched to, for
+	 * testing or comparing the kernels of each level.
+	 *
+	 * \param level The widest level to use. Levels the CPU does not support
+	 * are lowered to DetectSIMDLevel().
+	 *
+	 * \returns The level now in use.
+	 *
+	 * \ts
+	 * May be called from any thread.<br>
+	 * Does not lock.<br>
+	 * Calls already dispatched on other threads finish on the previous level.<br>
+	 */
+	inline SIMDLevel SetSIMDLevel(SIMDLevel level)
+	{
+		const SIMDLevel detected = DetectSIMDLevel();
+		if (static_cast<int>(level) > static_cast<int>(detected)) level = detected;
+
+		SIMDDispatch::Level().store(level, std::memory_order_relaxed);
+		return level;
+	}
+}
+
+#endif
@@ -0,0 +1,197 @@
+/*!
+ * \file SlotArray.hpp
+ * \brief Dense array of pointers addressed by generational indices.
+ */
+
+#ifndef VLK_SLOT_ARRAY_HPP
+#define VLK_SLOT_ARRAY_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace vlk
+{
+	/*!
+	 * \brief A dense array of pointers where every slot carries a generation
+	 * counter, so stale indices can be detected in constant time.
+	 *
+	 * Slots are allocated in chunks that double in size and never move, so a
+	 * lookup is a few arithmetic operations, three loads and two comparisons,
+	 * and never has to synchronize with a writer growing the array.
+	 *
+	 * The generation of a slot is odd while it holds a pointer and even while
+	 * it is free. Freeing a slot and reusing it each advance the generation,
+	 * so an index obtained before either will no longer match.
+	 *
+	 * Every slot also carries a referenced bit for CLOCK replacement, set by
+	 * Touch() and cleared by ClearReferenced().
+	 *
+	 * Any number of threads may call Get() and Touch() concurrently with each
+	 * other and with one writer. Calls to Allocate(), Free() and
+	 * ClearReferenced() must be serialized externally.
+	 *
+	 * \tparam T Type pointed to by each slot. The array does not own the pointers.
+	 */
+	template <typename T>
+	class SlotArray
+	{
+		struct Slot
+		{
+			std::atomic<UInt> generation;
+			std::atomic<T*> value;
+			std::atomic<bool> referenced;
+
+			inline Slot() : generation(0), value(nullptr), referenced(false) { }
+		};
+
+		//! Number of slots in the first chunk. Chunk k holds <tt>FirstChunkSize << k</tt> slots.
+		static VLK_CXX14_CONSTEXPR Size FirstChunkSize = 64;
+
+		//! Enough chunks to address every UInt index.
+		static VLK_CXX14_CONSTEXPR Size MaxChunks = 27;
+
+		std::atomic<Slot*> chunks[MaxChunks];
+		UInt slotCount;
+		std::vector<UInt> freeSlots;
+
+		//! Returns the index of the highest set bit of <tt>v</tt>, which must not be zero.
+		static inline Size HighestBit(Size v)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return (sizeof(Size) * 8 - 1) - static_cast<Size>(__builtin_clzll(static_cast<unsigned long long>(v)));
+#else
+			Size b = 0;
+			while (v >>= 1) b++;
+			return b;
+#endif
+		}
+
+		//! Returns the slot at <tt>index</tt>, or nullptr if its chunk has not been allocated.
+		inline Slot* Find(UInt index) const
+		{
+			const Size chunk = HighestBit(Size(index) / FirstChunkSize + 1);
+			const Size offset = Size(index) - FirstChunkSize * ((Size(1) << chunk) - 1);
+
+			Slot* c = chunks[chunk].load(std::memory_order_acquire);
+			return (c == nullptr) ? nullptr : c + offset;
+		}
+
+		public:
+		inline SlotArray() : slotCount(0), freeSlots()
+		{
+			for (Size i = 0; i < MaxChunks; i++) chunks[i].store(nullptr, std::memory_order_relaxed);
+		}
+
+		SlotArray(const SlotArray&) = delete;
+		SlotArray& operator=(const SlotArray&) = delete;
+
+		//! Destroys the array. No reader may be active. The pointers held by the slots are not deleted.
+		inline ~SlotArray()
+		{
+			for (Size i = 0; i < MaxChunks; i++) delete[] chunks[i].load(std::memory_order_acquire);
+		}
+
+		/*!
+		 * \brief Stores a pointer in a free slot.
+		 *
+		 * \param value The pointer to store. Must not be nullptr.
+		 * \param index Set to the index of the slot.
+		 * \param generation Set to the generation of the slot, which is always odd.
+		 *
+		 * \throws std::length_error If every index is in use.
+		 */
+		inline void Allocate(T* value, UInt& index, UInt& generation)
+		{
+			if (!freeSlots.empty())
+			{
+				index = freeSlots.back();
+				freeSlots.pop_back();
+			}
+			else
+			{
+				if (slotCount == ~UInt(0)) throw std::length_error("SlotArray is full");
+				index = slotCount++;
+
+				const Size chunk = HighestBit(Size(index) / FirstChunkSize + 1);
+				if (chunks[chunk].load(std::memory_order_relaxed) == nullptr)
+				{
+					chunks[chunk].store(new Slot[FirstChunkSize << chunk], std::memory_order_release);
+				}
+			}
+
+			Slot& s = *Find(index);
+			generation = s.generation.load(std::memory_order_relaxed) + 1;
+
+			// The value must be visible to any reader that observes the new generation, and a reader that
+			// observes the value must also observe the generation advanced by Free()
+			s.value.store(value, std::memory_order_release);
+			s.referenced.store(true, std::memory_order_relaxed);
+			s.generation.store(generation, std::memory_order_release);
+		}
+
+		/*!
+		 * \brief Frees a slot, invalidating every index referring to it.
+		 *
+		 * \param index The index of an allocated slot.
+		 */
+		inline void Free(UInt index)
+		{
+			Slot& s = *Find(index);
+			s.generation.store(s.generation.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			s.value.store(nullptr, std::memory_order_release);
+			freeSlots.push_back(index);
+		}
+
+		/*!
+		 * \brief Returns the pointer stored in a slot.
+		 *
+		 * \return The pointer, or nullptr if the slot has been freed or reused
+		 * since <tt>generation</tt> was obtained.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Does not lock.<br>
+		 */
+		inline T* Get(UInt index, UInt generation) const
+		{
+			const Slot* s = Find(index);
+			if (s == nullptr) return nullptr;
+			if (s->generation.load(std::memory_order_acquire) != generation) return nullptr;
+
+			// The slot may have been freed and reused between the two loads, in which case the value
+			// belongs to the new occupant. Checking the generation again detects it, like a seqlock.
+			T* value = s->value.load(std::memory_order_acquire);
+			if (s->generation.load(std::memory_order_acquire) != generation) return nullptr;
+			return value;
+		}
+
+		/*!
+		 * \brief Sets the referenced bit of a slot.
+		 *
+		 * The bit is only written if it is clear, so slots touched by many
+		 * threads do not keep invalidating each other's cache lines.
+		 *
+		 * \ts
+		 * May be called from any thread.<br>
+		 * Does not lock.<br>
+		 */
+		inline void Touch(UInt index) const
+		{
+			Slot* s = Find(index);
+			if (s != nullptr && !s->referenced.load(std::memory_order_relaxed))
+			{
+				s->referenced.store(true, std::memory_order_relaxed);
+			}
+		}
+
+		//! Clears the referenced bit of an allocated slot and returns its previous value.
+		inline bool ClearReferenced(UInt index)
+		{
+			return Find(index)->referenced.exchange(false, std::memory_order_relaxed);
+		}
+	};
+}
+
+#endif
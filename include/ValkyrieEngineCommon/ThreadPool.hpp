@@ -0,0 +1,275 @@
+/*!
+ * \file ThreadPool.hpp
+ * \brief Work-stealing thread pool for data parallel batch operations.
+ */
+
+#ifndef VLK_THREAD_POOL_HPP
+#define VLK_THREAD_POOL_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vlk
+{
+	/*!
+	 * \brief A fixed set of worker threads sharing work by stealing.
+	 *
+	 * Every worker owns a queue of tasks. Tasks submitted from a worker are
+	 * pushed onto the queue of that worker and tasks submitted from any other
+	 * thread are distributed round-robin. Workers run tasks from the back of
+	 * their own queue, and once it is empty steal from the front of the queues
+	 * of other workers.
+	 *
+	 * Threads waiting in ParallelFor() run queued tasks until their own work
+	 * is finished, so ParallelFor() may be called from within a task and a
+	 * pool with zero workers runs everything on the calling thread.
+	 */
+	class ThreadPool
+	{
+		typedef std::function<void()> Task;
+
+		struct Worker
+		{
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		static VLK_CXX14_CONSTEXPR Size NoWorker = std::numeric_limits<Size>::max();
+
+		std::vector<std::unique_ptr<Worker>> workers;
+		std::vector<std::thread> threads;
+
+		std::mutex sleepMutex;
+		std::condition_variable sleepCondition;
+		bool stopping;
+
+		//! Number of tasks in all queues.
+		std::atomic<Size> queued;
+		std::atomic<Size> nextWorker;
+
+		//! Pool and worker index of the calling thread, if it is a worker.
+		static inline std::pair<const ThreadPool*, Size>& CurrentWorker()
+		{
+			static thread_local std::pair<const ThreadPool*, Size> current(nullptr, Size(NoWorker));
+			return current;
+		}
+
+		inline Size CurrentWorkerIndex() const
+		{
+			const std::pair<const ThreadPool*, Size>& current = CurrentWorker();
+			return (current.first == this) ? current.second : Size(NoWorker);
+		}
+
+		//! Takes a task from the back of the queue of worker <tt>self</tt>, or steals one from another worker.
+		inline bool TryTake(Size self, Task& out)
+		{
+			const Size n = workers.size();
+
+			if (self != NoWorker)
+			{
+				Worker& w = *workers[self];
+				std::lock_guard<std::mutex> lock(w.mutex);
+				if (!w.tasks.empty())
+				{
+					out = std::move(w.tasks.back());
+					w.tasks.pop_back();
+					return true;
+				}
+			}
+
+			const Size start = (self == NoWorker) ? 0 : self + 1;
+			for (Size k = 0; k < n; k++)
+			{
+				Worker& w = *workers[(start + k) % n];
+				std::lock_guard<std::mutex> lock(w.mutex);
+				if (!w.tasks.empty())
+				{
+					out = std::move(w.tasks.front());
+					w.tasks.pop_front();
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		//! Runs a single queued task on the calling thread. Returns false if no task was queued.
+		inline bool RunOne(Size self)
+		{
+			if (queued.load(std::memory_order_acquire) == 0) return false;
+
+			Task task;
+			if (!TryTake(self, task)) return false;
+
+			queued.fetch_sub(1, std::memory_order_acq_rel);
+			task();
+			return true;
+		}
+
+		inline void WorkerLoop(Size self)
+		{
+			CurrentWorker() = std::make_pair(this, self);
+
+			while (true)
+			{
+				if (RunOne(self)) continue;
+
+				std::unique_lock<std::mutex> lock(sleepMutex);
+				sleepCondition.wait(lock, [this]() { return stopping || queued.load(std::memory_order_acquire) > 0; });
+				if (stopping && queued.load(std::memory_order_acquire) == 0) return;
+			}
+		}
+
+		public:
+		/*!
+		 * \brief Starts a pool of <tt>threadCount</tt> worker threads.
+		 *
+		 * \param threadCount Number of worker threads. May be zero, in which
+		 * case all work runs on the threads calling ParallelFor().
+		 */
+		inline explicit ThreadPool(Size threadCount = std::thread::hardware_concurrency()) :
+			workers(),
+			threads(),
+			sleepMutex(),
+			sleepCondition(),
+			stopping(false),
+			queued(0),
+			nextWorker(0)
+		{
+			for (Size i = 0; i < threadCount; i++) workers.emplace_back(new Worker());
+			for (Size i = 0; i < threadCount; i++) threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+		}
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		//! Runs every queued task, then stops all worker threads.
+		inline ~ThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(sleepMutex);
+				stopping = true;
+			}
+
+			sleepCondition.notify_all();
+			for (std::thread& t : threads) t.join();
+		}
+
+		//! Returns the number of worker threads.
+		inline Size ThreadCount() const { return threads.size(); }
+
+		/*!
+		 * \brief Queues a task to be run by a worker thread.
+		 *
+		 * The task must not throw. If the pool has no workers, the task is run
+		 * immediately on the calling thread.
+		 */
+		inline void Submit(Task task)
+		{
+			if (workers.empty())
+			{
+				task();
+				return;
+			}
+
+			Size self = CurrentWorkerIndex();
+			if (self == NoWorker) self = nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+
+			// Counted before it can be taken, so RunOne() never decrements below zero
+			queued.fetch_add(1, std::memory_order_acq_rel);
+
+			{
+				std::lock_guard<std::mutex> lock(workers[self]->mutex);
+				workers[self]->tasks.push_back(std::move(task));
+			}
+
+			{
+				// Pairs with the predicate checks in WorkerLoop() and ParallelFor() so the wake-up cannot be lost
+				std::lock_guard<std::mutex> lock(sleepMutex);
+			}
+
+			sleepCondition.notify_one();
+		}
+
+		/*!
+		 * \brief Calls <tt>f(begin, end)</tt> on the pool for consecutive ranges
+		 * covering <tt>[0, count)</tt>, and waits for every call to finish.
+		 *
+		 * The calling thread runs queued tasks while it waits, and sleeps once
+		 * none are left to run.
+		 *
+		 * \param count Number of items.
+		 * \param grain Maximum number of items passed to a single call of <tt>f</tt>.
+		 * \param f Function called with the first and one past the last item of each range.
+		 *
+		 * \throws Rethrows the first exception thrown by <tt>f</tt>, once every call has finished.
+		 */
+		template <typename F>
+		inline void ParallelFor(Size count, Size grain, F f)
+		{
+			grain = std::max<Size>(grain, 1);
+			const Size chunks = (count + grain - 1) / grain;
+			if (chunks == 0) return;
+
+			std::atomic<Size> remaining(chunks);
+			std::exception_ptr error;
+			std::mutex errorMutex;
+
+			for (Size c = 0; c < chunks; c++)
+			{
+				const Size begin = c * grain;
+				const Size end = std::min(count, begin + grain);
+
+				Submit([&, begin, end]()
+				{
+					try
+					{
+						f(begin, end);
+					}
+					catch (...)
+					{
+						std::lock_guard<std::mutex> lock(errorMutex);
+						if (!error) error = std::current_exception();
+					}
+
+					if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					{
+						// Pairs with the predicate check below so the wake-up cannot be lost
+						{
+							std::lock_guard<std::mutex> lock(sleepMutex);
+						}
+
+						sleepCondition.notify_all();
+					}
+				});
+			}
+
+			const Size self = CurrentWorkerIndex();
+			while (remaining.load(std::memory_order_acquire) > 0)
+			{
+				if (RunOne(self)) continue;
+
+				// The last chunks are running on other threads, so sleep until they finish or more tasks are queued
+				std::unique_lock<std::mutex> lock(sleepMutex);
+				sleepCondition.wait(lock, [&]()
+				{
+					return remaining.load(std::memory_order_acquire) == 0 || queued.load(std::memory_order_acquire) > 0;
+				});
+			}
+
+			if (error) std::rethrow_exception(error);
+		}
+	};
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "ValkyrieEngineCommon/Matrix.hpp"
 #include <algorithm>
+#include <atomic>
 #include <shared_mutex>
 #include <stdexcept>
 #include <unordered_map>
@@ -188,6 +189,29 @@ namespace vlk
 	 * \brief 3D geometric transform.
 	 *
 	 * Combines a scale, rotation and translation into a single operation.
+	 *
+	 * \par Caching
+	 * When caching is enabled with SetCachingEnabled(), GetMatrix() and
+	 * GetWorldMatrix() store their results and only rebuild them after this
+	 * transform or one of its parents changed. Any change to a caching
+	 * transform advances a global generation counter; as long as it has not advanced
+	 * since the last query, a cached world matrix is returned without looking
+	 * at any parent. Otherwise each cached world matrix is checked against
+	 * the version of the parent world matrix it was built from, and only the
+	 * out of date ones are rebuilt. Parents that do not cache are rebuilt on
+	 * every query as usual.
+	 *
+	 * Transforms do not know their children, so the generation is shared by
+	 * every transform: after a change anywhere, the next query of each cached
+	 * transform walks its parents once, even if none of them changed. For
+	 * large hierarchies that change every frame, vlk::TransformGraph3D
+	 * updates only what is needed in a single pass.
+	 *
+	 * While caching is enabled, <tt>translation</tt>, <tt>rotation</tt> and
+	 * <tt>scale</tt> must be modified through SetTranslation(), SetRotation()
+	 * and SetScale(), or followed by a call to Invalidate(). Cached queries
+	 * update the cache of the transform and its parents, so they must not run
+	 * concurrently on transforms that share a parent.
 	 */
 	class Transform3D
 	{
@@ -198,6 +222,134 @@ namespace vlk
 		 */
 		const Transform3D* parent;
 
+		//! Whether GetMatrix() and GetWorldMatrix() use the cached matrices.
+		bool caching;
+
+		//! Cached matrices of a transform.
+		struct Cache
+		{
+			Matrix4 local;
+			Matrix4 world;
+
+			//! The parent the world matrix was built with.
+			const Transform3D* parent;
+
+			//! Version of the parent world matrix the world matrix was built from.
+			Size parentVersion;
+
+			//! Version of the world matrix. Zero if it was never built.
+			Size version;
+
+			//! Generation at which the world matrix was last known to be up to date.
+			Size generation;
+
+			//! Set when the local matrix must be rebuilt.
+			bool localDirty;
+
+			//! Set when the world matrix must be rebuilt, even if GetMatrix() already rebuilt the local matrix.
+			bool worldDirty;
+
+			VLK_CXX14_CONSTEXPR inline Cache() :
+				local(),
+				world(),
+				parent(nullptr),
+				parentVersion(0),
+				version(0),
+				generation(0),
+				localDirty(true),
+				worldDirty(true)
+			{ }
+
+			VLK_CXX14_CONSTEXPR inline Cache(const Cache&) = default;
+			VLK_CXX14_CONSTEXPR inline Cache(Cache&&) = default;
+			VLK_CXX14_CONSTEXPR inline Cache& operator=(const Cache&) = default;
+			VLK_CXX14_CONSTEXPR inline Cache& operator=(Cache&&) = default;
+		};
+
+		mutable Cache cache;
+
+		//! Counter advanced on every change to any transform. Starts at one so a new cache is never current.
+		static inline std::atomic<Size>& Generation()
+		{
+			static std::atomic<Size> generation(1);
+			return generation;
+		}
+
+		//! Returns a world matrix version that has not been returned before.
+		static inline Size NextVersion()
+		{
+			static std::atomic<Size> version(0);
+			return version.fetch_add(1, std::memory_order_relaxed) + 1;
+		}
+
+		/*!
+		 * \brief Advances the global generation, forcing cached world matrices to be checked again.
+		 *
+		 * Only needed for changes to transforms that cache: cached children
+		 * never consider an uncached parent current, so they walk it anyway.
+		 */
+		static VLK_CXX14_CONSTEXPR inline void Modified()
+		{
+			if (!VLK_IS_CONSTANT_EVALUATED())
+			{
+				Generation().fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		//! Rebuilds any out of date cached matrices of this transform and its parents.
+		inline const Matrix4& UpdateWorldMatrix() const
+		{
+			const Size generation = Generation().load(std::memory_order_relaxed);
+			if (cache.generation == generation) return cache.world;
+
+			bool dirty = cache.worldDirty || cache.version == 0 || cache.parent != parent;
+			bool current = true;
+
+			if (cache.localDirty)
+			{
+				cache.local = BuildMatrix();
+				cache.localDirty = false;
+			}
+
+			if (parent == nullptr)
+			{
+				if (dirty) cache.world = cache.local;
+			}
+			else if (parent->caching)
+			{
+				const Matrix4& parentWorld = parent->UpdateWorldMatrix();
+				dirty = dirty || parent->cache.version != cache.parentVersion;
+				current = parent->cache.generation == generation;
+				if (dirty) cache.world = parentWorld * cache.local;
+			}
+			else
+			{
+				// Uncached parents may be modified directly, so they are never current
+				cache.world = parent->GetWorldMatrix() * cache.local;
+				dirty = true;
+				current = false;
+			}
+
+			if (dirty)
+			{
+				cache.worldDirty = false;
+				cache.version = NextVersion();
+				cache.parent = parent;
+				cache.parentVersion = (parent == nullptr) ? 0 : parent->cache.version;
+			}
+
+			cache.generation = current ? generation : 0;
+			return cache.world;
+		}
+
+		VLK_CXX14_CONSTEXPR inline Matrix4 BuildMatrix() const
+		{
+			return
+				Matrix4::CreateTranslation(translation) *
+				Matrix4::CreateRotation(rotation) *
+				Matrix4::CreateScale(scale);
+		}
+
 		public:
 
 		Vector3 translation;
@@ -206,15 +358,59 @@ namespace vlk
 
 		VLK_CXX14_CONSTEXPR inline Transform3D() :
 			parent(nullptr),
+			caching(false),
+			cache(),
 			translation(),
 			rotation(),
 			scale(1.f, 1.f, 1.f)
 		{ }
 
+		/*!
+		 * \brief Constructs a transform from its components.
+		 *
+		 * Usable in constant expressions, so static transform hierarchies can
+		 * be declared <tt>constexpr</tt> and queried with the constexpr
+		 * overloads of GetMatrix() and GetWorldMatrix().
+		 *
+		 * \code
+		 * static constexpr vlk::Transform3D rig(vlk::Vector3(0.f, 2.f, 0.f), vlk::Quaternion(), vlk::Vector3::One());
+		 * static constexpr vlk::Transform3D camera(vlk::Vector3(0.f, 0.f, 5.f), vlk::Quaternion(), vlk::Vector3::One(), &rig);
+		 * static constexpr vlk::Matrix4 view = camera.GetWorldMatrix(vlk::ForceCXPR());
+		 * \endcode
+		 */
+		VLK_CXX14_CONSTEXPR inline Transform3D(const Vector3& t, const Quaternion& r, const Vector3& s, const Transform3D* p = nullptr) :
+			parent(p),
+			caching(false),
+			cache(),
+			translation(t),
+			rotation(r),
+			scale(s)
+		{ }
+
 		VLK_CXX14_CONSTEXPR inline Transform3D(const Transform3D&) = default;
 		VLK_CXX14_CONSTEXPR inline Transform3D(Transform3D&&) = default;
-		VLK_CXX14_CONSTEXPR inline Transform3D& operator=(const Transform3D&) = default;
-		VLK_CXX14_CONSTEXPR inline Transform3D& operator=(Transform3D&&) = default;
+
+		VLK_CXX14_CONSTEXPR inline Transform3D& operator=(const Transform3D& rhs)
+		{
+			// Cached children of this transform may have considered it current
+			const bool wasCaching = caching;
+
+			parent = rhs.parent;
+			caching = rhs.caching;
+			cache = rhs.cache;
+			translation = rhs.translation;
+			rotation = rhs.rotation;
+			scale = rhs.scale;
+
+			if (wasCaching || caching) Modified();
+			return *this;
+		}
+
+		VLK_CXX14_CONSTEXPR inline Transform3D& operator=(Transform3D&& rhs)
+		{
+			return *this = static_cast<const Transform3D&>(rhs);
+		}
+
 		VLK_CXX20_CONSTEXPR inline ~Transform3D() = default;
 
 		VLK_CXX14_CONSTEXPR inline bool operator==(const Transform3D& rhs) const
@@ -238,10 +434,29 @@ namespace vlk
 		//! brief Gets a transformation matrix representing this transform of this object in local space.
 		VLK_CXX14_CONSTEXPR inline Matrix4 GetMatrix() const
 		{
-			return
-				Matrix4::CreateTranslation(translation) *
-				Matrix4::CreateRotation(rotation) *
-				Matrix4::CreateScale(scale);
+			if (caching && !VLK_IS_CONSTANT_EVALUATED())
+			{
+				if (cache.localDirty)
+				{
+					cache.local = BuildMatrix();
+					cache.localDirty = false;
+				}
+
+				return cache.local;
+			}
+
+			return BuildMatrix();
+		}
+
+		/*!
+		 * \copydoc vlk::Transform3D::GetMatrix() const
+		 * \cxpr
+		 *
+		 * Never reads or updates the cached matrices.
+		 */
+		VLK_CXX14_CONSTEXPR inline ConstexprWrapper<Matrix4> GetMatrix(ConstexprWrapper<void>) const
+		{
+			return ForceCXPR(BuildMatrix());
 		}
 
 		/*!
@@ -249,10 +464,80 @@ namespace vlk
 		 */
 		VLK_CXX14_CONSTEXPR inline Matrix4 GetWorldMatrix() const
 		{
+			if (caching && !VLK_IS_CONSTANT_EVALUATED()) return UpdateWorldMatrix();
 			if (parent == nullptr) return GetMatrix();
 			return parent->GetWorldMatrix() * GetMatrix();
 		}
 
+		/*!
+		 * \copydoc vlk::Transform3D::GetWorldMatrix() const
+		 * \cxpr
+		 *
+		 * Never reads or updates the cached matrices.
+		 */
+		VLK_CXX14_CONSTEXPR inline ConstexprWrapper<Matrix4> GetWorldMatrix(ConstexprWrapper<void>) const
+		{
+			if (parent == nullptr) return GetMatrix(ForceCXPR());
+			return ForceCXPR(parent->GetWorldMatrix(ForceCXPR()).value * GetMatrix(ForceCXPR()).value);
+		}
+
+		/*!
+		 * \brief Enables or disables caching of the local and world matrix.
+		 *
+		 * \sa vlk::Transform3D::Invalidate()
+		 */
+		VLK_CXX14_CONSTEXPR inline void SetCachingEnabled(bool enabled)
+		{
+			const bool wasCaching = caching;
+
+			caching = enabled;
+			cache.localDirty = true;
+			cache.worldDirty = true;
+			cache.version = 0;
+			if (wasCaching || caching) Modified();
+		}
+
+		//! Returns true if caching of the local and world matrix is enabled.
+		VLK_CXX14_CONSTEXPR inline bool IsCachingEnabled() const
+		{
+			return caching;
+		}
+
+		/*!
+		 * \brief Marks the cached matrices of this transform as out of date.
+		 *
+		 * Must be called after modifying <tt>translation</tt>, <tt>rotation</tt>
+		 * or <tt>scale</tt> directly while caching is enabled. Transforms
+		 * parented to this one are updated by their next query.
+		 */
+		VLK_CXX14_CONSTEXPR inline void Invalidate()
+		{
+			cache.localDirty = true;
+			cache.worldDirty = true;
+			if (caching) Modified();
+		}
+
+		//! Sets the translation of this transform and invalidates the cached matrices.
+		VLK_CXX14_CONSTEXPR inline void SetTranslation(const Vector3& t)
+		{
+			translation = t;
+			Invalidate();
+		}
+
+		//! Sets the rotation of this transform and invalidates the cached matrices.
+		VLK_CXX14_CONSTEXPR inline void SetRotation(const Quaternion& r)
+		{
+			rotation = r;
+			Invalidate();
+		}
+
+		//! Sets the scale of this transform and invalidates the cached matrices.
+		VLK_CXX14_CONSTEXPR inline void SetScale(const Vector3& s)
+		{
+			scale = s;
+			Invalidate();
+		}
+
 		/*!
 		 * \brief Gets the current parent of this transform object, may be <tt>nullptr</tt>.
 		 */
@@ -281,6 +566,7 @@ namespace vlk
 			}
 
 			parent = tr;
+			if (caching) Modified();
 		}
 
 		/*!
@@ -291,6 +577,15 @@ namespace vlk
 			return GetWorldMatrix() * Vector4(0.f, 0.f, 0.f, 1.f);
 		}
 
+		/*!
+		 * \copydoc vlk::Transform3D::GetWorldTranslation() const
+		 * \cxpr
+		 */
+		VLK_CXX14_CONSTEXPR inline ConstexprWrapper<Vector3> GetWorldTranslation(ConstexprWrapper<void>) const
+		{
+			return ForceCXPR<Vector3>(GetWorldMatrix(ForceCXPR()).value * Vector4(0.f, 0.f, 0.f, 1.f));
+		}
+
 		/*!
 		 * \brief Gets the rotation of this transform in world space.
 		 */
@@ -303,9 +598,13 @@ namespace vlk
 			return Quaternion::AngleAxis(angle, axis);
 		}
 
+		/*!
+		 * \copydoc vlk::Transform3D::GetWorldRotation() const
+		 * \cxpr
+		 */
 		VLK_CXX14_CONSTEXPR inline Quaternion GetWorldRotation(ConstexprWrapper<void>) const
 		{
-			Matrix4 world(GetWorldMatrix());
+			Matrix4 world(GetWorldMatrix(ForceCXPR()));
 			Vector3 point (world * Vector4(1.f, 0.f, 0.f, 1.f));
 			Vector3 axis = point - (world * Vector4(0.f, 0.f, 0.f, 1.f));
 			Float angle = Vector3::Dot(ForceCXPR(Vector3(1.f, 0.f, 0.f)), ForceCXPR(point));
@@ -320,6 +619,16 @@ namespace vlk
 			Matrix4 world(GetWorldMatrix());
 			return (world * Vector4(1.f, 1.f, 1.f, 1.f)) - (world * Vector4(0.f, 0.f, 0.f, 1.f));
 		}
+
+		/*!
+		 * \copydoc vlk::Transform3D::GetWorldScale() const
+		 * \cxpr
+		 */
+		VLK_CXX14_CONSTEXPR inline ConstexprWrapper<Vector3> GetWorldScale(ConstexprWrapper<void>) const
+		{
+			Matrix4 world(GetWorldMatrix(ForceCXPR()));
+			return ForceCXPR<Vector3>((world * Vector4(1.f, 1.f, 1.f, 1.f)) - (world * Vector4(0.f, 0.f, 0.f, 1.f)));
+		}
 	};
 }
 
@@ -0,0 +1,519 @@
+/*!
+ * \file TransformGraph.hpp
+ * \brief Flat, topologically sorted storage for transform hierarchies.
+ */
+
+#ifndef VLK_TRANSFORM_GRAPH_HPP
+#define VLK_TRANSFORM_GRAPH_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include "ValkyrieEngineCommon/Matrix.hpp"
+#include "ValkyrieEngineCommon/ThreadPool.hpp"
+#include "ValkyrieEngineCommon/Transform.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vlk
+{
+	/*!
+	 * \brief A hierarchy of 3D transforms stored in contiguous arrays.
+	 *
+	 * The translation, rotation, scale, parent and world matrix of every node
+	 * are kept in separate arrays, ordered so that every parent comes before
+	 * all of its children. UpdateWorldMatrices() can then compute every world
+	 * matrix in a single front to back pass, reading each parent world matrix
+	 * from a slot that was written earlier in the same pass.
+	 *
+	 * Nodes are identified by the value returned from AddNode(), which stays
+	 * valid when the arrays are reordered after a call to SetParent().
+	 *
+	 * UpdateWorldMatrices(ThreadPool&, Size) additionally keeps every subtree
+	 * stored contiguously, so that subtrees can be updated independently of
+	 * each other on different threads.
+	 *
+	 * \sa vlk::Transform3D
+	 */
+	class TransformGraph3D
+	{
+		public:
+		//! Parent of nodes at the root of the hierarchy.
+		static VLK_CXX14_CONSTEXPR Size NoParent = std::numeric_limits<Size>::max();
+
+		private:
+		std::vector<Vector3> translations;
+		std::vector<Quaternion> rotations;
+		std::vector<Vector3> scales;
+
+		//! Position of the parent of each node, or NoParent.
+		std::vector<Size> parents;
+		std::vector<Matrix4> worldMatrices;
+
+		//! Position of each node, indexed by node.
+		std::vector<Size> positions;
+
+		//! Node stored at each position.
+		std::vector<Size> nodes;
+
+		//! Number of nodes in the subtree at each position. Only valid if <tt>contiguous</tt> is true.
+		std::vector<Size> subtreeSizes;
+
+		//! False if some parent is stored after one of its children.
+		bool sorted;
+
+		//! False if some subtree is not stored contiguously in depth-first order.
+		bool contiguous;
+
+		inline void RequireNode(Size node) const
+		{
+			if (node >= positions.size())
+			{
+				throw std::out_of_range("TransformGraph3D node does not exist.");
+			}
+		}
+
+		//! Composes the local matrix of the node at <tt>position</tt>.
+		inline Matrix4 BuildMatrix(Size position) const
+		{
+			const Vector3& t = translations[position];
+			const Vector3& s = scales[position];
+
+			Matrix4 m(Matrix4::CreateRotation(rotations[position]));
+			m[0] *= s[0];
+			m[1] *= s[1];
+			m[2] *= s[2];
+			m[3] = VectorBase<4, Float>({t[0], t[1], t[2], 1.f});
+			return m;
+		}
+
+		/*!
+		 * \brief Reorders all arrays so that every subtree is stored
+		 * contiguously, in depth-first order, with parents first.
+		 */
+		inline void Sort()
+		{
+			const Size n = nodes.size();
+
+			// Children of each position, in position order
+			std::vector<Size> childStart(n + 1, 0);
+			for (Size i = 0; i < n; i++)
+			{
+				if (parents[i] != NoParent) childStart[parents[i] + 1]++;
+			}
+
+			for (Size i = 0; i < n; i++) childStart[i + 1] += childStart[i];
+
+			std::vector<Size> children(childStart[n]);
+			std::vector<Size> fill(childStart.begin(), childStart.end() - 1);
+			for (Size i = 0; i < n; i++)
+			{
+				if (parents[i] != NoParent) children[fill[parents[i]]++] = i;
+			}
+
+			std::vector<Size> order;
+			std::vector<Size> stack;
+			order.reserve(n);
+
+			for (Size root = 0; root < n; root++)
+			{
+				if (parents[root] != NoParent) continue;
+
+				stack.push_back(root);
+				while (!stack.empty())
+				{
+					Size p = stack.back();
+					stack.pop_back();
+					order.push_back(p);
+
+					for (Size c = childStart[p + 1]; c > childStart[p]; c--)
+					{
+						stack.push_back(children[c - 1]);
+					}
+				}
+			}
+
+			std::vector<Size> newPosition(n);
+			for (Size i = 0; i < n; i++) newPosition[order[i]] = i;
+
+			std::vector<Vector3> newTranslations(n);
+			std::vector<Quaternion> newRotations(n);
+			std::vector<Vector3> newScales(n);
+			std::vector<Size> newParents(n);
+			std::vector<Matrix4> newWorldMatrices(n);
+			std::vector<Size> newNodes(n);
+
+			for (Size i = 0; i < n; i++)
+			{
+				const Size o = order[i];
+				newTranslations[i] = translations[o];
+				newRotations[i] = rotations[o];
+				newScales[i] = scales[o];
+				newParents[i] = (parents[o] == NoParent) ? parents[o] : newPosition[parents[o]];
+				newWorldMatrices[i] = worldMatrices[o];
+				newNodes[i] = nodes[o];
+				positions[nodes[o]] = i;
+			}
+
+			translations.swap(newTranslations);
+			rotations.swap(newRotations);
+			scales.swap(newScales);
+			parents.swap(newParents);
+			worldMatrices.swap(newWorldMatrices);
+			nodes.swap(newNodes);
+
+			subtreeSizes.assign(n, 1);
+			for (Size i = n; i > 0; i--)
+			{
+				if (parents[i - 1] != NoParent) subtreeSizes[parents[i - 1]] += subtreeSizes[i - 1];
+			}
+
+			sorted = true;
+			contiguous = true;
+		}
+
+		//! Computes the world matrices of the nodes at positions <tt>[begin, end)</tt>, in order.
+		inline void UpdateRange(Size begin, Size end)
+		{
+			for (Size i = begin; i < end; i++)
+			{
+				if (parents[i] == NoParent) worldMatrices[i] = BuildMatrix(i);
+				else worldMatrices[i] = worldMatrices[parents[i]] * BuildMatrix(i);
+			}
+		}
+
+		public:
+		inline TransformGraph3D() :
+			translations(),
+			rotations(),
+			scales(),
+			parents(),
+			worldMatrices(),
+			positions(),
+			nodes(),
+			subtreeSizes(),
+			sorted(true),
+			contiguous(true)
+		{ }
+
+		inline TransformGraph3D(const TransformGraph3D&) = default;
+		inline TransformGraph3D(TransformGraph3D&&) = default;
+		inline TransformGraph3D& operator=(const TransformGraph3D&) = default;
+		inline TransformGraph3D& operator=(TransformGraph3D&&) = default;
+		inline ~TransformGraph3D() = default;
+
+		//! Returns the number of nodes in the graph.
+		inline Size Count() const { return nodes.size(); }
+
+		//! Reserves storage for <tt>n</tt> nodes.
+		inline void Reserve(Size n)
+		{
+			translations.reserve(n);
+			rotations.reserve(n);
+			scales.reserve(n);
+			parents.reserve(n);
+			worldMatrices.reserve(n);
+			positions.reserve(n);
+			nodes.reserve(n);
+		}
+
+		//! Removes every node from the graph.
+		inline void Clear()
+		{
+			translations.clear();
+			rotations.clear();
+			scales.clear();
+			parents.clear();
+			worldMatrices.clear();
+			positions.clear();
+			nodes.clear();
+			subtreeSizes.clear();
+			sorted = true;
+			contiguous = true;
+		}
+
+		/*!
+		 * \brief Adds an identity transform to the graph.
+		 *
+		 * \param parent The parent of the new node, or NoParent.
+		 *
+		 * \return The new node.
+		 *
+		 * \throws std::out_of_range If <tt>parent</tt> is not a node of this graph.
+		 */
+		inline Size AddNode(Size parent = NoParent)
+		{
+			if (parent != NoParent) RequireNode(parent);
+
+			const Size node = nodes.size();
+			translations.push_back(Vector3());
+			rotations.push_back(Quaternion());
+			scales.push_back(Vector3(1.f, 1.f, 1.f));
+			parents.push_back((parent == NoParent) ? Size(NoParent) : positions[parent]);
+			worldMatrices.push_back(Matrix4());
+			positions.push_back(node);
+			nodes.push_back(node);
+			subtreeSizes.push_back(1);
+			if (parent != NoParent) contiguous = false;
+			return node;
+		}
+
+		/*!
+		 * \brief Adds a node with the translation, rotation and scale of a Transform3D.
+		 *
+		 * The parent of <tt>t</tt> is ignored.
+		 *
+		 * \copydetails vlk::TransformGraph3D::AddNode(Size)
+		 */
+		inline Size AddNode(const Transform3D& t, Size parent = NoParent)
+		{
+			const Size node = AddNode(parent);
+			translations.back() = t.translation;
+			rotations.back() = t.rotation;
+			scales.back() = t.scale;
+			return node;
+		}
+
+		inline Vector3& Translation(Size node) { RequireNode(node); return translations[positions[node]]; }
+		inline const Vector3& Translation(Size node) const { RequireNode(node); return translations[positions[node]]; }
+
+		inline Quaternion& Rotation(Size node) { RequireNode(node); return rotations[positions[node]]; }
+		inline const Quaternion& Rotation(Size node) const { RequireNode(node); return rotations[positions[node]]; }
+
+		inline Vector3& Scale(Size node) { RequireNode(node); return scales[positions[node]]; }
+		inline const Vector3& Scale(Size node) const { RequireNode(node); return scales[positions[node]]; }
+
+		/*!
+		 * \brief Gets the parent of a node, or NoParent if it is a root node.
+		 *
+		 * \throws std::out_of_range If <tt>node</tt> is not a node of this graph.
+		 */
+		inline Size GetParent(Size node) const
+		{
+			RequireNode(node);
+			const Size p = parents[positions[node]];
+			return (p == NoParent) ? p : nodes[p];
+		}
+
+		/*!
+		 * \brief Sets the parent of a node.
+		 *
+		 * If the new parent is stored after the node, the graph is reordered
+		 * by the next call to UpdateWorldMatrices().
+		 *
+		 * \param node The node to reparent.
+		 * \param parent The new parent of <tt>node</tt> or NoParent to make it a root node.
+		 * Additionally, <tt>node</tt> must not be equal to <tt>parent</tt> or any parent of <tt>parent</tt>.
+		 *
+		 * \throws std::out_of_range If <tt>node</tt> or <tt>parent</tt> is not a node of this graph.
+		 * \throws std::runtime_error If <tt>node</tt> is already a parent of <tt>parent</tt>.
+		 */
+		inline void SetParent(Size node, Size parent)
+		{
+			RequireNode(node);
+			const Size position = positions[node];
+
+			contiguous = false;
+
+			if (parent == NoParent)
+			{
+				parents[position] = NoParent;
+				return;
+			}
+
+			RequireNode(parent);
+			for (Size p = positions[parent]; p != NoParent; p = parents[p])
+			{
+				if (p == position)
+				{
+					throw std::runtime_error("Circular transform hierarchy formed; A transform cannot be parented to itself.");
+				}
+			}
+
+			parents[position] = positions[parent];
+			if (positions[parent] > position) sorted = false;
+		}
+
+		/*!
+		 * \brief Gets a transformation matrix representing the transform of a node in local space.
+		 *
+		 * Equal to <tt>Transform3D::GetMatrix()</tt> for the same translation,
+		 * rotation and scale, but composed directly instead of multiplying three
+		 * matrices.
+		 *
+		 * \throws std::out_of_range If <tt>node</tt> is not a node of this graph.
+		 */
+		inline Matrix4 GetMatrix(Size node) const
+		{
+			RequireNode(node);
+			return BuildMatrix(positions[node]);
+		}
+
+		/*!
+		 * \brief Gets the world matrix of a node as of the last call to UpdateWorldMatrices().
+		 *
+		 * \throws std::out_of_range If <tt>node</tt> is not a node of this graph.
+		 */
+		inline const Matrix4& GetWorldMatrix(Size node) const
+		{
+			RequireNode(node);
+			return worldMatrices[positions[node]];
+		}
+
+		/*!
+		 * \brief Recomputes the world matrix of every node.
+		 *
+		 * Visits every node once, in storage order. Produces the same matrices
+		 * as <tt>Transform3D::GetWorldMatrix()</tt> for an equivalent hierarchy.
+		 */
+		inline void UpdateWorldMatrices()
+		{
+			if (!sorted) Sort();
+			UpdateRange(0, nodes.size());
+		}
+
+		/*!
+		 * \brief Recomputes the world matrix of every node on a thread pool.
+		 *
+		 * Every subtree of at most <tt>grain</tt> nodes whose parent is in a
+		 * larger subtree is updated as a single task. The few nodes above those
+		 * subtrees are updated on the calling thread first. Each world matrix is
+		 * computed with exactly the same operations as in UpdateWorldMatrices(),
+		 * so the results are identical.
+		 *
+		 * \param pool Thread pool to run the update on.
+		 * \param grain Largest number of nodes updated by a single task.
+		 */
+		inline void UpdateWorldMatrices(ThreadPool& pool, Size grain = 4096)
+		{
+			if (!contiguous) Sort();
+
+			const Size n = nodes.size();
+			grain = std::max<Size>(grain, 1);
+
+			// Neighbouring small subtrees are merged into ranges of up to grain nodes
+			std::vector<std::pair<Size, Size>> ranges;
+			for (Size i = 0; i < n;)
+			{
+				if (subtreeSizes[i] > grain)
+				{
+					UpdateRange(i, i + 1);
+					i++;
+					continue;
+				}
+
+				if (!ranges.empty() && ranges.back().second == i && i + subtreeSizes[i] - ranges.back().first <= grain)
+				{
+					ranges.back().second = i + subtreeSizes[i];
+				}
+				else
+				{
+					ranges.push_back(std::make_pair(i, i + subtreeSizes[i]));
+				}
+
+				i += subtreeSizes[i];
+			}
+
+			pool.ParallelFor(ranges.size(), 1, [this, &ranges](Size begin, Size end)
+			{
+				for (Size r = begin; r < end; r++) UpdateRange(ranges[r].first, ranges[r].second);
+			});
+		}
+
+		/*!
+		 * \brief Adds a set of Transform3D objects and their hierarchy to the graph.
+		 *
+		 * \param transforms The transforms to add. The parent of every transform
+		 * must either be <tt>nullptr</tt> or also be in <tt>transforms</tt>.
+		 *
+		 * \return The node created for each element of <tt>transforms</tt>, in the same order.
+		 *
+		 * \throws std::invalid_argument If the parent of a transform is not in <tt>transforms</tt>.
+		 */
+		inline std::vector<Size> Import(const std::vector<const Transform3D*>& transforms)
+		{
+			std::unordered_map<const Transform3D*, Size> lookup;
+			lookup.reserve(transforms.size());
+			for (Size i = 0; i < transforms.size(); i++) lookup[transforms[i]] = i;
+
+			for (const Transform3D* t : transforms)
+			{
+				if (t->GetParent() != nullptr && lookup.find(t->GetParent()) == lookup.end())
+				{
+					throw std::invalid_argument("The parent of every imported transform must also be imported.");
+				}
+			}
+
+			std::vector<Size> out(transforms.size());
+			Reserve(Count() + transforms.size());
+			for (Size i = 0; i < transforms.size(); i++) out[i] = AddNode(*transforms[i]);
+
+			// Transform3D hierarchies are acyclic, so no cycle check is needed here
+			for (Size i = 0; i < transforms.size(); i++)
+			{
+				const Transform3D* parent = transforms[i]->GetParent();
+				if (parent == nullptr) continue;
+
+				const Size p = positions[out[lookup[parent]]];
+				parents[positions[out[i]]] = p;
+				contiguous = false;
+				if (p > positions[out[i]]) sorted = false;
+			}
+
+			return out;
+		}
+
+		/*!
+		 * \brief Copies nodes of the graph and their hierarchy to Transform3D objects.
+		 *
+		 * The translation, rotation and scale of <tt>exported[i]</tt> are
+		 * written to <tt>transforms[i]</tt>, which is parented to the transform
+		 * written for the parent of <tt>exported[i]</tt>.
+		 *
+		 * \throws std::invalid_argument If <tt>exported</tt> and <tt>transforms</tt> differ in length,
+		 * or if the parent of a node is not in <tt>exported</tt>.
+		 * \throws std::out_of_range If an element of <tt>exported</tt> is not a node of this graph.
+		 */
+		inline void Export(const std::vector<Size>& exported, const std::vector<Transform3D*>& transforms) const
+		{
+			if (exported.size() != transforms.size())
+			{
+				throw std::invalid_argument("Export requires one transform for every node.");
+			}
+
+			std::vector<Transform3D*> lookup(nodes.size(), nullptr);
+			for (Size i = 0; i < exported.size(); i++)
+			{
+				RequireNode(exported[i]);
+				lookup[exported[i]] = transforms[i];
+			}
+
+			for (Size node : exported)
+			{
+				const Size parent = GetParent(node);
+				if (parent != NoParent && lookup[parent] == nullptr)
+				{
+					throw std::invalid_argument("The parent of every exported node must also be exported.");
+				}
+			}
+
+			// Detach first, so stale parents cannot trip the cycle check of SetParent
+			for (Transform3D* t : transforms) t->SetParent(nullptr);
+
+			for (Size i = 0; i < exported.size(); i++)
+			{
+				const Size position = positions[exported[i]];
+				transforms[i]->SetTranslation(translations[position]);
+				transforms[i]->SetRotation(rotations[position]);
+				transforms[i]->SetScale(scales[position]);
+
+				const Size parent = GetParent(exported[i]);
+				if (parent != NoParent) transforms[i]->SetParent(lookup[parent]);
+			}
+		}
+	};
+}
+
+#endif
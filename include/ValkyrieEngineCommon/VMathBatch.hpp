@@ -0,0 +1,386 @@
+/*!
+ * \file VMathBatch.hpp
+ * \brief Bulk overloads of the functions in VMath.hpp, operating on arrays.
+ *
+ *	Each function applies its VMath.hpp counterpart to every element of an
+ *	array, producing bit-identical results. <tt>Sqrt</tt>, <tt>Abs</tt>,
+ *	<tt>Floor</tt>, <tt>Ceil</tt>, <tt>Trunc</tt> and <tt>Round</tt> are
+ *	vectorized, with kernels for SSE2, AVX2 and AVX-512 chosen at runtime
+ *	through vlk::GetSIMDLevel(). The remaining functions have no exact
+ *	vector implementation and loop over the standard library; see
+ *	FastMath.hpp for vectorized approximations of trigonometric functions.
+ *
+ *	Every output array may be the same array as one of the inputs.
+ */
+
+#ifndef VLK_VMATH_BATCH_HPP
+#define VLK_VMATH_BATCH_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include "ValkyrieEngineCommon/SIMD.hpp"
+#include "ValkyrieEngineCommon/VMath.hpp"
+#include <cmath>
+
+namespace vlk
+{
+	/*!
+	 * \brief Element-wise operations and the loops that apply them with each
+	 * instruction set.
+	 */
+	namespace VMathKernels
+	{
+		struct SqrtOp
+		{
+			static inline Float Scalar(Float f) { return std::sqrt(f); }
+
+			#ifdef VLK_COMMON_RUNTIME_DISPATCH
+			VLK_COMMON_TARGET("sse2") static inline __m128 SSE2(__m128 v) { return _mm_sqrt_ps(v); }
+			VLK_COMMON_TARGET("avx2") static inline __m256 AVX2(__m256 v) { return _mm256_sqrt_ps(v); }
+
+			// _mm512_sqrt_ps merges into an undefined register, which GCC reports as uninitialized
+			VLK_COMMON_TARGET("avx512f") static inline __m512 AVX512(__m512 v) { return _mm512_maskz_sqrt_ps(0xFFFF, v); }
+			#endif
+		};
+
+		struct AbsOp
+		{
+			static inline Float Scalar(Float f) { return std::abs(f); }
+
+			#ifdef VLK_COMMON_RUNTIME_DISPATCH
+			VLK_COMMON_TARGET("sse2") static inline __m128 SSE2(__m128 v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+			VLK_COMMON_TARGET("avx2") static inline __m256 AVX2(__m256 v) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v); }
+			VLK_COMMON_TARGET("avx512f") static inline __m512 AVX512(__m512 v) { return _mm512_abs_ps(v); }
+			#endif
+		};
+
+		#ifdef VLK_COMMON_RUNTIME_DISPATCH
+		/*!
+		 * SSE2 has no rounding instruction. Floats of magnitude 2^23 or more
+		 * are already whole and are kept, smaller ones are truncated through
+		 * an integer conversion, and the sign is restored so -0.5 truncates
+		 * to -0.
+		 */
+		VLK_COMMON_TARGET("sse2") inline __m128 TruncSSE2(__m128 v)
+		{
+			const __m128 sign = _mm_set1_ps(-0.0f);
+			const __m128 small = _mm_cmplt_ps(_mm_andnot_ps(sign, v), _mm_set1_ps(8388608.0f));
+			const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+
+			return _mm_or_ps(_mm_or_ps(_mm_and_ps(small, t), _mm_andnot_ps(small, v)), _mm_and_ps(v, sign));
+		}
+		#endif
+
+		struct TruncOp
+		{
+			static inline Float Scalar(Float f) { return std::trunc(f); }
+
+			#ifdef VLK_COMMON_RUNTIME_DISPATCH
+			VLK_COMMON_TARGET("sse2") static inline __m128 SSE2(__m128 v) { return TruncSSE2(v); }
+			VLK_COMMON_TARGET("avx2") static inline __m256 AVX2(__m256 v) { return _mm256_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+			VLK_COMMON_TARGET("avx512f") static inline __m512 AVX512(__m512 v) { return _mm512_mask_roundscale_ps(v, 0xFFFF, v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+			#endif
+		};
+
+		struct FloorOp
+		{
+			static inline Float Scalar(Float f) { return std::floor(f); }
+
+			#ifdef VLK_COMMON_RUNTIME_DISPATCH
+			//! Truncation rounds negative values up, so those are lowered by one.
+			VLK_COMMON_TARGET("sse2") static inline __m128 SSE2(__m128 v)
+			{
+				const __m128 t = TruncSSE2(v);
+				return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, v), _mm_set1_ps(1.0f)));
+			}
+
+			VLK_COMMON_TARGET("avx2") static inline __m256 AVX2(__m256 v) { return _mm256_round_ps(v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+			VLK_COMMON_TARGET("avx512f") static inline __m512 AVX512(__m512 v) { return _mm512_mask_roundscale_ps(v, 0xFFFF, v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+			#endif
+		};
+
+		struct CeilOp
+		{
+			static inline Float Scalar(Float f) { return std::ceil(f); }
+
+			#ifdef VLK_COMMON_RUNTIME_DISPATCH
+			//! Truncation rounds positive values down, so those are raised by one.
+			VLK_COMMON_TARGET("sse2") static inline __m128 SSE2(__m128 v)
+			{
+				const __m128 t = TruncSSE2(v);
+				const __m128 c = _mm_add_ps(t, _mm_and_ps(_mm_cmplt_ps(t, v), _mm_set1_ps(1.0f)));
+
+				// Adding zero turns -0 into +0
+				return _mm_or_ps(c, _mm_and_ps(v, _mm_set1_ps(-0.0f)));
+			}
+
+			VLK_COMMON_TARGET("avx2") static inline __m256 AVX2(__m256 v) { return _mm256_round_ps(v, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC); }
+			VLK_COMMON_TARGET("avx512f") static inline __m512 AVX512(__m512 v) { return _mm512_mask_roundscale_ps(v, 0xFFFF, v, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC); }
+			#endif
+		};
+
+		/*!
+		 * Rounds halfway cases away from zero like <tt>std::round</tt>, which
+		 * no rounding mode does. The fraction <tt>v - trunc(v)</tt> is exact,
+		 * so adding one away from zero wherever it is at least a half never
+		 * suffers from the double rounding of <tt>trunc(v + 0.5)</tt>. The
+		 * result always has the sign of <tt>v</tt>, which is restored after
+		 * adding zero turns -0 into +0.
+		 */
+		struct RoundOp
+		{
+			static inline Float Scalar(Float f) { return std::round(f); }
+
+			#ifdef VLK_COMMON_RUNTIME_DISPATCH
+			VLK_COMMON_TARGET("sse2") static inline __m128 SSE2(__m128 v)
+			{
+				const __m128 sign = _mm_set1_ps(-0.0f);
+				const __m128 t = TruncSSE2(v);
+				const __m128 up = _mm_cmpge_ps(_mm_andnot_ps(sign, _mm_sub_ps(v, t)), _mm_set1_ps(0.5f));
+				const __m128 vSign = _mm_and_ps(v, sign);
+				return _mm_or_ps(_mm_add_ps(t, _mm_and_ps(up, _mm_or_ps(_mm_set1_ps(1.0f), vSign))), vSign);
+			}
+
+			VLK_COMMON_TARGET("avx2") static inline __m256 AVX2(__m256 v)
+			{
+				const __m256 sign = _mm256_set1_ps(-0.0f);
+				const __m256 t = _mm256_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+				const __m256 up = _mm256_cmp_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(v, t)), _mm256_set1_ps(0.5f), _CMP_GE_OQ);
+				const __m256 vSign = _mm256_and_ps(v, sign);
+				return _mm256_or_ps(_mm256_add_ps(t, _mm256_and_ps(up, _mm256_or_ps(_mm256_set1_ps(1.0f), vSign))), vSign);
+			}
+
+			VLK_COMMON_TARGET("avx512f") static inline __m512 AVX512(__m512 v)
+			{
+				const __m512i sign = _mm512_set1_epi32(static_cast<int>(0x80000000u));
+				const __m512 t = _mm512_mask_roundscale_ps(v, 0xFFFF, v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+				const __mmask16 up = _mm512_cmp_ps_mask(_mm512_abs_ps(_mm512_sub_ps(v, t)), _mm512_set1_ps(0.5f), _CMP_GE_OQ);
+				const __m512 one = _mm512_castsi512_ps(_mm512_or_epi32(_mm512_castps_si512(_mm512_set1_ps(1.0f)), _mm512_and_epi32(_mm512_castps_si512(v), sign)));
+				return _mm512_mask_add_ps(t, up, t, one);
+			}
+			#endif
+		};
+
+		template <typename Op>
+		inline void RunScalar(const Float* in, Float* out, Size n)
+		{
+			for (Size i = 0; i < n; i++) out[i] = Op::Scalar(in[i]);
+		}
+
+		#ifdef VLK_COMMON_RUNTIME_DISPATCH
+		template <typename Op>
+		VLK_COMMON_TARGET("sse2") inline void RunSSE2(const Float* in, Float* out, Size n)
+		{
+			Size i = 0;
+			for (; i + 4 <= n; i += 4) _mm_storeu_ps(out + i, Op::SSE2(_mm_loadu_ps(in + i)));
+			for (; i < n; i++) out[i] = Op::Scalar(in[i]);
+		}
+
+		template <typename Op>
+		VLK_COMMON_TARGET("avx2") inline void RunAVX2(const Float* in, Float* out, Size n)
+		{
+			Size i = 0;
+			for (; i + 8 <= n; i += 8) _mm256_storeu_ps(out + i, Op::AVX2(_mm256_loadu_ps(in + i)));
+			for (; i < n; i++) out[i] = Op::Scalar(in[i]);
+		}
+
+		template <typename Op>
+		VLK_COMMON_TARGET("avx512f") inline void RunAVX512(const Float* in, Float* out, Size n)
+		{
+			Size i = 0;
+			for (; i + 16 <= n; i += 16) _mm512_storeu_ps(out + i, Op::AVX512(_mm512_loadu_ps(in + i)));
+
+			// The remainder is handled with masked loads and stores, which never touch memory past the end
+			if (i < n)
+			{
+				const __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1);
+				_mm512_mask_storeu_ps(out + i, mask, Op::AVX512(_mm512_maskz_loadu_ps(mask, in + i)));
+			}
+		}
+		#endif
+
+		//! Applies an operation to every element with the widest kernel the CPU supports.
+		template <typename Op>
+		inline void Run(const Float* in, Float* out, Size n)
+		{
+			#ifdef VLK_COMMON_RUNTIME_DISPATCH
+			switch (GetSIMDLevel())
+			{
+				case SIMDLevel::AVX512: RunAVX512<Op>(in, out, n); return;
+				case SIMDLevel::AVX2: RunAVX2<Op>(in, out, n); return;
+				case SIMDLevel::SSE2: RunSSE2<Op>(in, out, n); return;
+				case SIMDLevel::Scalar: break;
+			}
+			#endif
+
+			RunScalar<Op>(in, out, n);
+		}
+	}
+
+	/*!
+	 * \brief Calculates the square root of every element of an array.
+	 *
+	 * \param in An array of <tt>n</tt> positive numbers.
+	 * \param out An array of at least <tt>n</tt> floats.
+	 * \param n The number of elements.
+	 *
+	 * \sa vlk::Sqrt()
+	 */
+	inline void Sqrt(const Float* in, Float* out, Size n)
+	{
+		VMathKernels::Run<VMathKernels::SqrtOp>(in, out, n);
+	}
+
+	/*!
+	 * \brief Calculates the magnitude of every element of an array.
+	 *
+	 * \sa vlk::Abs()
+	 */
+	inline void Abs(const Float* in, Float* out, Size n)
+	{
+		VMathKernels::Run<VMathKernels::AbsOp>(in, out, n);
+	}
+
+	/*!
+	 * \brief Rounds every element of an array down to the nearest whole number.
+	 *
+	 * \sa vlk::Floor()
+	 */
+	inline void Floor(const Float* in, Float* out, Size n)
+	{
+		VMathKernels::Run<VMathKernels::FloorOp>(in, out, n);
+	}
+
+	/*!
+	 * \brief Rounds every element of an array up to the nearest whole number.
+	 *
+	 * \sa vlk::Ceil()
+	 */
+	inline void Ceil(const Float* in, Float* out, Size n)
+	{
+		VMathKernels::Run<VMathKernels::CeilOp>(in, out, n);
+	}
+
+	/*!
+	 * \brief Rounds every element of an array towards zero to the nearest
+	 * whole number.
+	 *
+	 * \sa vlk::Trunc()
+	 */
+	inline void Trunc(const Float* in, Float* out, Size n)
+	{
+		VMathKernels::Run<VMathKernels::TruncOp>(in, out, n);
+	}
+
+	/*!
+	 * \brief Rounds every element of an array to the nearest whole number,
+	 * rounding halfway cases away from zero.
+	 *
+	 * \sa vlk::Round()
+	 */
+	inline void Round(const Float* in, Float* out, Size n)
+	{
+		VMathKernels::Run<VMathKernels::RoundOp>(in, out, n);
+	}
+
+	/*!
+	 * \brief Calculates the sine of every angle of an array.
+	 *
+	 * Not vectorized, see vlk::SinCos(const Float*, Float*, Float*, Size).
+	 *
+	 * \sa vlk::Sin()
+	 */
+	inline void Sin(const Float* in, Float* out, Size n)
+	{
+		for (Size i = 0; i < n; i++) out[i] = std::sin(in[i]);
+	}
+
+	/*!
+	 * \brief Calculates the cosine of every angle of an array.
+	 *
+	 * Not vectorized, see vlk::SinCos(const Float*, Float*, Float*, Size).
+	 *
+	 * \sa vlk::Cos()
+	 */
+	inline void Cos(const Float* in, Float* out, Size n)
+	{
+		for (Size i = 0; i < n; i++) out[i] = std::cos(in[i]);
+	}
+
+	/*!
+	 * \brief Calculates the tangent of every angle of an array. Not vectorized.
+	 *
+	 * \sa vlk::Tan()
+	 */
+	inline void Tan(const Float* in, Float* out, Size n)
+	{
+		for (Size i = 0; i < n; i++) out[i] = std::tan(in[i]);
+	}
+
+	/*!
+	 * \brief Calculates the arc sine of every element of an array. Not vectorized.
+	 *
+	 * \sa vlk::ASin()
+	 */
+	inline void ASin(const Float* in, Float* out, Size n)
+	{
+		for (Size i = 0; i < n; i++) out[i] = std::asin(in[i]);
+	}
+
+	/*!
+	 * \brief Calculates the arc cosine of every element of an array.
+	 *
+	 * Not vectorized, see vlk::FastACos(const Float*, Float*, Size).
+	 *
+	 * \sa vlk::ACos()
+	 */
+	inline void ACos(const Float* in, Float* out, Size n)
+	{
+		for (Size i = 0; i < n; i++) out[i] = std::acos(in[i]);
+	}
+
+	/*!
+	 * \brief Calculates the arc tangent of every element of an array. Not vectorized.
+	 *
+	 * \sa vlk::ATan()
+	 */
+	inline void ATan(const Float* in, Float* out, Size n)
+	{
+		for (Size i = 0; i < n; i++) out[i] = std::atan(in[i]);
+	}
+
+	/*!
+	 * \brief Calculates the arc tangent of every coordinate of two arrays.
+	 *
+	 * Not vectorized, see vlk::FastATan2(const Float*, const Float*, Float*, Size).
+	 *
+	 * \sa vlk::ATan2()
+	 */
+	inline void ATan2(const Float* y, const Float* x, Float* out, Size n)
+	{
+		for (Size i = 0; i < n; i++) out[i] = std::atan2(y[i], x[i]);
+	}
+
+	/*!
+	 * \brief Raises every element of an array to the power of the
+	 * corresponding element of another. Not vectorized.
+	 *
+	 * \sa vlk::Pow()
+	 */
+	inline void Pow(const Float* f, const Float* e, Float* out, Size n)
+	{
+		for (Size i = 0; i < n; i++) out[i] = std::pow(f[i], e[i]);
+	}
+
+	/*!
+	 * \brief Calculates the floating point remainder of every element of an
+	 * array divided by the corresponding element of another. Not vectorized.
+	 *
+	 * \sa vlk::FMod()
+	 */
+	inline void FMod(const Float* a, const Float* b, Float* out, Size n)
+	{
+		for (Size i = 0; i < n; i++) out[i] = std::fmod(a[i], b[i]);
+	}
+}
+
+#endif
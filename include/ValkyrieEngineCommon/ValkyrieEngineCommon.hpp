@@ -1,9 +1,17 @@
 #ifndef VLK_COMMON_HPP
 #define VLK_COMMON_HPP
 
+#include "ValkyrieEngineCommon/Epoch.hpp"
+#include "ValkyrieEngineCommon/FastMath.hpp"
+#include "ValkyrieEngineCommon/LookupTable.hpp"
+#include "ValkyrieEngineCommon/ReadMostlyMap.hpp"
 #include "ValkyrieEngineCommon/Vector.hpp"
+#include "ValkyrieEngineCommon/VectorStream.hpp"
+#include "ValkyrieEngineCommon/ThreadPool.hpp"
 #include "ValkyrieEngineCommon/Transform.hpp"
+#include "ValkyrieEngineCommon/TransformGraph.hpp"
 #include "ValkyrieEngineCommon/Quaternion.hpp"
 #include "ValkyrieEngineCommon/Types.hpp"
+#include "ValkyrieEngineCommon/VMathBatch.hpp"
 
 #endif
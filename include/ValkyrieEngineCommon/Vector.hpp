@@ -3,6 +3,9 @@
 
 #include "ValkyrieEngine/ValkyrieDefs.hpp"
 #include "ValkyrieEngineCommon/VMath.hpp"
+#include "ValkyrieEngineCommon/FastMath.hpp"
+#include "ValkyrieEngineCommon/SIMD.hpp"
+#include <limits>
 #include <type_traits>
 
 namespace vlk
@@ -49,28 +52,28 @@ namespace vlk
 
 		VLK_CXX14_CONSTEXPR inline SelfType operator+(const SelfType& rhs) const
 		{
-			ArrayType tmp;
+			ArrayType tmp {};
 			for (Size i = 0; i < N; i++) tmp[i] = data[i] + rhs[i];
 			return VectorBase<N, Val>(tmp);
 		}
 
 		VLK_CXX14_CONSTEXPR inline SelfType operator-(const SelfType& rhs) const
 		{
-			ArrayType tmp;
+			ArrayType tmp {};
 			for (Size i = 0; i < N; i++) tmp[i] = data[i] - rhs[i];
 			return VectorBase<N, Val>(tmp);
 		}
 
 		VLK_CXX14_CONSTEXPR inline SelfType operator*(const Val v) const
 		{
-			ArrayType tmp;
+			ArrayType tmp {};
 			for (Size i = 0; i < N; i++) tmp[i] = data[i] * v;
 			return VectorBase<N, Val>(tmp);
 		}
 
 		VLK_CXX14_CONSTEXPR inline SelfType operator/(const Val v) const
 		{
-			ArrayType tmp;
+			ArrayType tmp {};
 			for (Size i = 0; i < N; i++) tmp[i] = data[i] / v;
 			return VectorBase<N, Val>(tmp);
 		}
@@ -126,6 +129,214 @@ namespace vlk
 		VLK_CXX14_CONSTEXPR inline const Val& operator[](Size i) const { return data[i]; }
 	};
 
+	/*!
+	 * \brief 16-byte aligned specialization of VectorBase for four floats.
+	 *
+	 * Backs Vector4, Quaternion, Color and the columns of Matrix4. Arithmetic
+	 * is performed with SSE instructions at runtime when available and with
+	 * the same scalar loops as the generic template otherwise, including
+	 * during constant evaluation.
+	 */
+	template <>
+	class VectorBase<4, Float>
+	{
+		public:
+		typedef VectorBase<4, Float> SelfType;
+		typedef Float ValueType;
+		typedef Float ArrayType[4];
+
+		alignas(16) ArrayType data;
+
+		VLK_CXX14_CONSTEXPR inline VectorBase<4, Float>() :
+			data {}
+		{
+			for (Size i = 0; i < 4; i++)
+			{
+				data[i] = 0.0f;
+			}
+		}
+
+		VLK_CXX14_CONSTEXPR inline VectorBase<4, Float>(const ArrayType& arr) :
+			data {}
+		{
+			for (Size i = 0; i < 4; i++)
+			{
+				data[i] = arr[i];
+			}
+		}
+
+		VLK_CXX14_CONSTEXPR inline VectorBase<4, Float>(const SelfType&) = default;
+		VLK_CXX14_CONSTEXPR inline VectorBase<4, Float>(SelfType&&) = default;
+		VLK_CXX14_CONSTEXPR inline SelfType& operator=(const SelfType&) = default;
+		VLK_CXX14_CONSTEXPR inline SelfType& operator=(SelfType&&) = default;
+		VLK_CXX20_CONSTEXPR inline ~VectorBase<4, Float>() = default;
+
+		VLK_CXX14_CONSTEXPR inline SelfType operator+(const SelfType& rhs) const
+		{
+			#ifdef VLK_COMMON_SSE2
+			if (!VLK_IS_CONSTANT_EVALUATED())
+			{
+				return FromSSE(_mm_add_ps(ToSSE(), rhs.ToSSE()));
+			}
+			#endif
+
+			ArrayType tmp {};
+			for (Size i = 0; i < 4; i++) tmp[i] = data[i] + rhs[i];
+			return SelfType(tmp);
+		}
+
+		VLK_CXX14_CONSTEXPR inline SelfType operator-(const SelfType& rhs) const
+		{
+			#ifdef VLK_COMMON_SSE2
+			if (!VLK_IS_CONSTANT_EVALUATED())
+			{
+				return FromSSE(_mm_sub_ps(ToSSE(), rhs.ToSSE()));
+			}
+			#endif
+
+			ArrayType tmp {};
+			for (Size i = 0; i < 4; i++) tmp[i] = data[i] - rhs[i];
+			return SelfType(tmp);
+		}
+
+		VLK_CXX14_CONSTEXPR inline SelfType operator*(const Float v) const
+		{
+			#ifdef VLK_COMMON_SSE2
+			if (!VLK_IS_CONSTANT_EVALUATED())
+			{
+				return FromSSE(_mm_mul_ps(ToSSE(), _mm_set1_ps(v)));
+			}
+			#endif
+
+			ArrayType tmp {};
+			for (Size i = 0; i < 4; i++) tmp[i] = data[i] * v;
+			return SelfType(tmp);
+		}
+
+		VLK_CXX14_CONSTEXPR inline SelfType operator/(const Float v) const
+		{
+			#ifdef VLK_COMMON_SSE2
+			if (!VLK_IS_CONSTANT_EVALUATED())
+			{
+				return FromSSE(_mm_div_ps(ToSSE(), _mm_set1_ps(v)));
+			}
+			#endif
+
+			ArrayType tmp {};
+			for (Size i = 0; i < 4; i++) tmp[i] = data[i] / v;
+			return SelfType(tmp);
+		}
+
+		VLK_CXX14_CONSTEXPR inline SelfType& operator+=(const SelfType& rhs)
+		{
+			#ifdef VLK_COMMON_SSE2
+			if (!VLK_IS_CONSTANT_EVALUATED())
+			{
+				_mm_store_ps(data, _mm_add_ps(ToSSE(), rhs.ToSSE()));
+				return *this;
+			}
+			#endif
+
+			for (Size i = 0; i < 4; i++) data[i] += rhs[i];
+			return *this;
+		}
+
+		VLK_CXX14_CONSTEXPR inline SelfType& operator-=(const SelfType& rhs)
+		{
+			#ifdef VLK_COMMON_SSE2
+			if (!VLK_IS_CONSTANT_EVALUATED())
+			{
+				_mm_store_ps(data, _mm_sub_ps(ToSSE(), rhs.ToSSE()));
+				return *this;
+			}
+			#endif
+
+			for (Size i = 0; i < 4; i++) data[i] -= rhs[i];
+			return *this;
+		}
+
+		VLK_CXX14_CONSTEXPR inline SelfType& operator*=(const Float v)
+		{
+			#ifdef VLK_COMMON_SSE2
+			if (!VLK_IS_CONSTANT_EVALUATED())
+			{
+				_mm_store_ps(data, _mm_mul_ps(ToSSE(), _mm_set1_ps(v)));
+				return *this;
+			}
+			#endif
+
+			for (Size i = 0; i < 4; i++) data[i] *= v;
+			return *this;
+		}
+
+		VLK_CXX14_CONSTEXPR inline SelfType& operator/=(const Float v)
+		{
+			#ifdef VLK_COMMON_SSE2
+			if (!VLK_IS_CONSTANT_EVALUATED())
+			{
+				_mm_store_ps(data, _mm_div_ps(ToSSE(), _mm_set1_ps(v)));
+				return *this;
+			}
+			#endif
+
+			for (Size i = 0; i < 4; i++) data[i] /= v;
+			return *this;
+		}
+
+		VLK_CXX14_CONSTEXPR inline bool operator==(const SelfType& rhs) const
+		{
+			#ifdef VLK_COMMON_SSE2
+			if (!VLK_IS_CONSTANT_EVALUATED())
+			{
+				return _mm_movemask_ps(_mm_cmpeq_ps(ToSSE(), rhs.ToSSE())) == 0xF;
+			}
+			#endif
+
+			for (Size i = 0; i < 4; i++)
+			{
+				if (data[i] != rhs[i]) return false;
+			}
+
+			return true;
+		}
+
+		VLK_CXX14_CONSTEXPR inline bool operator!=(const SelfType& rhs) const
+		{
+			#ifdef VLK_COMMON_SSE2
+			if (!VLK_IS_CONSTANT_EVALUATED())
+			{
+				return _mm_movemask_ps(_mm_cmpneq_ps(ToSSE(), rhs.ToSSE())) != 0;
+			}
+			#endif
+
+			for (Size i = 0; i < 4; i++)
+			{
+				if (data[i] != rhs[i]) return true;
+			}
+
+			return false;
+		}
+
+		VLK_CXX14_CONSTEXPR inline Float* Data() { return data; }
+		VLK_CXX14_CONSTEXPR inline const Float* Data() const { return data; }
+
+		VLK_CXX14_CONSTEXPR inline Float& operator[](Size i) { return data[i]; }
+		VLK_CXX14_CONSTEXPR inline const Float& operator[](Size i) const { return data[i]; }
+
+		#ifdef VLK_COMMON_SSE2
+		//! Loads this vector into an SSE register.
+		inline __m128 ToSSE() const { return _mm_load_ps(data); }
+
+		//! Constructs a vector from the contents of an SSE register.
+		static inline SelfType FromSSE(__m128 v)
+		{
+			SelfType tmp;
+			_mm_store_ps(tmp.data, v);
+			return tmp;
+		}
+		#endif
+	};
+
 	template <typename Val = Int>
 	class Point
 	{
@@ -266,8 +477,10 @@ namespace vlk
 		/*!
 		 * \brief Returns a unit vector with the same direction as \c v
 		 *
-		 * \warning If the provided vector has a length of zero, both components
+		 * \warning If the provided vector has a length of zero, all components
 		 * of the returned vector will be <tt>NaN</tt>
+		 *
+		 * \sa #NormalizedSafe, #FastNormalized
 		 */
 		static inline Vector2 Normalized(const Vector2& v)
 		{
@@ -284,6 +497,50 @@ namespace vlk
 			return ForceCXPR(static_cast<Vector2>(v) / Vector2::Length(v));
 		}
 
+		/*!
+		 * \brief Returns a unit vector with the same direction as \c v, or
+		 * \c fallback if \c v has no direction.
+		 *
+		 * Equal to #Normalized except where its result would not be finite,
+		 * that is when the length of \c v is zero, infinite or <tt>NaN</tt>.
+		 * \c fallback is also returned when the square length of \c v
+		 * overflows, where #Normalized returns zero.
+		 */
+		static inline Vector2 NormalizedSafe(const Vector2& v, const Vector2& fallback = Zero())
+		{
+			const Float length = Length(v);
+			return (length > 0.0f && length <= std::numeric_limits<Float>::max()) ? v / length : fallback;
+		}
+
+		/*!
+		 * \brief Approximates a unit vector with the same direction as \c v.
+		 *
+		 * Multiplies by vlk::FastInvSqrt() of the square length instead of
+		 * taking a square root and dividing, so the length of the result
+		 * differs from 1 by at most 1e-6. Recent x86 cores divide about as
+		 * quickly, so whether this is faster than #Normalized depends on the
+		 * CPU.
+		 *
+		 * Vectors whose square length is not a normal float, such as the zero
+		 * vector, produce the zero vector instead of <tt>NaN</tt>.
+		 */
+		static inline Vector2 FastNormalized(const Vector2& v)
+		{
+			const Float sq = Dot(v, v);
+			return (sq >= std::numeric_limits<Float>::min() && sq <= std::numeric_limits<Float>::max()) ? v * FastInvSqrt(sq) : Zero();
+		}
+
+		/*!
+		 * \brief Approximates a unit vector for every vector of an array.
+		 *
+		 * Equivalent to <tt>out[i] = FastNormalized(in[i])</tt> for every
+		 * <tt>i</tt>. <tt>out</tt> may be the same array as <tt>in</tt>.
+		 */
+		static inline void FastNormalized(const Vector2* in, Vector2* out, Size n)
+		{
+			for (Size i = 0; i < n; i++) out[i] = FastNormalized(in[i]);
+		}
+
 		/*!
 		 * \brief Returns the distance between two vectors
 		 */
@@ -520,8 +777,10 @@ namespace vlk
 		/*!
 		 * \brief Returns a unit vector with the same direction as \c v
 		 *
-		 * \warning If the provided vector has a length of zero, both components
+		 * \warning If the provided vector has a length of zero, all components
 		 * of the returned vector will be <tt>NaN</tt>
+		 *
+		 * \sa #NormalizedSafe, #FastNormalized
 		 */
 		static inline Vector3 Normalized(const Vector3& v)
 		{
@@ -538,6 +797,52 @@ namespace vlk
 			return ForceCXPR(v.value / Length(v).value);
 		}
 
+		/*!
+		 * \brief Returns a unit vector with the same direction as \c v, or
+		 * \c fallback if \c v has no direction.
+		 *
+		 * Equal to #Normalized except where its result would not be finite,
+		 * that is when the length of \c v is zero, infinite or <tt>NaN</tt>.
+		 * \c fallback is also returned when the square length of \c v
+		 * overflows, where #Normalized returns zero.
+		 */
+		static inline Vector3 NormalizedSafe(const Vector3& v, const Vector3& fallback = Zero())
+		{
+			const Float length = Length(v);
+			return (length > 0.0f && length <= std::numeric_limits<Float>::max()) ? v / length : fallback;
+		}
+
+		/*!
+		 * \brief Approximates a unit vector with the same direction as \c v.
+		 *
+		 * Multiplies by vlk::FastInvSqrt() of the square length instead of
+		 * taking a square root and dividing, so the length of the result
+		 * differs from 1 by at most 1e-6. Recent x86 cores divide about as
+		 * quickly, so whether this is faster than #Normalized depends on the
+		 * CPU.
+		 *
+		 * Vectors whose square length is not a normal float, such as the zero
+		 * vector, produce the zero vector instead of <tt>NaN</tt>.
+		 */
+		static inline Vector3 FastNormalized(const Vector3& v)
+		{
+			const Float sq = Dot(v, v);
+			return (sq >= std::numeric_limits<Float>::min() && sq <= std::numeric_limits<Float>::max()) ? v * FastInvSqrt(sq) : Zero();
+		}
+
+		/*!
+		 * \brief Approximates a unit vector for every vector of an array.
+		 *
+		 * Equivalent to <tt>out[i] = FastNormalized(in[i])</tt> for every
+		 * <tt>i</tt>. <tt>out</tt> may be the same array as <tt>in</tt>.
+		 *
+		 * \sa vlk::Vector3Stream::FastNormalized()
+		 */
+		static inline void FastNormalized(const Vector3* in, Vector3* out, Size n)
+		{
+			for (Size i = 0; i < n; i++) out[i] = FastNormalized(in[i]);
+		}
+
 		/*!
 		 * \brief Linearly interpolates between two vectors
 		 */
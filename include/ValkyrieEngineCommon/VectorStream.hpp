@@ -0,0 +1,475 @@
+/*!
+ * \file VectorStream.hpp
+ * \brief Structure-of-arrays containers for batch vector math.
+ */
+
+#ifndef VLK_VECTOR_STREAM_HPP
+#define VLK_VECTOR_STREAM_HPP
+
+#include "ValkyrieEngine/ValkyrieDefs.hpp"
+#include "ValkyrieEngineCommon/SIMD.hpp"
+#include "ValkyrieEngineCommon/Vector.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace vlk
+{
+	/*!
+	 * \brief A structure-of-arrays container of 3-dimensional vectors.
+	 *
+	 * The X, Y and Z components of every vector are stored in three separate,
+	 * contiguous arrays, each aligned to a 64-byte boundary and padded to a
+	 * whole number of cache lines. This lets the bulk kernels below process
+	 * several vectors per instruction where a <tt>std::vector<Vector3></tt>
+	 * would process one.
+	 *
+	 * Every kernel writes its results to an output argument, which may be the
+	 * same object as any of its inputs. Output streams are resized to match
+	 * their inputs.
+	 */
+	class Vector3Stream
+	{
+		public:
+		//! Alignment, in bytes, of each component array.
+		static VLK_CXX14_CONSTEXPR Size Alignment = 64;
+
+		private:
+		static VLK_CXX14_CONSTEXPR Size BlockSize = Alignment / sizeof(Float);
+
+		std::unique_ptr<Float[]> buffer;
+		Float* x;
+		Float* y;
+		Float* z;
+		Size count;
+		Size stride;
+
+		void Allocate(Size n)
+		{
+			Size newStride = ((n + BlockSize - 1) / BlockSize) * BlockSize;
+
+			if (newStride != stride || !buffer)
+			{
+				// Over-allocate by one block so the first array can be aligned manually
+				std::unique_ptr<Float[]> newBuffer(new Float[newStride * 3 + BlockSize]());
+				std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(newBuffer.get());
+				Size offset = ((Alignment - (addr % Alignment)) % Alignment) / sizeof(Float);
+				Float* newX = newBuffer.get() + offset;
+
+				Size keep = std::min(count, n);
+				std::copy(x, x + keep, newX);
+				std::copy(y, y + keep, newX + newStride);
+				std::copy(z, z + keep, newX + newStride * 2);
+
+				buffer = std::move(newBuffer);
+				stride = newStride;
+				x = newX;
+				y = newX + newStride;
+				z = newX + newStride * 2;
+			}
+
+			count = n;
+		}
+
+		static void RequireSameCount(const Vector3Stream& lhs, const Vector3Stream& rhs)
+		{
+			if (lhs.count != rhs.count)
+			{
+				throw std::invalid_argument("Vector3Stream arguments must contain the same number of vectors.");
+			}
+		}
+
+		public:
+		inline Vector3Stream() :
+			buffer(),
+			x(nullptr),
+			y(nullptr),
+			z(nullptr),
+			count(0),
+			stride(0)
+		{ }
+
+		//! Creates a stream of <tt>n</tt> zero vectors.
+		inline explicit Vector3Stream(Size n) :
+			Vector3Stream()
+		{
+			Allocate(n);
+		}
+
+		//! Converts an array-of-structures vector list to a stream.
+		inline explicit Vector3Stream(const std::vector<Vector3>& vectors) :
+			Vector3Stream(vectors.size())
+		{
+			for (Size i = 0; i < count; i++)
+			{
+				x[i] = vectors[i][0];
+				y[i] = vectors[i][1];
+				z[i] = vectors[i][2];
+			}
+		}
+
+		inline Vector3Stream(const Vector3Stream& other) :
+			Vector3Stream(other.count)
+		{
+			std::copy(other.x, other.x + count, x);
+			std::copy(other.y, other.y + count, y);
+			std::copy(other.z, other.z + count, z);
+		}
+
+		inline Vector3Stream(Vector3Stream&& other) :
+			Vector3Stream()
+		{
+			Swap(other);
+		}
+
+		inline Vector3Stream& operator=(const Vector3Stream& other)
+		{
+			if (this != &other)
+			{
+				Vector3Stream tmp(other);
+				Swap(tmp);
+			}
+
+			return *this;
+		}
+
+		inline Vector3Stream& operator=(Vector3Stream&& other)
+		{
+			Swap(other);
+			return *this;
+		}
+
+		~Vector3Stream() = default;
+
+		//! Exchanges the contents of two streams without copying.
+		inline void Swap(Vector3Stream& other)
+		{
+			std::swap(buffer, other.buffer);
+			std::swap(x, other.x);
+			std::swap(y, other.y);
+			std::swap(z, other.z);
+			std::swap(count, other.count);
+			std::swap(stride, other.stride);
+		}
+
+		//! Returns the number of vectors in this stream.
+		inline Size Count() const { return count; }
+
+		/*!
+		 * \brief Changes the number of vectors in this stream.
+		 *
+		 * Existing vectors are preserved up to the new count, new vectors are
+		 * zero-initialized.
+		 */
+		inline void Resize(Size n)
+		{
+			Size old = count;
+			Allocate(n);
+
+			for (Size i = old; i < n; i++)
+			{
+				x[i] = 0.0f;
+				y[i] = 0.0f;
+				z[i] = 0.0f;
+			}
+		}
+
+		inline Float* X() { return x; }
+		inline Float* Y() { return y; }
+		inline Float* Z() { return z; }
+
+		inline const Float* X() const { return x; }
+		inline const Float* Y() const { return y; }
+		inline const Float* Z() const { return z; }
+
+		//! Gets the vector at index <tt>i</tt>.
+		inline Vector3 Get(Size i) const { return Vector3(x[i], y[i], z[i]); }
+
+		//! Sets the vector at index <tt>i</tt>.
+		inline void Set(Size i, const Vector3& v)
+		{
+			x[i] = v[0];
+			y[i] = v[1];
+			z[i] = v[2];
+		}
+
+		//! Converts this stream to an array-of-structures vector list.
+		inline std::vector<Vector3> ToVector() const
+		{
+			std::vector<Vector3> out(count);
+			for (Size i = 0; i < count; i++) out[i] = Get(i);
+			return out;
+		}
+
+		/*!
+		 * \brief Adds corresponding vectors of two streams.
+		 *
+		 * \throws std::invalid_argument If <tt>lhs</tt> and <tt>rhs</tt> differ in length.
+		 */
+		static inline void Add(const Vector3Stream& lhs, const Vector3Stream& rhs, Vector3Stream& out)
+		{
+			RequireSameCount(lhs, rhs);
+			out.Allocate(lhs.count);
+			Size i = 0;
+
+			#ifdef VLK_COMMON_SSE2
+			for (; i + 4 <= lhs.count; i += 4)
+			{
+				_mm_store_ps(out.x + i, _mm_add_ps(_mm_load_ps(lhs.x + i), _mm_load_ps(rhs.x + i)));
+				_mm_store_ps(out.y + i, _mm_add_ps(_mm_load_ps(lhs.y + i), _mm_load_ps(rhs.y + i)));
+				_mm_store_ps(out.z + i, _mm_add_ps(_mm_load_ps(lhs.z + i), _mm_load_ps(rhs.z + i)));
+			}
+			#endif
+
+			for (; i < lhs.count; i++)
+			{
+				out.x[i] = lhs.x[i] + rhs.x[i];
+				out.y[i] = lhs.y[i] + rhs.y[i];
+				out.z[i] = lhs.z[i] + rhs.z[i];
+			}
+		}
+
+		/*!
+		 * \brief Multiplies every vector of a stream by a scalar.
+		 */
+		static inline void Scale(const Vector3Stream& v, Float factor, Vector3Stream& out)
+		{
+			out.Allocate(v.count);
+			Size i = 0;
+
+			#ifdef VLK_COMMON_SSE2
+			const __m128 f = _mm_set1_ps(factor);
+			for (; i + 4 <= v.count; i += 4)
+			{
+				_mm_store_ps(out.x + i, _mm_mul_ps(_mm_load_ps(v.x + i), f));
+				_mm_store_ps(out.y + i, _mm_mul_ps(_mm_load_ps(v.y + i), f));
+				_mm_store_ps(out.z + i, _mm_mul_ps(_mm_load_ps(v.z + i), f));
+			}
+			#endif
+
+			for (; i < v.count; i++)
+			{
+				out.x[i] = v.x[i] * factor;
+				out.y[i] = v.y[i] * factor;
+				out.z[i] = v.z[i] * factor;
+			}
+		}
+
+		/*!
+		 * \brief Calculates the dot product of corresponding vectors of two streams.
+		 *
+		 * \param out An array of at least <tt>lhs.Count()</tt> floats.
+		 *
+		 * \throws std::invalid_argument If <tt>lhs</tt> and <tt>rhs</tt> differ in length.
+		 */
+		static inline void Dot(const Vector3Stream& lhs, const Vector3Stream& rhs, Float* out)
+		{
+			RequireSameCount(lhs, rhs);
+			Size i = 0;
+
+			#ifdef VLK_COMMON_SSE2
+			for (; i + 4 <= lhs.count; i += 4)
+			{
+				_mm_storeu_ps(out + i, DotSSE(
+					_mm_load_ps(lhs.x + i), _mm_load_ps(lhs.y + i), _mm_load_ps(lhs.z + i),
+					_mm_load_ps(rhs.x + i), _mm_load_ps(rhs.y + i), _mm_load_ps(rhs.z + i)));
+			}
+			#endif
+
+			for (; i < lhs.count; i++)
+			{
+				out[i] = (lhs.x[i] * rhs.x[i]) + (lhs.y[i] * rhs.y[i]) + (lhs.z[i] * rhs.z[i]);
+			}
+		}
+
+		/*!
+		 * \brief Calculates the cross product of corresponding vectors of two streams.
+		 *
+		 * \throws std::invalid_argument If <tt>lhs</tt> and <tt>rhs</tt> differ in length.
+		 */
+		static inline void Cross(const Vector3Stream& lhs, const Vector3Stream& rhs, Vector3Stream& out)
+		{
+			RequireSameCount(lhs, rhs);
+			out.Allocate(lhs.count);
+			Size i = 0;
+
+			#ifdef VLK_COMMON_SSE2
+			for (; i + 4 <= lhs.count; i += 4)
+			{
+				const __m128 lx = _mm_load_ps(lhs.x + i);
+				const __m128 ly = _mm_load_ps(lhs.y + i);
+				const __m128 lz = _mm_load_ps(lhs.z + i);
+				const __m128 rx = _mm_load_ps(rhs.x + i);
+				const __m128 ry = _mm_load_ps(rhs.y + i);
+				const __m128 rz = _mm_load_ps(rhs.z + i);
+
+				_mm_store_ps(out.x + i, _mm_sub_ps(_mm_mul_ps(ly, rz), _mm_mul_ps(lz, ry)));
+				_mm_store_ps(out.y + i, _mm_sub_ps(_mm_mul_ps(lz, rx), _mm_mul_ps(lx, rz)));
+				_mm_store_ps(out.z + i, _mm_sub_ps(_mm_mul_ps(lx, ry), _mm_mul_ps(ly, rx)));
+			}
+			#endif
+
+			for (; i < lhs.count; i++)
+			{
+				const Float cx = lhs.y[i] * rhs.z[i] - lhs.z[i] * rhs.y[i];
+				const Float cy = lhs.z[i] * rhs.x[i] - lhs.x[i] * rhs.z[i];
+				const Float cz = lhs.x[i] * rhs.y[i] - lhs.y[i] * rhs.x[i];
+
+				out.x[i] = cx;
+				out.y[i] = cy;
+				out.z[i] = cz;
+			}
+		}
+
+		/*!
+		 * \brief Calculates the length of every vector of a stream.
+		 *
+		 * \param out An array of at least <tt>v.Count()</tt> floats.
+		 */
+		static inline void Length(const Vector3Stream& v, Float* out)
+		{
+			Size i = 0;
+
+			#ifdef VLK_COMMON_SSE2
+			for (; i + 4 <= v.count; i += 4)
+			{
+				const __m128 vx = _mm_load_ps(v.x + i);
+				const __m128 vy = _mm_load_ps(v.y + i);
+				const __m128 vz = _mm_load_ps(v.z + i);
+				_mm_storeu_ps(out + i, _mm_sqrt_ps(DotSSE(vx, vy, vz, vx, vy, vz)));
+			}
+			#endif
+
+			for (; i < v.count; i++)
+			{
+				out[i] = Sqrt((v.x[i] * v.x[i]) + (v.y[i] * v.y[i]) + (v.z[i] * v.z[i]));
+			}
+		}
+
+		/*!
+		 * \brief Normalizes every vector of a stream.
+		 *
+		 * \warning If a vector has a length of zero, all components of the
+		 * corresponding output vector will be <tt>NaN</tt>.
+		 *
+		 * \sa vlk::Vector3::Normalized(const Vector3&)
+		 */
+		static inline void Normalized(const Vector3Stream& v, Vector3Stream& out)
+		{
+			out.Allocate(v.count);
+			Size i = 0;
+
+			#ifdef VLK_COMMON_SSE2
+			for (; i + 4 <= v.count; i += 4)
+			{
+				const __m128 vx = _mm_load_ps(v.x + i);
+				const __m128 vy = _mm_load_ps(v.y + i);
+				const __m128 vz = _mm_load_ps(v.z + i);
+				const __m128 len = _mm_sqrt_ps(DotSSE(vx, vy, vz, vx, vy, vz));
+
+				_mm_store_ps(out.x + i, _mm_div_ps(vx, len));
+				_mm_store_ps(out.y + i, _mm_div_ps(vy, len));
+				_mm_store_ps(out.z + i, _mm_div_ps(vz, len));
+			}
+			#endif
+
+			for (; i < v.count; i++)
+			{
+				const Float len = Sqrt((v.x[i] * v.x[i]) + (v.y[i] * v.y[i]) + (v.z[i] * v.z[i]));
+
+				out.x[i] = v.x[i] / len;
+				out.y[i] = v.y[i] / len;
+				out.z[i] = v.z[i] / len;
+			}
+		}
+
+		/*!
+		 * \brief Approximates a unit vector for every vector of a stream.
+		 *
+		 * Vectors whose square length is not a normal float produce the zero
+		 * vector.
+		 *
+		 * \sa vlk::Vector3::FastNormalized(const Vector3&)
+		 */
+		static inline void FastNormalized(const Vector3Stream& v, Vector3Stream& out)
+		{
+			out.Allocate(v.count);
+			Size i = 0;
+
+			#ifdef VLK_COMMON_SSE2
+			const __m128 minSq = _mm_set1_ps(std::numeric_limits<Float>::min());
+			const __m128 maxSq = _mm_set1_ps(std::numeric_limits<Float>::max());
+			for (; i + 4 <= v.count; i += 4)
+			{
+				const __m128 vx = _mm_load_ps(v.x + i);
+				const __m128 vy = _mm_load_ps(v.y + i);
+				const __m128 vz = _mm_load_ps(v.z + i);
+				const __m128 sq = DotSSE(vx, vy, vz, vx, vy, vz);
+
+				// Masking the products rather than the factor also zeroes vectors with NaN components
+				const __m128 valid = _mm_and_ps(_mm_cmpge_ps(sq, minSq), _mm_cmple_ps(sq, maxSq));
+				const __m128 inv = FastInvSqrt(sq);
+
+				_mm_store_ps(out.x + i, _mm_and_ps(valid, _mm_mul_ps(vx, inv)));
+				_mm_store_ps(out.y + i, _mm_and_ps(valid, _mm_mul_ps(vy, inv)));
+				_mm_store_ps(out.z + i, _mm_and_ps(valid, _mm_mul_ps(vz, inv)));
+			}
+			#endif
+
+			for (; i < v.count; i++)
+			{
+				const Vector3 n = Vector3::FastNormalized(Vector3(v.x[i], v.y[i], v.z[i]));
+
+				out.x[i] = n.X();
+				out.y[i] = n.Y();
+				out.z[i] = n.Z();
+			}
+		}
+
+		/*!
+		 * \brief Linearly interpolates between corresponding vectors of two streams.
+		 *
+		 * \throws std::invalid_argument If <tt>start</tt> and <tt>end</tt> differ in length.
+		 */
+		static inline void Lerp(const Vector3Stream& start, const Vector3Stream& end, Float t, Vector3Stream& out)
+		{
+			RequireSameCount(start, end);
+			out.Allocate(start.count);
+			Size i = 0;
+
+			#ifdef VLK_COMMON_SSE2
+			const __m128 tt = _mm_set1_ps(t);
+			for (; i + 4 <= start.count; i += 4)
+			{
+				const __m128 sx = _mm_load_ps(start.x + i);
+				const __m128 sy = _mm_load_ps(start.y + i);
+				const __m128 sz = _mm_load_ps(start.z + i);
+
+				_mm_store_ps(out.x + i, _mm_add_ps(sx, _mm_mul_ps(tt, _mm_sub_ps(_mm_load_ps(end.x + i), sx))));
+				_mm_store_ps(out.y + i, _mm_add_ps(sy, _mm_mul_ps(tt, _mm_sub_ps(_mm_load_ps(end.y + i), sy))));
+				_mm_store_ps(out.z + i, _mm_add_ps(sz, _mm_mul_ps(tt, _mm_sub_ps(_mm_load_ps(end.z + i), sz))));
+			}
+			#endif
+
+			for (; i < start.count; i++)
+			{
+				out.x[i] = start.x[i] + t * (end.x[i] - start.x[i]);
+				out.y[i] = start.y[i] + t * (end.y[i] - start.y[i]);
+				out.z[i] = start.z[i] + t * (end.z[i] - start.z[i]);
+			}
+		}
+
+		private:
+		#ifdef VLK_COMMON_SSE2
+		static inline __m128 DotSSE(__m128 lx, __m128 ly, __m128 lz, __m128 rx, __m128 ry, __m128 rz)
+		{
+			return _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, rx), _mm_mul_ps(ly, ry)), _mm_mul_ps(lz, rz));
+		}
+		#endif
+	};
+}
+
+#endif
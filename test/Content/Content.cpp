@@ -1,8 +1,24 @@
 #include "TestValues.hpp" 
 #include "ValkyrieEngineCommon/Content.hpp"
+#include "ValkyrieEngineCommon/ContentArchive.hpp"
+#include "ValkyrieEngineCommon/ContentWatcher.hpp"
+#include "ValkyrieEngineCommon/MappedFile.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
 #include <fstream>
+#include <future>
+#include <iterator>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace vlk;
 
@@ -189,3 +205,918 @@ TEST_CASE("Content management")
 		REQUIRE(Content<MyContent>::GetMetadata("test_2", "meta_4") == "");
 	}
 }
+
+struct SharedContent
+{
+	int id;
+};
+
+template<>
+SharedContent* vlk::ConstructContent(const std::string&)
+{
+	return new SharedContent{0};
+}
+
+template<>
+void vlk::DestroyContent(SharedContent* c)
+{
+	delete c;
+}
+
+TEST_CASE("Content lookups from other threads")
+{
+	typedef Content<SharedContent> C;
+
+	REQUIRE(C::LoadContent("shared", "fixed"));
+	const SharedContent* fixed = C::GetContent("fixed");
+	REQUIRE(fixed != nullptr);
+
+	std::atomic<bool> stop(false);
+	std::atomic<Size> mismatches(0);
+	std::vector<std::thread> readers;
+
+	for (int r = 0; r < 4; r++)
+	{
+		readers.emplace_back([&]()
+		{
+			while (!stop)
+			{
+				if (C::GetContent("fixed") != fixed) mismatches++;
+				C::GetContent("changing");
+			}
+		});
+	}
+
+	for (int i = 0; i < 500; i++)
+	{
+		REQUIRE(C::LoadContent("shared", "changing"));
+		if (i % 2 == 0) REQUIRE(C::UnloadContent("changing"));
+	}
+
+	stop = true;
+	for (std::thread& t : readers) t.join();
+
+	REQUIRE(mismatches == 0);
+	REQUIRE(C::GetContent("changing") != nullptr);
+	REQUIRE(C::UnloadContent("changing"));
+	REQUIRE(C::UnloadContent("fixed"));
+}
+
+TEST_CASE("Content handles")
+{
+	typedef Content<SharedContent> C;
+
+	REQUIRE(ContentHandle<SharedContent>().IsNull());
+	REQUIRE(ContentHandle<SharedContent>().Get() == nullptr);
+	REQUIRE(C::Resolve("handle").IsNull());
+
+	REQUIRE(C::LoadContent("shared", "handle"));
+	ContentHandle<SharedContent> h = C::Resolve("handle");
+	REQUIRE(!h.IsNull());
+	REQUIRE(h == C::Resolve("handle"));
+	REQUIRE(h.Get() != nullptr);
+	REQUIRE(h.Get() == C::GetContent("handle"));
+	REQUIRE(C::GetContent(h) == h.Get());
+
+	// Reloading the alias invalidates the old handle
+	REQUIRE(C::LoadContent("shared", "handle"));
+	REQUIRE(h.Get() == nullptr);
+
+	ContentHandle<SharedContent> reloaded = C::Resolve("handle");
+	REQUIRE(reloaded != h);
+	REQUIRE(reloaded.Get() == C::GetContent("handle"));
+
+	// Unloading invalidates the handle, even once its slot is reused
+	REQUIRE(C::UnloadContent("handle"));
+	REQUIRE(reloaded.Get() == nullptr);
+	REQUIRE(C::Resolve("handle").IsNull());
+
+	REQUIRE(C::LoadContent("shared", "other"));
+	REQUIRE(reloaded.Get() == nullptr);
+	REQUIRE(h.Get() == nullptr);
+	REQUIRE(C::Resolve("other").Get() != nullptr);
+	REQUIRE(C::UnloadContent("other"));
+}
+
+struct AsyncContent
+{
+	std::thread::id constructedOn;
+};
+
+template<>
+AsyncContent* vlk::ConstructContent(const std::string& path)
+{
+	if (path == "content/throw") throw std::runtime_error("construction failed");
+	if (path == "content/missing") return nullptr;
+	return new AsyncContent{std::this_thread::get_id()};
+}
+
+template<>
+void vlk::DestroyContent(AsyncContent* c)
+{
+	delete c;
+}
+
+TEST_CASE("Asynchronous content loading")
+{
+	typedef Content<AsyncContent> C;
+
+	// The pool size can only be changed before the pool starts
+	ThreadPool& pool = ContentLoader::Pool();
+	REQUIRE_THROWS_AS(ContentLoader::SetThreadCount(1), std::runtime_error);
+
+	std::future<ContentHandle<AsyncContent>> loaded = C::LoadContentAsync("loaded", "async");
+	std::future<ContentHandle<AsyncContent>> missing = C::LoadContentAsync("missing", "missing");
+	std::future<ContentHandle<AsyncContent>> failed = C::LoadContentAsync("throw", "throw");
+
+	// Nothing is visible before the main thread publishes it
+	REQUIRE(C::GetContent("async") == nullptr);
+
+	Size published = 0;
+	while (C::PendingLoadCount() > 0)
+	{
+		published += C::PublishLoads();
+		std::this_thread::yield();
+	}
+
+	REQUIRE(published == 3);
+	REQUIRE(C::PublishLoads() == 0);
+
+	ContentHandle<AsyncContent> handle = loaded.get();
+	REQUIRE(!handle.IsNull());
+	REQUIRE(handle == C::Resolve("async"));
+	REQUIRE(handle.Get() == C::GetContent("async"));
+	if (pool.ThreadCount() > 0) REQUIRE(handle.Get()->constructedOn != std::this_thread::get_id());
+
+	REQUIRE(missing.get().IsNull());
+	REQUIRE(C::GetContent("missing") == nullptr);
+
+	REQUIRE_THROWS_AS(failed.get(), std::runtime_error);
+	REQUIRE(C::GetContent("throw") == nullptr);
+
+	REQUIRE(C::UnloadContent("async"));
+}
+
+struct BatchContent
+{
+	std::string data;
+};
+
+template<>
+BatchContent* vlk::ConstructContent(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file.good()) return nullptr;
+	BatchContent* c = new BatchContent();
+	std::getline(file, c->data);
+	return c;
+}
+
+template<>
+void vlk::DestroyContent(BatchContent* c)
+{
+	delete c;
+}
+
+class BatchEventListener :
+	public EventListener<Content<BatchContent>::LoadEvent>,
+	public EventListener<Content<BatchContent>::UnloadEvent>,
+	public EventListener<Content<BatchContent>::BatchLoadEvent>
+{
+	public:
+	int loaded = 0;
+	int unloaded = 0;
+	int batches = 0;
+	Size lastBatchSize = 0;
+
+	//! Unload events sent after their content was no longer stored under its alias.
+	int unloadedLate = 0;
+
+	void OnEvent(const Content<BatchContent>::LoadEvent&) override { loaded++; }
+
+	void OnEvent(const Content<BatchContent>::UnloadEvent& e) override
+	{
+		unloaded++;
+		if (Content<BatchContent>::GetContent(e.alias) != e.content) unloadedLate++;
+	}
+
+	void OnEvent(const Content<BatchContent>::BatchLoadEvent& e) override
+	{
+		batches++;
+		lastBatchSize = e.loaded.size();
+	}
+};
+
+TEST_CASE("Batch content loading")
+{
+	typedef Content<BatchContent> C;
+	BatchEventListener ev;
+
+	REQUIRE_THROWS_AS(C::LoadManifest("NoManifest"), std::runtime_error);
+
+	C::BatchResult r = C::LoadManifest("TestManifest");
+	REQUIRE(r.loaded == 2);
+	REQUIRE(r.failed == 1);
+	REQUIRE(r.constructTime.count() >= 0);
+	REQUIRE(r.publishTime.count() >= 0);
+
+	REQUIRE(ev.loaded == 2);
+	REQUIRE(ev.unloaded == 0);
+	REQUIRE(ev.batches == 1);
+	REQUIRE(ev.lastBatchSize == 2);
+
+	REQUIRE(C::GetContent("batch_1")->data == "Repeat content loading");
+	REQUIRE(C::GetContent("batch_2")->data == "Repeat content loading");
+	REQUIRE(C::GetContent("batch_missing") == nullptr);
+	REQUIRE(C::GetMetadata("batch_1", "meta_2") == "repeat metadata value");
+
+	ContentHandle<BatchContent> h = C::Resolve("batch_1");
+
+	// Replacing content through a batch
+	r = C::LoadBatch({ { "TestCase1", "batch_1" } });
+	REQUIRE(r.loaded == 1);
+	REQUIRE(r.failed == 0);
+	REQUIRE(ev.loaded == 3);
+	REQUIRE(ev.unloaded == 1);
+	REQUIRE(ev.batches == 2);
+
+	// Like LoadContent, the replaced content is still stored when its UnloadEvent is sent
+	REQUIRE(ev.unloadedLate == 0);
+	REQUIRE(C::LoadContent("TestCaseR", "batch_2"));
+	REQUIRE(ev.unloaded == 2);
+	REQUIRE(ev.unloadedLate == 0);
+
+	REQUIRE(h.Get() == nullptr);
+	REQUIRE(C::GetContent("batch_1")->data == "Test case 1 sample data.");
+	REQUIRE(C::GetMetadata("batch_1", "meta_2") == "second metadata value");
+
+	REQUIRE(C::UnloadContent("batch_1"));
+	REQUIRE(C::UnloadContent("batch_2"));
+}
+
+struct ViewContent
+{
+	const UByte* begin;
+	Size size;
+};
+
+namespace vlk
+{
+	template<>
+	struct MapContent<ViewContent> : std::true_type { };
+}
+
+template<>
+ViewContent* vlk::ConstructContent(const std::string&, const ContentView& view)
+{
+	// Refers to the mapped bytes instead of copying them
+	return new ViewContent{view.data, view.size};
+}
+
+template<>
+void vlk::DestroyContent(ViewContent* c)
+{
+	delete c;
+}
+
+TEST_CASE("Memory-mapped files")
+{
+	MappedFile missing("content/DoesNotExist");
+	REQUIRE(!missing.IsOpen());
+	REQUIRE(missing.Data() == nullptr);
+	REQUIRE(missing.Length() == 0);
+
+	MappedFile file("content/TestCase1");
+	REQUIRE(file.IsOpen());
+	REQUIRE(file.Length() == 25);
+	REQUIRE(std::string(reinterpret_cast<const char*>(file.Data()), file.Length()) == "Test case 1 sample data.\n");
+
+	MappedFile moved(std::move(file));
+	REQUIRE(!file.IsOpen());
+	REQUIRE(moved.IsOpen());
+	REQUIRE(moved.Length() == 25);
+}
+
+TEST_CASE("Content constructed from memory-mapped files")
+{
+	typedef Content<ViewContent> C;
+
+	REQUIRE(!C::LoadContent("DoesNotExist", "view"));
+	REQUIRE(C::LoadContent("TestCase1", "view"));
+
+	const ViewContent* c = C::GetContent("view");
+	REQUIRE(c != nullptr);
+	REQUIRE(std::string(reinterpret_cast<const char*>(c->begin), c->size) == "Test case 1 sample data.\n");
+	REQUIRE(C::GetMetadata("view", "meta_1") == "pass");
+
+	REQUIRE(C::LoadBatch({ { "TestCaseR", "view" } }).loaded == 1);
+	c = C::GetContent("view");
+	REQUIRE(std::string(reinterpret_cast<const char*>(c->begin), c->size) == "Repeat content loading\n");
+
+	REQUIRE(C::UnloadContent("view"));
+}
+
+struct ArchivedContent
+{
+	std::string data;
+};
+
+namespace vlk
+{
+	template<>
+	struct MapContent<ArchivedContent> : std::true_type { };
+}
+
+template<>
+ArchivedContent* vlk::ConstructContent(const std::string&, const ContentView& view)
+{
+	const char* begin = reinterpret_cast<const char*>(view.data);
+	return new ArchivedContent{std::string(begin, std::find(begin, begin + view.size, '\n'))};
+}
+
+template<>
+void vlk::DestroyContent(ArchivedContent* c)
+{
+	delete c;
+}
+
+namespace
+{
+	std::string ReadTestFile(const std::string& path)
+	{
+		std::ifstream in(path, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+
+	std::vector<UByte> Bytes(const std::string& s)
+	{
+		return std::vector<UByte>(s.begin(), s.end());
+	}
+}
+
+TEST_CASE("Content archives")
+{
+	ContentArchiveWriter writer;
+	writer.Add("TestManifest", Bytes(ReadTestFile("content/TestManifest")), "");
+	writer.Add("TestCaseR", Bytes(ReadTestFile("content/TestCaseR")), ReadTestFile("content/TestCaseR.meta"));
+	writer.Add("TestCase1", Bytes(ReadTestFile("content/TestCase1")), ReadTestFile("content/TestCase1.meta"));
+	writer.Add("empty", {}, "");
+	writer.Write("content_test.vpak");
+
+	std::shared_ptr<const ContentArchive> archive = std::make_shared<ContentArchive>("content_test.vpak");
+
+	//SECTION("Lookup")
+	{
+		REQUIRE(archive->Count() == 4);
+		REQUIRE(archive->Path(0) == "TestCase1");
+		REQUIRE(archive->Path(1) == "TestCaseR");
+		REQUIRE(archive->Path(2) == "TestManifest");
+		REQUIRE(archive->Path(3) == "empty");
+		REQUIRE_THROWS_AS(archive->Path(4), std::out_of_range);
+
+		ContentArchive::Entry e;
+		REQUIRE(!archive->Find("TestCase", e));
+		REQUIRE(!archive->Find("TestCase10", e));
+		REQUIRE(!archive->Find("", e));
+
+		REQUIRE(archive->Find("TestCase1", e));
+		REQUIRE(reinterpret_cast<uintptr_t>(e.data) % ContentArchiveFormat::Alignment == 0);
+		REQUIRE(std::string(reinterpret_cast<const char*>(e.data), e.size) == "Test case 1 sample data.\n");
+		REQUIRE(std::string(e.metadata, e.metadataSize) == ReadTestFile("content/TestCase1.meta"));
+
+		REQUIRE(archive->Find("empty", e));
+		REQUIRE(e.data == nullptr);
+		REQUIRE(e.size == 0);
+	}
+
+	//SECTION("Invalid archives")
+	{
+		REQUIRE_THROWS_AS(ContentArchive("content/DoesNotExist"), std::runtime_error);
+		REQUIRE_THROWS_AS(ContentArchive("content/TestCase1"), std::runtime_error);
+
+		ContentArchiveWriter duplicate;
+		duplicate.Add("a", {}, "");
+		duplicate.Add("a", {}, "");
+		REQUIRE_THROWS_AS(duplicate.Write("content_duplicate.vpak"), std::invalid_argument);
+	}
+
+	//SECTION("Loading content")
+	{
+		typedef Content<ArchivedContent> C;
+		C::SetContentArchive(archive);
+		REQUIRE(C::GetContentArchive() == archive);
+
+		REQUIRE(!C::LoadContent("DoesNotExist", "archived"));
+		REQUIRE(C::LoadContent("TestCase1", "archived"));
+		REQUIRE(C::GetContent("archived")->data == "Test case 1 sample data.");
+		REQUIRE(C::GetMetadata("archived", "meta_2") == "second metadata value");
+
+		C::BatchResult r = C::LoadManifest("TestManifest");
+		REQUIRE(r.loaded == 2);
+		REQUIRE(r.failed == 1);
+		REQUIRE(C::GetContent("batch_1")->data == "Repeat content loading");
+
+		REQUIRE(C::LoadContentAsync("TestCaseR", "async").valid());
+		while (C::PendingLoadCount() > 0) C::PublishLoads();
+		REQUIRE(C::GetContent("async")->data == "Repeat content loading");
+
+		// Loaded content keeps the archive alive
+		C::SetContentArchive(nullptr);
+		archive.reset();
+		REQUIRE(C::GetContent("archived")->data == "Test case 1 sample data.");
+
+		REQUIRE(C::UnloadContent("archived"));
+		REQUIRE(C::UnloadContent("batch_1"));
+		REQUIRE(C::UnloadContent("batch_2"));
+		REQUIRE(C::UnloadContent("async"));
+	}
+
+	//SECTION("Content types must map archived content")
+	{
+		Content<BatchContent>::SetContentArchive(std::make_shared<ContentArchive>("content_test.vpak"));
+		REQUIRE_THROWS_AS(Content<BatchContent>::LoadContent("TestCase1", "archived"), std::runtime_error);
+		Content<BatchContent>::SetContentArchive(nullptr);
+	}
+
+	std::remove("content_test.vpak");
+	std::remove("content_duplicate.vpak");
+}
+
+TEST_CASE("Content metadata cache")
+{
+	typedef Content<BatchContent> C;
+
+	std::remove("content/TestCase1.metab");
+	REQUIRE(!C::IsMetadataCacheEnabled());
+	C::SetMetadataCacheEnabled(true);
+
+	for (int i = 0; i < 2; i++)
+	{
+		REQUIRE(C::LoadContent("TestCase1", "cached"));
+		REQUIRE(std::ifstream("content/TestCase1.metab").good());
+		REQUIRE(C::GetMetadata("cached", "meta_1") == "pass");
+		REQUIRE(C::GetMetadata("cached", "meta_2") == "second metadata value");
+		REQUIRE(C::GetMetadata("cached", "meta_3") == "");
+	}
+
+	REQUIRE(C::UnloadContent("cached"));
+	REQUIRE(C::GetMetadata("cached", "meta_1") == "");
+
+	C::SetMetadataCacheEnabled(false);
+	std::remove("content/TestCase1.metab");
+}
+
+TEST_CASE("Typed content metadata")
+{
+	typedef Content<BatchContent> C;
+
+	REQUIRE(C::LoadContent("TestCaseTyped", "typed"));
+
+	REQUIRE(C::GetMetadataInt("typed", "frames") == 12);
+	REQUIRE(C::GetMetadataInt("typed", "name", -1) == -1);
+	REQUIRE(C::GetMetadataInt("typed", "missing", -1) == -1);
+	REQUIRE(C::GetMetadataFloat("typed", "frame_time") == Approx(0.125f));
+	REQUIRE(C::GetMetadataFloat("typed", "frames") == Approx(12.0f));
+	REQUIRE(C::GetMetadataFloat("typed", "name", 2.0f) == Approx(2.0f));
+	REQUIRE(C::GetMetadataBool("typed", "filtered"));
+	REQUIRE(!C::GetMetadataBool("typed", "wrapped", true));
+	REQUIRE(C::GetMetadataBool("typed", "name", true));
+	REQUIRE(C::GetMetadataView("typed", "name") == "sprite sheet");
+	REQUIRE(C::GetMetadataView("typed", "missing").Empty());
+
+	const ContentMetadata* meta = C::FindMetadata("typed");
+	REQUIRE(meta != nullptr);
+	Long frames;
+	REQUIRE(meta->GetInt(MetadataKeys::Intern("frames"), frames));
+	REQUIRE(frames == 12);
+
+	REQUIRE(C::UnloadContent("typed"));
+	REQUIRE(C::FindMetadata("typed") == nullptr);
+	REQUIRE(C::GetMetadataInt("typed", "frames", -1) == -1);
+	REQUIRE(C::GetMetadataView("typed", "name").Empty());
+}
+
+#ifdef __linux__
+TEST_CASE("Content hot reloading")
+{
+	typedef Content<BatchContent> C;
+	BatchEventListener ev;
+
+	mkdir("hot_reload", 0755);
+	std::ofstream("hot_reload/asset") << "first\n";
+	std::ofstream("hot_reload/asset.meta") << "version=1\n";
+	std::ofstream("hot_reload/other") << "other\n";
+
+	C::SetContentPrefix("hot_reload/");
+	REQUIRE(C::LoadContent("asset", "hot"));
+	REQUIRE(C::LoadContent("asset", "hot_copy"));
+	REQUIRE(C::LoadContent("other", "unchanged"));
+	REQUIRE(C::GetContentPath("hot") == "asset");
+	REQUIRE(C::GetContentPath("missing") == "");
+
+	std::vector<std::string> aliases = C::GetAliasesLoadedFrom("asset");
+	std::sort(aliases.begin(), aliases.end());
+	REQUIRE(aliases == std::vector<std::string>{ "hot", "hot_copy" });
+
+	const BatchContent* unchanged = C::GetContent("unchanged");
+	ev.loaded = 0;
+	ev.unloaded = 0;
+
+	{
+		ContentHotReload<BatchContent> reload(std::chrono::milliseconds(20));
+
+		//Runs frames until both aliases have been reloaded
+		auto runFrames = [&](const std::string& expected)
+		{
+			Size started = 0;
+			for (int i = 0; i < 200 && (started < 2 || C::PendingLoadCount() > 0); i++)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				started += reload.Update();
+				C::PublishLoads();
+			}
+
+			return started == 2 &&
+				C::GetContent("hot")->data == expected &&
+				C::GetContent("hot_copy")->data == expected;
+		};
+
+		std::ofstream("hot_reload/asset") << "second\n";
+		REQUIRE(runFrames("second"));
+		REQUIRE(ev.unloaded == 2);
+		REQUIRE(ev.loaded == 2);
+
+		//Changing only the meta file reloads the content with its new metadata
+		std::ofstream("hot_reload/asset.meta") << "version=2\n";
+		REQUIRE(runFrames("second"));
+		REQUIRE(C::GetMetadataInt("hot", "version") == 2);
+		REQUIRE(ev.unloaded == 4);
+
+		REQUIRE(C::GetContent("unchanged") == unchanged);
+	}
+
+	REQUIRE(C::UnloadContent("hot"));
+	REQUIRE(C::UnloadContent("hot_copy"));
+	REQUIRE(C::UnloadContent("unchanged"));
+	REQUIRE(C::GetAliasesLoadedFrom("asset").empty());
+	C::SetContentPrefix("content/");
+
+	std::remove("hot_reload/asset");
+	std::remove("hot_reload/asset.meta");
+	std::remove("hot_reload/other");
+	rmdir("hot_reload");
+}
+#endif
+
+struct DeferredContent
+{
+	int value;
+};
+
+namespace
+{
+	std::atomic<int> deferredDestroyed(0);
+	std::thread::id deferredDestroyThread;
+}
+
+template<>
+DeferredContent* vlk::ConstructContent(const std::string&)
+{
+	return new DeferredContent{42};
+}
+
+template<>
+void vlk::DestroyContent(DeferredContent* c)
+{
+	c->value = -1;
+	delete c;
+	deferredDestroyThread = std::this_thread::get_id();
+	deferredDestroyed++;
+}
+
+TEST_CASE("Deferred content destruction")
+{
+	typedef Content<DeferredContent> C;
+
+	//SECTION("Immediate destruction")
+	{
+		REQUIRE(!C::IsDeferredDestructionEnabled());
+		REQUIRE(C::LoadContent("TestCase1", "immediate"));
+		REQUIRE(C::UnloadContent("immediate"));
+		REQUIRE(deferredDestroyed == 1);
+		REQUIRE(deferredDestroyThread == std::this_thread::get_id());
+	}
+
+	C::SetDeferredDestructionEnabled(true);
+
+	//SECTION("Content outlives readers")
+	{
+		REQUIRE(C::LoadContent("TestCase1", "deferred"));
+
+		std::promise<void> acquired;
+		std::promise<void> release;
+		std::shared_future<void> released = release.get_future().share();
+		int seen = 0;
+
+		std::thread reader([&]()
+		{
+			EpochGuard guard;
+			const DeferredContent* c = C::GetContent("deferred");
+			acquired.set_value();
+			released.wait();
+			seen = c->value;
+		});
+
+		acquired.get_future().wait();
+		REQUIRE(C::UnloadContent("deferred"));
+		REQUIRE(C::GetContent("deferred") == nullptr);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		REQUIRE(deferredDestroyed == 1);
+		REQUIRE(ContentReclaimer::Outstanding() == 1);
+
+		release.set_value();
+		reader.join();
+		ContentReclaimer::Flush();
+
+		REQUIRE(seen == 42);
+		REQUIRE(deferredDestroyed == 2);
+		REQUIRE(deferredDestroyThread != std::this_thread::get_id());
+		REQUIRE(ContentReclaimer::Outstanding() == 0);
+	}
+
+	//SECTION("Replaced content and metadata")
+	{
+		REQUIRE(C::LoadContent("TestCase1", "replaced"));
+
+		{
+			EpochGuard guard;
+			const MetadataView view = C::GetMetadataView("replaced", "meta_2");
+			REQUIRE(C::LoadContent("TestCaseR", "replaced"));
+			REQUIRE(view == "second metadata value");
+			REQUIRE(C::GetMetadataView("replaced", "meta_2") == "repeat metadata value");
+		}
+
+		ContentReclaimer::Flush();
+		REQUIRE(deferredDestroyed == 3);
+
+		REQUIRE(C::UnloadContent("replaced"));
+		ContentReclaimer::Flush();
+		REQUIRE(deferredDestroyed == 4);
+	}
+
+	C::SetDeferredDestructionEnabled(false);
+}
+
+struct SizedContent
+{
+	std::string path;
+};
+
+namespace
+{
+	int sizedConstructed = 0;
+}
+
+template<>
+SizedContent* vlk::ConstructContent(const std::string& path)
+{
+	if (!std::ifstream(path).good()) return nullptr;
+	sizedConstructed++;
+	return new SizedContent{path};
+}
+
+template<>
+void vlk::DestroyContent(SizedContent* c)
+{
+	delete c;
+}
+
+template<>
+Size vlk::ContentSize(const SizedContent&)
+{
+	return 100;
+}
+
+TEST_CASE("Content memory budget")
+{
+	typedef Content<SizedContent> C;
+
+	REQUIRE(C::GetMemoryBudget() == 0);
+	REQUIRE(C::LoadContent("TestCase1", "a"));
+	REQUIRE(C::LoadContent("TestCaseR", "b"));
+	REQUIRE(C::LoadContent("TestCaseTyped", "c"));
+	REQUIRE(C::GetMemoryUsage() == 300);
+
+	const ContentHandle<SizedContent> handleA = C::Resolve("a");
+	C::ResetCacheStats();
+
+	//SECTION("Unreferenced content is evicted first")
+	{
+		// Every entry starts referenced, so the hand sweeps once before evicting the oldest
+		C::SetMemoryBudget(250);
+		REQUIRE(C::GetMemoryUsage() == 200);
+		REQUIRE(C::GetCacheStats().evictions == 1);
+		REQUIRE(C::Resolve("a").IsNull());
+		REQUIRE(C::GetContent(handleA) == nullptr);
+		REQUIRE(C::GetContentPath("a") == "TestCase1");
+
+		// c is retrieved, so b goes next
+		REQUIRE(C::GetContent("c") != nullptr);
+		C::SetMemoryBudget(150);
+		REQUIRE(C::GetMemoryUsage() == 100);
+		REQUIRE(C::Resolve("b").IsNull());
+		REQUIRE(!C::Resolve("c").IsNull());
+
+		const C::CacheStats stats = C::GetCacheStats();
+		REQUIRE(stats.hits == 1);
+		REQUIRE(stats.misses == 0);
+		REQUIRE(stats.evictions == 2);
+
+		// Hits from several threads are counted apart and summed
+		std::vector<std::thread> readers;
+		for (int r = 0; r < 4; r++) readers.emplace_back([]() { for (int i = 0; i < 100; i++) C::GetContent("c"); });
+		for (std::thread& t : readers) t.join();
+		REQUIRE(C::GetCacheStats().hits == 401);
+	}
+
+	//SECTION("Evicted content is reloaded on access")
+	{
+		// Another thread only queues the reload, so a miss there never evicts or destroys content
+		const int constructed = sizedConstructed;
+		const SizedContent sentinel{""};
+		const SizedContent* missed = &sentinel;
+		std::thread([&]() { missed = C::GetContent("a"); }).join();
+		REQUIRE(missed == nullptr);
+		REQUIRE(C::PendingLoadCount() == 1);
+		REQUIRE(C::GetMemoryUsage() == 100);
+		REQUIRE(!C::Resolve("c").IsNull());
+
+		// The main thread, which set the budget, reloads it before returning
+		const SizedContent* c = C::GetContent("c");
+		const SizedContent* a = C::GetContent("a");
+		REQUIRE(a != nullptr);
+		REQUIRE(a->path == "content/TestCase1");
+		REQUIRE(C::GetMetadata("a", "meta_1") == "pass");
+
+		// Retrieving content never evicts other content, so c stays valid until the budget is next enforced
+		REQUIRE(C::GetMemoryUsage() == 200);
+		REQUIRE(C::GetContent(C::Resolve("c")) == c);
+		REQUIRE(c->path == "content/TestCaseTyped");
+
+		// The reload queued by the other thread is dropped, then one of a and c is evicted to meet the budget
+		while (C::PendingLoadCount() > 0) C::PublishLoads();
+		REQUIRE(sizedConstructed == constructed + 2);
+		REQUIRE(C::GetMemoryUsage() == 100);
+		REQUIRE(C::Resolve("a").IsNull() != C::Resolve("c").IsNull());
+		REQUIRE((C::Resolve("a").IsNull() || C::GetContent(C::Resolve("a")) == a));
+
+		const C::CacheStats stats = C::GetCacheStats();
+		REQUIRE(stats.misses == 2);
+		REQUIRE(stats.evictions == 3);
+	}
+
+	//SECTION("Unloading evicted content forgets it")
+	{
+		// A reload still in flight is dropped
+		const int constructed = sizedConstructed;
+		std::thread([]() { C::GetContent("b"); }).join();
+		REQUIRE(C::UnloadContent("b"));
+		REQUIRE(!C::UnloadContent("b"));
+		while (C::PendingLoadCount() > 0) C::PublishLoads();
+		REQUIRE(sizedConstructed == constructed + 1);
+		REQUIRE(C::GetContent("b") == nullptr);
+		REQUIRE(C::GetContentPath("b") == "");
+		REQUIRE(C::PendingLoadCount() == 0);
+	}
+
+	//SECTION("Lowering the budget evicts many entries at once")
+	{
+		C::SetMemoryBudget(0);
+		for (int i = 0; i < 50; i++) REQUIRE(C::LoadContent("TestCase1", "many_" + std::to_string(i)));
+		REQUIRE(C::GetMemoryUsage() == 5100);
+
+		C::SetMemoryBudget(1000);
+		REQUIRE(C::GetMemoryUsage() == 1000);
+
+		Size resident = (C::Resolve("a").IsNull() ? 0 : 1) + (C::Resolve("c").IsNull() ? 0 : 1);
+		for (int i = 0; i < 50; i++) resident += C::Resolve("many_" + std::to_string(i)).IsNull() ? 0 : 1;
+		REQUIRE(resident == 10);
+
+		for (int i = 0; i < 50; i++) REQUIRE(C::UnloadContent("many_" + std::to_string(i)));
+	}
+
+	C::SetMemoryBudget(0);
+	REQUIRE(C::UnloadContent("a"));
+	REQUIRE(C::UnloadContent("c"));
+	REQUIRE(C::GetMemoryUsage() == 0);
+	REQUIRE(C::GetContent("c") == nullptr);
+}
+
+struct StatsContent
+{
+	std::string path;
+};
+
+template<>
+StatsContent* vlk::ConstructContent(const std::string& path)
+{
+	if (!std::ifstream(path).good()) return nullptr;
+	return new StatsContent{path};
+}
+
+template<>
+void vlk::DestroyContent(StatsContent* c)
+{
+	delete c;
+}
+
+TEST_CASE("Latency histogram buckets")
+{
+	REQUIRE(LatencyHistogram::BucketOf(0) == 0);
+	REQUIRE(LatencyHistogram::BucketOf(1) == 1);
+	REQUIRE(LatencyHistogram::BucketOf(2) == 2);
+	REQUIRE(LatencyHistogram::BucketOf(3) == 2);
+	REQUIRE(LatencyHistogram::BucketOf(1000) == 10);
+	REQUIRE(LatencyHistogram::BucketOf(~ULong(0)) == LatencyHistogram::BucketCount - 1);
+
+	for (ULong ns : { 1ull, 100ull, 1000ull, 123456ull })
+	{
+		REQUIRE(ns < LatencyHistogram::UpperBound(LatencyHistogram::BucketOf(ns)));
+		REQUIRE(ns >= LatencyHistogram::UpperBound(LatencyHistogram::BucketOf(ns)) / 2);
+	}
+
+	LatencyHistogram h = LatencyHistogram();
+	REQUIRE(h.PercentileNanoseconds(0.5) == 0);
+
+	h.buckets[LatencyHistogram::BucketOf(10)] = 9;
+	h.buckets[LatencyHistogram::BucketOf(5000)] = 1;
+	h.count = 10;
+	h.totalNanoseconds = 9 * 10 + 5000;
+	h.maxNanoseconds = 5000;
+
+	REQUIRE(h.MeanNanoseconds() == 509);
+	REQUIRE(h.PercentileNanoseconds(0.5) == 16);
+	REQUIRE(h.PercentileNanoseconds(0.99) == 5000);
+}
+
+TEST_CASE("Content statistics")
+{
+	typedef Content<StatsContent> C;
+	C::ResetStats();
+
+	REQUIRE(C::LoadContent("TestCase1", "a"));
+	REQUIRE(C::LoadContent("TestCaseR", "a"));
+	REQUIRE(C::LoadContent("TestCaseTyped", "b"));
+	REQUIRE(!C::LoadContent("Missing", "c"));
+
+	REQUIRE(C::GetContent("a") != nullptr);
+	REQUIRE(C::GetContent(C::Resolve("b")) != nullptr);
+	REQUIRE(C::GetContent("c") == nullptr);
+
+	REQUIRE(C::UnloadContent("b"));
+
+	const ContentStats stats = C::GetStats();
+	REQUIRE(stats.loaded == 1);
+	REQUIRE(stats.memoryUsage == sizeof(StatsContent));
+
+	const std::string json = stats.ToJson("Stats\"Content");
+	REQUIRE(json.front() == '{');
+	REQUIRE(json.back() == '}');
+	REQUIRE(json.find("\"type\":\"Stats\\\"Content\"") != std::string::npos);
+
+	if (!ContentStats::Enabled())
+	{
+		REQUIRE(stats.loads == 0);
+		REQUIRE(json.find("\"enabled\":false") != std::string::npos);
+	}
+	else
+	{
+		REQUIRE(stats.loads == 3);
+		REQUIRE(stats.reloads == 1);
+		REQUIRE(stats.unloads == 1);
+		REQUIRE(stats.failures == 1);
+		REQUIRE(stats.lookups == 3);
+		REQUIRE(stats.misses == 1);
+
+		REQUIRE(stats.construct.count == 4);
+		REQUIRE(stats.metadataParse.count == 3);
+		REQUIRE(stats.destroy.count == 2);
+		REQUIRE(stats.lockWait.count > 0);
+		REQUIRE(stats.construct.maxNanoseconds <= stats.construct.totalNanoseconds);
+
+		ULong bucketed = 0;
+		for (ULong b : stats.construct.buckets) bucketed += b;
+		REQUIRE(bucketed == stats.construct.count);
+
+		REQUIRE(json.find("\"enabled\":true") != std::string::npos);
+		REQUIRE(json.find("\"loads\":3") != std::string::npos);
+		REQUIRE(json.find("\"construct\":{\"count\":4") != std::string::npos);
+
+		C::ResetStats();
+		REQUIRE(C::GetStats().loads == 0);
+		REQUIRE(C::GetStats().construct.count == 0);
+	}
+
+	REQUIRE(C::UnloadContent("a"));
+}
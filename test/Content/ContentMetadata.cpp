@@ -0,0 +1,210 @@
+#include "TestValues.hpp"
+#include "ValkyrieEngineCommon/ContentMetadata.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+using namespace vlk;
+
+namespace
+{
+	std::string Value(const ContentMetadata& m, const std::string& key)
+	{
+		const char* value;
+		Size size;
+		if (!m.Find(key, value, size)) return "<missing>";
+		return std::string(value, size);
+	}
+
+	void WriteText(const std::string& path, const std::string& text)
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out << text;
+	}
+}
+
+TEST_CASE("Metadata key interning")
+{
+	const UInt a = MetadataKeys::Intern("interning_test_a");
+	const UInt b = MetadataKeys::Intern("interning_test_b");
+
+	REQUIRE(a != b);
+	REQUIRE(MetadataKeys::Intern("interning_test_a") == a);
+	REQUIRE(MetadataKeys::Name(b) == "interning_test_b");
+
+	UInt id;
+	REQUIRE(MetadataKeys::Find("interning_test_a", id));
+	REQUIRE(id == a);
+	REQUIRE(!MetadataKeys::Find("interning_test_never_interned", id));
+}
+
+TEST_CASE("Metadata parsing")
+{
+	const std::string text =
+		"!version=1\n"
+		"# comment=ignored\n"
+		"\n"
+		"key=value\n"
+		"spaced key=a value = with equals\n"
+		"=no key\n"
+		"no separator\n"
+		"empty=\n"
+		"key=duplicate\n"
+		"last=no newline";
+
+	std::unique_ptr<ContentMetadata> m = ContentMetadata::Parse(text.data(), text.size());
+
+	REQUIRE(m->Count() == 4);
+	REQUIRE(Value(*m, "key") == "value");
+	REQUIRE(Value(*m, "spaced key") == "a value = with equals");
+	REQUIRE(Value(*m, "empty") == "");
+	REQUIRE(Value(*m, "last") == "no newline");
+	REQUIRE(Value(*m, "!version") == "<missing>");
+	REQUIRE(Value(*m, "# comment") == "<missing>");
+	REQUIRE(Value(*m, "") == "<missing>");
+	REQUIRE(Value(*m, "no separator") == "<missing>");
+
+	REQUIRE(ContentMetadata::Parse("", 0)->Count() == 0);
+}
+
+TEST_CASE("Metadata binary cache")
+{
+	const std::string file = "metadata_cache_test";
+	std::remove((file + ".metab").c_str());
+
+	REQUIRE(ContentMetadata::Load(file, true) == nullptr);
+
+	WriteText(file + ".meta", "!version=1\nfirst=1\nsecond=two\n");
+
+	std::unique_ptr<ContentMetadata> parsed = ContentMetadata::Load(file, false);
+	REQUIRE(parsed != nullptr);
+	REQUIRE(!std::ifstream(file + ".metab").good());
+
+	// The first load with the cache enabled writes it, the second maps it
+	std::unique_ptr<ContentMetadata> written = ContentMetadata::Load(file, true);
+	REQUIRE(std::ifstream(file + ".metab").good());
+	std::unique_ptr<ContentMetadata> cached = ContentMetadata::Load(file, true);
+
+	for (const ContentMetadata* m : { parsed.get(), written.get(), cached.get() })
+	{
+		REQUIRE(m->Count() == 2);
+		REQUIRE(Value(*m, "first") == "1");
+		REQUIRE(Value(*m, "second") == "two");
+	}
+
+	// Changing the meta file invalidates the cache
+	WriteText(file + ".meta", "!version=1\nfirst=changed\n");
+	std::unique_ptr<ContentMetadata> changed = ContentMetadata::Load(file, true);
+	REQUIRE(changed->Count() == 1);
+	REQUIRE(Value(*changed, "first") == "changed");
+	REQUIRE(Value(*ContentMetadata::Load(file, true), "first") == "changed");
+
+	// So does rewriting it with the same length within the same second, once the file system clock ticks
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	WriteText(file + ".meta", "!version=1\nfirst=CHANGED\n");
+	REQUIRE(Value(*ContentMetadata::Load(file, true), "first") == "CHANGED");
+	REQUIRE(Value(*ContentMetadata::Load(file, true), "first") == "CHANGED");
+
+	// A corrupt cache is ignored
+	WriteText(file + ".metab", "not a cache");
+	REQUIRE(Value(*ContentMetadata::Load(file, true), "first") == "CHANGED");
+
+	std::remove((file + ".meta").c_str());
+	std::remove((file + ".metab").c_str());
+}
+
+TEST_CASE("Typed metadata values")
+{
+	const std::string text =
+		"int=42\n"
+		"negative= -7 \r\n"
+		"float=0.25\n"
+		"exponent=1e3\n"
+		"true=TRUE\n"
+		"yes=yes\n"
+		"off=Off\n"
+		"one=1\n"
+		"zero=0\n"
+		"text=hello world\n"
+		"partial=12abc\n"
+		"overflow=99999999999999999999\n"
+		"empty=\n";
+
+	std::unique_ptr<ContentMetadata> m = ContentMetadata::Parse(text.data(), text.size());
+
+	Long i = -1;
+	REQUIRE(m->GetInt(std::string("int"), i));
+	REQUIRE(i == 42);
+	REQUIRE(m->GetInt(MetadataKeys::Intern("negative"), i));
+	REQUIRE(i == -7);
+	REQUIRE(m->GetInt(std::string("one"), i));
+	REQUIRE(i == 1);
+
+	i = -1;
+	REQUIRE(!m->GetInt(std::string("float"), i));
+	REQUIRE(!m->GetInt(std::string("text"), i));
+	REQUIRE(!m->GetInt(std::string("partial"), i));
+	REQUIRE(!m->GetInt(std::string("overflow"), i));
+	REQUIRE(!m->GetInt(std::string("empty"), i));
+	REQUIRE(!m->GetInt(std::string("missing"), i));
+	REQUIRE(i == -1);
+
+	Double d = -1;
+	REQUIRE(m->GetFloat(std::string("float"), d));
+	REQUIRE(d == 0.25);
+	REQUIRE(m->GetFloat(std::string("exponent"), d));
+	REQUIRE(d == 1000);
+	REQUIRE(m->GetFloat(std::string("int"), d));
+	REQUIRE(d == 42);
+	REQUIRE(!m->GetFloat(std::string("text"), d));
+	REQUIRE(!m->GetFloat(std::string("partial"), d));
+
+	bool b = false;
+	REQUIRE(m->GetBool(std::string("true"), b));
+	REQUIRE(b);
+	REQUIRE(m->GetBool(std::string("off"), b));
+	REQUIRE(!b);
+	REQUIRE(m->GetBool(std::string("yes"), b));
+	REQUIRE(b);
+	REQUIRE(m->GetBool(std::string("zero"), b));
+	REQUIRE(!b);
+	REQUIRE(m->GetBool(std::string("one"), b));
+	REQUIRE(b);
+	REQUIRE(!m->GetBool(std::string("int"), b));
+	REQUIRE(!m->GetBool(std::string("text"), b));
+
+	MetadataView v;
+	REQUIRE(m->GetView(std::string("text"), v));
+	REQUIRE(v == "hello world");
+	REQUIRE(v.ToString() == "hello world");
+	REQUIRE(m->GetView(std::string("negative"), v));
+	REQUIRE(v == " -7 \r");
+	REQUIRE(m->GetView(std::string("empty"), v));
+	REQUIRE(v.Empty());
+	REQUIRE(!m->GetView(std::string("missing"), v));
+}
+
+TEST_CASE("Typed metadata values from the binary cache")
+{
+	const std::string file = "metadata_typed_cache_test";
+	std::remove((file + ".metab").c_str());
+	WriteText(file + ".meta", "count=3\nscale=1.5\nenabled=on\n");
+
+	REQUIRE(ContentMetadata::Load(file, true) != nullptr);
+	std::unique_ptr<ContentMetadata> cached = ContentMetadata::Load(file, true);
+
+	Long i;
+	Double d;
+	bool b = false;
+	REQUIRE(cached->GetInt(std::string("count"), i));
+	REQUIRE(i == 3);
+	REQUIRE(cached->GetFloat(std::string("scale"), d));
+	REQUIRE(d == 1.5);
+	REQUIRE(cached->GetBool(std::string("enabled"), b));
+	REQUIRE(b);
+
+	std::remove((file + ".meta").c_str());
+	std::remove((file + ".metab").c_str());
+}
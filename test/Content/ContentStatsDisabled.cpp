@@ -0,0 +1,67 @@
+#include "catch2/catch.hpp"
+#include "ValkyrieEngineCommon/Content.hpp"
+#include <string>
+
+// Built into its own driver without VLK_COMMON_CONTENT_STATS, which the main test driver defines
+
+using namespace vlk;
+
+static_assert(!ContentStats::Enabled(), "Statistics are disabled in this driver");
+
+struct UnrecordedContent
+{
+	std::string path;
+};
+
+template<>
+UnrecordedContent* vlk::ConstructContent(const std::string& path)
+{
+	if (path.find("missing") != std::string::npos) return nullptr;
+	return new UnrecordedContent{path};
+}
+
+template<>
+void vlk::DestroyContent(UnrecordedContent* c)
+{
+	delete c;
+}
+
+TEST_CASE("Content statistics disabled")
+{
+	typedef Content<UnrecordedContent> C;
+
+	REQUIRE(C::LoadContent("first", "a"));
+	REQUIRE(C::LoadContent("second", "a"));
+	REQUIRE(C::LoadContent("third", "b"));
+	REQUIRE(!C::LoadContent("missing", "c"));
+
+	REQUIRE(C::GetContent("a") != nullptr);
+	REQUIRE(C::GetContent(C::Resolve("b")) != nullptr);
+	REQUIRE(C::GetContent("c") == nullptr);
+	REQUIRE(C::UnloadContent("b"));
+
+	// Only the registry itself is reported
+	const ContentStats stats = C::GetStats();
+	REQUIRE(stats.loaded == 1);
+	REQUIRE(stats.loads == 0);
+	REQUIRE(stats.reloads == 0);
+	REQUIRE(stats.unloads == 0);
+	REQUIRE(stats.failures == 0);
+	REQUIRE(stats.lookups == 0);
+	REQUIRE(stats.misses == 0);
+
+	for (const LatencyHistogram* h : { &stats.construct, &stats.destroy, &stats.metadataParse, &stats.lockWait })
+	{
+		REQUIRE(h->count == 0);
+		REQUIRE(h->totalNanoseconds == 0);
+		REQUIRE(h->maxNanoseconds == 0);
+		for (ULong b : h->buckets) REQUIRE(b == 0);
+	}
+
+	const std::string json = stats.ToJson("UnrecordedContent");
+	REQUIRE(json.find("\"enabled\":false") != std::string::npos);
+	REQUIRE(json.find("\"loads\":0") != std::string::npos);
+	REQUIRE(json.find("\"construct\":{\"count\":0") != std::string::npos);
+
+	REQUIRE(C::UnloadContent("a"));
+}
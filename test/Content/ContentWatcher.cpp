@@ -0,0 +1,87 @@
+#include "TestValues.hpp"
+#include "ValkyrieEngineCommon/ContentWatcher.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace vlk;
+
+#ifdef __linux__
+namespace
+{
+	void WriteText(const std::string& path, const std::string& text)
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out << text;
+	}
+
+	//! Polls until a change is reported, rewriting <tt>file</tt> between polls in case the watch on its directory was not ready yet.
+	std::vector<std::string> WaitForChange(ContentWatcher& watcher, const std::string& file)
+	{
+		for (int i = 0; i < 100; i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			std::vector<std::string> changed = watcher.Poll();
+			if (!changed.empty()) return changed;
+			if (i % 10 == 9) WriteText(file, "retry");
+		}
+
+		return {};
+	}
+}
+
+TEST_CASE("Content directory watching")
+{
+	REQUIRE(ContentWatcher::IsSupported());
+	REQUIRE_THROWS_AS(ContentWatcher("watch_test_missing"), std::runtime_error);
+
+	mkdir("watch_test", 0755);
+	{
+		ContentWatcher watcher("watch_test", std::chrono::milliseconds(20));
+		REQUIRE(watcher.Poll().empty());
+
+		// A burst of writes is reported once
+		for (int i = 0; i < 5; i++) WriteText("watch_test/a", "burst " + std::to_string(i));
+		REQUIRE(WaitForChange(watcher, "watch_test/a") == std::vector<std::string>{ "a" });
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		REQUIRE(watcher.Poll().empty());
+
+		// New directories are watched
+		mkdir("watch_test/sub", 0755);
+		WriteText("watch_test/sub/b", "b");
+		REQUIRE(WaitForChange(watcher, "watch_test/sub/b") == std::vector<std::string>{ "sub/b" });
+
+		// Files moved into place, as written by most editors, are reported
+		WriteText("watch_test_c", "c");
+		std::rename("watch_test_c", "watch_test/c");
+		REQUIRE(WaitForChange(watcher, "watch_test/c") == std::vector<std::string>{ "c" });
+
+		// Directories moved within the tree are reported under their new path, with the files in them
+		std::rename("watch_test/sub", "watch_test/moved");
+		REQUIRE(WaitForChange(watcher, "watch_test/moved/b") == std::vector<std::string>{ "moved/b" });
+
+		// Directories moved out of the tree are no longer watched
+		std::rename("watch_test/moved", "watch_test_outside");
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		WriteText("watch_test_outside/d", "d");
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		REQUIRE(watcher.Poll().empty());
+		REQUIRE(!watcher.HasFailed());
+	}
+
+	std::remove("watch_test_outside/b");
+	std::remove("watch_test_outside/d");
+	rmdir("watch_test_outside");
+	std::remove("watch_test/a");
+	std::remove("watch_test/c");
+	rmdir("watch_test");
+}
+#endif
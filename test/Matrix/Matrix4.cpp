@@ -818,3 +818,165 @@ TEST_CASE("Matrix4 angle-axis")
 	REQUIRE(u[2] == Approx( 1.f));
 	REQUIRE(u[3] == Approx( 1.f));
 }
+
+namespace
+{
+	constexpr Matrix4 spin = Matrix4::CreateRotation(ForceCXPR(vlk::HalfPi), ForceCXPR(Vector3(0.f, 0.f, 1.f)));
+}
+
+static_assert(spin[0][1] == 1.f && spin[1][0] == -1.f && spin[2][2] > 0.999999f && spin[3][3] == 1.f, "Matrix4 angle-axis rotation is constexpr");
+
+TEST_CASE("Matrix4 angle-axis matches axis rotations")
+{
+	const Float angle = 0.7f;
+	const Matrix4 x(Matrix4::CreateRotation(angle, Vector3(1.f, 0.f, 0.f)));
+	const Matrix4 y(Matrix4::CreateRotation(angle, Vector3(0.f, 1.f, 0.f)));
+	const Matrix4 z(Matrix4::CreateRotation(angle, Vector3(0.f, 0.f, 1.f)));
+
+	for (int i = 0; i < 4; i++)
+	{
+		for (int j = 0; j < 4; j++)
+		{
+			REQUIRE(x[i][j] == Approx(Matrix4::CreateRotationX(angle)[i][j]).margin(1e-6));
+			REQUIRE(y[i][j] == Approx(Matrix4::CreateRotationY(angle)[i][j]).margin(1e-6));
+			REQUIRE(z[i][j] == Approx(Matrix4::CreateRotationZ(angle)[i][j]).margin(1e-6));
+		}
+	}
+}
+
+TEST_CASE("Matrix4 inverse matches generic inverse")
+{
+	Matrix4 m(
+		0.0f, 1.0f, 2.0f, -2.0f,
+		9.0f, 8.0f, 7.0f,  0.0f,
+		3.0f, 4.0f, 5.0f,  4.0f,
+		2.0f, 6.0f, 1.0f, -7.0f);
+
+	MatrixBase<4, 4, Float> b;
+	for (Size x = 0; x < 4; x++)
+	{
+		for (Size y = 0; y < 4; y++)
+		{
+			b[x][y] = m[x][y];
+		}
+	}
+
+	Matrix4 n = !m;
+	MatrixBase<4, 4, Float> g = b.Inverse();
+
+	REQUIRE(m.Determinant() == Approx(b.Determinant()));
+
+	for (Size x = 0; x < 4; x++)
+	{
+		for (Size y = 0; y < 4; y++)
+		{
+			REQUIRE(n[x][y] == Approx(g[x][y]).margin(0.00001));
+		}
+	}
+
+	VLK_CXX14_CONSTEXPR Matrix4 c = !Matrix4::CreateScale(Vector3(2.0f, 4.0f, 8.0f));
+	VLK_STATIC_ASSERT_MSG(c[0][0] == 0.5f && c[1][1] == 0.25f && c[2][2] == 0.125f && c[3][3] == 1.0f, "Constant evaluation of Matrix4 inverse failed");
+}
+
+TEST_CASE("Matrix4 affine inverse")
+{
+	Matrix4 m(
+		Matrix4::CreateTranslation(Vector3(10.0f, -20.0f, 3.0f)) *
+		Matrix4::CreateRotation(Vector3(0.3f, -1.2f, 2.0f)) *
+		Matrix4::CreateScale(Vector3(2.0f, 0.5f, 3.0f)));
+
+	Matrix4 n(m.InverseAffine());
+	Matrix4 g(!m);
+
+	for (Size x = 0; x < 4; x++)
+	{
+		for (Size y = 0; y < 4; y++)
+		{
+			REQUIRE(n[x][y] == Approx(g[x][y]).margin(0.00001));
+		}
+	}
+
+	Vector4 v(1.0f, 2.0f, 3.0f, 1.0f);
+	Vector4 u(n * (m * v));
+
+	REQUIRE(u.X() == Approx(v.X()));
+	REQUIRE(u.Y() == Approx(v.Y()));
+	REQUIRE(u.Z() == Approx(v.Z()));
+	REQUIRE(u.W() == Approx(v.W()));
+}
+
+TEST_CASE("Matrix4 multiplication matches generic multiplication")
+{
+	Matrix4 m(
+		0.0f, 1.0f, 2.0f, -2.0f,
+		9.0f, 8.0f, 7.0f,  0.5f,
+		3.0f, 4.0f, 5.0f,  4.0f,
+		2.0f, 6.0f, 1.0f, -7.0f);
+
+	Matrix4 n(
+		Matrix4::CreateTranslation(Vector3(10.0f, -20.0f, 3.0f)) *
+		Matrix4::CreateRotation(Vector3(0.3f, -1.2f, 2.0f)));
+
+	MatrixBase<4, 4, Float> a;
+	MatrixBase<4, 4, Float> b;
+	for (Size x = 0; x < 4; x++)
+	{
+		for (Size y = 0; y < 4; y++)
+		{
+			a[x][y] = m[x][y];
+			b[x][y] = n[x][y];
+		}
+	}
+
+	// == treats -0 and +0 as equal, and without FMA code generation the
+	// multiply-adds are not contracted, so the products compare equal
+	Matrix4 p(m * n);
+	MatrixBase<4, 4, Float> g(a * b);
+
+	for (Size x = 0; x < 4; x++)
+	{
+		for (Size y = 0; y < 4; y++)
+		{
+			REQUIRE(p[x][y] == g[x][y]);
+		}
+	}
+
+	Vector4 v(1.0f, -2.0f, 3.0f, 1.0f);
+	Vector4 u(m * v);
+	MatrixBase<4, 4, Float>::ColType w(a * MatrixBase<4, 4, Float>::ColType({1.0f, -2.0f, 3.0f, 1.0f}));
+
+	for (Size i = 0; i < 4; i++)
+	{
+		REQUIRE(u[i] == w[i]);
+	}
+
+	VLK_CXX14_CONSTEXPR Matrix4 c = Matrix4::CreateScale(Vector3(2.0f, 4.0f, 8.0f)) * Matrix4::CreateTranslation(Vector3(1.0f, 1.0f, 1.0f));
+	VLK_STATIC_ASSERT_MSG(c[3][0] == 2.0f && c[3][1] == 4.0f && c[3][2] == 8.0f && c[3][3] == 1.0f, "Constant evaluation of Matrix4 multiplication failed");
+}
+
+TEST_CASE("Matrix4 transform points")
+{
+	Matrix4 m(
+		Matrix4::CreateTranslation(Vector3(10.0f, -20.0f, 3.0f)) *
+		Matrix4::CreateRotation(Vector3(0.3f, -1.2f, 2.0f)) *
+		Matrix4::CreateScale(Vector3(2.0f, 0.5f, 3.0f)));
+
+	std::vector<Float> f(reducedValues);
+	std::vector<Vector4> in;
+	for (Size i = 0; i + 2 < 16; i++)
+	{
+		in.push_back(Vector4(f[i], f[i + 1], f[i + 2], 1.0f));
+	}
+
+	std::vector<Vector4> out(in.size());
+	m.TransformPoints(in.data(), out.data(), in.size());
+
+	for (Size i = 0; i < in.size(); i++)
+	{
+		REQUIRE(out[i] == m * in[i]);
+	}
+
+	std::vector<Vector4> inPlace(in);
+	m.TransformPoints(inPlace.data(), inPlace.data(), inPlace.size());
+	REQUIRE(inPlace == out);
+}
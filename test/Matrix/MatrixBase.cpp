@@ -0,0 +1,144 @@
+#include "TestValues.hpp"
+#include "ValkyrieEngineCommon/Matrix.hpp"
+
+using namespace vlk;
+
+//Dominated by one large element per column on a cyclic shift of the diagonal, so well-conditioned, but requiring row swaps during decomposition
+template <Size N>
+static VLK_CXX14_CONSTEXPR MatrixBase<N, N, Float> GetTestMatrix()
+{
+	MatrixBase<N, N, Float> m;
+
+	for (Size x = 0; x < N; x++)
+	{
+		for (Size y = 0; y < N; y++)
+		{
+			m[x][y] = static_cast<Float>((x * 7 + y * 3) % 5) - 2.0f;
+		}
+
+		m[x][(x + 1) % N] += static_cast<Float>(N * 2);
+	}
+
+	return m;
+}
+
+//Recursive cofactor expansion along the first column, never calling MatrixBase::Determinant
+template <Size N>
+struct CofactorDeterminant
+{
+	static double Get(const MatrixBase<N, N, Float>& m)
+	{
+		double det = 0.0;
+		double mod = 1.0;
+
+		for (Size n = 0; n < N; n++)
+		{
+			MatrixBase<N - 1, N - 1, Float> sub;
+			Size x1 = 0;
+
+			for (Size x = 0; x < N; x++)
+			{
+				if (x == n) continue;
+				for (Size y = 1; y < N; y++) sub[x1][y - 1] = m[x][y];
+				x1++;
+			}
+
+			det += mod * static_cast<double>(m[n][0]) * CofactorDeterminant<N - 1>::Get(sub);
+			mod = -mod;
+		}
+
+		return det;
+	}
+};
+
+template <>
+struct CofactorDeterminant<1>
+{
+	static double Get(const MatrixBase<1, 1, Float>& m)
+	{
+		return static_cast<double>(m[0][0]);
+	}
+};
+
+TEMPLATE_TEST_CASE_SIG("MatrixBase LU determinant matches cofactor expansion", "", ((Size N), N), 3, 4, 5, 6)
+{
+	//Independent of VLK_COMMON_LU_THRESHOLD, as no minor goes through MatrixBase::Determinant
+	MatrixBase<N, N, Float> m(GetTestMatrix<N>());
+	const Float det = static_cast<Float>(CofactorDeterminant<N>::Get(m));
+
+	REQUIRE(MatrixBase<N, N, Float>::Determinant(m.Decompose()) == Approx(det));
+	REQUIRE(m.Determinant() == Approx(det));
+}
+
+TEMPLATE_TEST_CASE_SIG("MatrixBase LU inverse", "", ((Size N), N), 3, 4, 6, 8)
+{
+	MatrixBase<N, N, Float> m(GetTestMatrix<N>());
+	MatrixBase<N, N, Float> i(MatrixBase<N, N, Float>::Inverse(m.Decompose()));
+	MatrixBase<N, N, Float> p(m * i);
+
+	for (Size x = 0; x < N; x++)
+	{
+		for (Size y = 0; y < N; y++)
+		{
+			if (x == y) REQUIRE(p[x][y] == Approx(1.0f));
+			else REQUIRE(p[x][y] == Approx(0.0f).margin(0.0001));
+		}
+	}
+
+	MatrixBase<N, N, Float> j(m.Inverse());
+
+	for (Size x = 0; x < N; x++)
+	{
+		for (Size y = 0; y < N; y++)
+		{
+			REQUIRE(j[x][y] == Approx(i[x][y]).margin(0.00001));
+		}
+	}
+}
+
+TEST_CASE("MatrixBase LU solve")
+{
+	MatrixBase<6, 6, Float> m(GetTestMatrix<6>());
+	VectorBase<6, Float> x({1.0f, -2.0f, 3.0f, 0.5f, -0.25f, 8.0f});
+	VectorBase<6, Float> b(m * x);
+
+	VectorBase<6, Float> r(m.Solve(b));
+
+	for (Size n = 0; n < 6; n++)
+	{
+		REQUIRE(r[n] == Approx(x[n]));
+	}
+}
+
+TEST_CASE("MatrixBase LU singular matrix")
+{
+	MatrixBase<5, 5, Float> m(GetTestMatrix<5>());
+
+	//Make two columns equal
+	m[3] = m[1];
+
+	REQUIRE(m.Decompose().sign == 0.0f);
+	REQUIRE(m.Determinant() == 0.0f);
+}
+
+TEST_CASE("MatrixBase LU constexpr")
+{
+	VLK_CXX14_CONSTEXPR MatrixBase<5, 5, Float> m(GetTestMatrix<5>());
+	VLK_CXX14_CONSTEXPR Float det = m.Determinant();
+
+	REQUIRE(det == Approx(MatrixBase<5, 5, Float>::Determinant(GetTestMatrix<5>().Decompose())));
+}
+
+TEST_CASE("MatrixBase integer determinant uses exact cofactor expansion")
+{
+	//Elimination would truncate the quotients between integer elements
+	const Int values[4][4] = { { 2, 1, 0, 0 }, { 1, 3, 1, 0 }, { 0, 1, 3, 1 }, { 0, 0, 1, 2 } };
+	MatrixBase<4, 4, Int> m;
+
+	for (Size x = 0; x < 4; x++)
+	{
+		for (Size y = 0; y < 4; y++) m[x][y] = values[x][y];
+	}
+
+	REQUIRE(m.Determinant() == 21);
+}
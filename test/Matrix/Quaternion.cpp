@@ -180,3 +180,75 @@ TEST_CASE("Quaternion Multiplication")
 	REQUIRE(v[2] == Approx(-1.f).margin(0.0001));
 	REQUIRE(v[3] == Approx(1.f));
 }
+
+TEST_CASE("Quaternion normalize")
+{
+	const Quaternion q(1.0f, -2.0f, 4.0f, 0.5f);
+	const Float length = std::sqrt(1.0f + 4.0f + 16.0f + 0.25f);
+
+	const Quaternion n = Quaternion::Normalized(q);
+	REQUIRE(Quaternion::Length(n) == Approx(1.0f));
+	REQUIRE(n[0] == Approx(1.0f / length));
+	REQUIRE(n[1] == Approx(-2.0f / length));
+	REQUIRE(n[2] == Approx(4.0f / length));
+	REQUIRE(n[3] == Approx(0.5f / length));
+
+	REQUIRE(Quaternion::NormalizedSafe(q) == n);
+
+	const Quaternion f = Quaternion::FastNormalized(q);
+	for (Size i = 0; i < 4; i++) REQUIRE(f[i] == Approx(n[i]).margin(1e-6));
+
+	// The identity rotation is already normalized
+	REQUIRE(Quaternion::Normalized(Quaternion()) == Quaternion());
+	REQUIRE(Quaternion::FastNormalized(Quaternion())[3] == Approx(1.0f).margin(1e-6));
+}
+
+static_assert(Quaternion::Length(ForceCXPR(Quaternion(1.f, 1.f, 1.f, 1.f))).value == 2.f, "Quaternion length is constexpr");
+static_assert(Quaternion::Normalized(ForceCXPR(Quaternion(0.f, 0.f, 3.f, 4.f))).value == Quaternion(0.f, 0.f, 0.6f, 0.8f), "Quaternion normalize is constexpr");
+
+TEST_CASE("Quaternion normalize without a direction")
+{
+	const Quaternion zero(0.0f, 0.0f, 0.0f, 0.0f);
+	const Quaternion nan(std::numeric_limits<Float>::quiet_NaN(), 0.0f, 0.0f, 1.0f);
+	const Quaternion fallback = Quaternion::RotationX(1.0f);
+
+	REQUIRE(Quaternion::NormalizedSafe(zero) == Quaternion());
+	REQUIRE(Quaternion::NormalizedSafe(zero, fallback) == fallback);
+	REQUIRE(Quaternion::NormalizedSafe(nan, fallback) == fallback);
+
+	REQUIRE(Quaternion::FastNormalized(zero) == Quaternion());
+	REQUIRE(Quaternion::FastNormalized(nan) == Quaternion());
+}
+
+TEST_CASE("Quaternion normalize long product chains")
+{
+	const Quaternion step = Quaternion::AngleAxis(0.001f, Vector3::Normalized(Vector3(1.0f, 2.0f, 3.0f))) * Quaternion::RotationY(0.0007f);
+	Quaternion drifting;
+	Quaternion renormalized;
+
+	for (Int i = 0; i < 100000; i++)
+	{
+		drifting = drifting * step;
+		renormalized = Quaternion::FastNormalized(renormalized * step);
+	}
+
+	REQUIRE(Quaternion::Length(renormalized) == Approx(1.0f).margin(1e-6));
+	REQUIRE(std::abs(Quaternion::Length(Quaternion::Normalized(drifting)) - 1.0f) < 1e-6f);
+
+	// Both represent the same rotation once the drifting product is normalized
+	const Quaternion n = Quaternion::Normalized(drifting);
+	for (Size i = 0; i < 4; i++) REQUIRE(renormalized[i] == Approx(n[i]).margin(1e-3));
+}
+
+TEST_CASE("Quaternion fast normalize array")
+{
+	std::vector<Quaternion> q;
+	for (Int i = 0; i < 7; i++) q.push_back(Quaternion(Float(i), 1.0f, Float(-i), 2.0f));
+	q.push_back(Quaternion(0.0f, 0.0f, 0.0f, 0.0f));
+
+	std::vector<Quaternion> out(q.size());
+	Quaternion::FastNormalized(q.data(), out.data(), q.size());
+
+	for (Size i = 0; i < q.size(); i++) REQUIRE(out[i] == Quaternion::FastNormalized(q[i]));
+	REQUIRE(out.back() == Quaternion());
+}
@@ -0,0 +1,122 @@
+#include "TestValues.hpp"
+#include "ValkyrieEngineCommon/ReadMostlyMap.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace vlk;
+
+TEST_CASE("ReadMostlyMap insert, find and erase")
+{
+	ReadMostlyMap<std::string, int> m;
+	int v = -1;
+
+	REQUIRE(m.Count() == 0);
+	REQUIRE(!m.Find("a", v));
+	REQUIRE(v == -1);
+
+	REQUIRE(m.Insert("a", 1));
+	REQUIRE(m.Find("a", v));
+	REQUIRE(v == 1);
+
+	int previous = 0;
+	REQUIRE(!m.Insert("a", 2, &previous));
+	REQUIRE(previous == 1);
+	REQUIRE(m.Find("a", v));
+	REQUIRE(v == 2);
+
+	// Enough keys to grow the table several times
+	for (int i = 0; i < 1000; i++) REQUIRE(m.Insert(std::to_string(i), i));
+	REQUIRE(m.Count() == 1001);
+
+	for (int i = 0; i < 1000; i += 2) REQUIRE(m.Erase(std::to_string(i), &previous));
+	REQUIRE(previous == 998);
+	REQUIRE(!m.Erase("0"));
+	REQUIRE(m.Count() == 501);
+
+	for (int i = 0; i < 1000; i++)
+	{
+		REQUIRE(m.Find(std::to_string(i), v) == (i % 2 == 1));
+		if (i % 2 == 1) REQUIRE(v == i);
+	}
+
+	Size visited = 0;
+	m.ForEach([&](const std::string&, int) { visited++; });
+	REQUIRE(visited == 501);
+
+	m.Clear();
+	REQUIRE(m.Count() == 0);
+	REQUIRE(!m.Find("a", v));
+}
+
+TEST_CASE("EpochDomain defers destruction while readers are active")
+{
+	EpochDomain& domain = EpochDomain::Global();
+	domain.Collect();
+
+	bool destroyed = false;
+
+	{
+		EpochGuard guard;
+		domain.Retire([&]() { destroyed = true; });
+		REQUIRE(!destroyed);
+
+		{
+			// Nested guards do not end the outer one
+			EpochGuard nested;
+		}
+
+		domain.Collect();
+		REQUIRE(!destroyed);
+	}
+
+	domain.Collect();
+	REQUIRE(destroyed);
+
+	// Objects retired while no reader is active are destroyed immediately
+	destroyed = false;
+	domain.Retire([&]() { destroyed = true; });
+	REQUIRE(destroyed);
+}
+
+TEST_CASE("ReadMostlyMap concurrent readers")
+{
+	ReadMostlyMap<int, int> m;
+	for (int i = 0; i < 64; i++) m.Insert(i, i);
+
+	std::atomic<bool> stop(false);
+	std::atomic<Size> mismatches(0);
+	std::vector<std::thread> readers;
+
+	for (int r = 0; r < 4; r++)
+	{
+		readers.emplace_back([&]()
+		{
+			while (!stop)
+			{
+				for (int i = 0; i < 64; i++)
+				{
+					int v = -1;
+					// Keys below 32 are never erased and always map to themselves or their negation
+					if (!m.Find(i, v) && i < 32) mismatches++;
+					else if (i < 32 && v != i && v != -i) mismatches++;
+				}
+			}
+		});
+	}
+
+	// Grows, shrinks and rewrites the map while the readers run
+	for (int round = 0; round < 200; round++)
+	{
+		for (int i = 0; i < 32; i++) m.Insert(i, (round % 2 == 0) ? -i : i);
+		for (int i = 64; i < 256; i++) m.Insert(i, i);
+		for (int i = 64; i < 256; i++) m.Erase(i);
+	}
+
+	stop = true;
+	for (std::thread& t : readers) t.join();
+
+	REQUIRE(mismatches == 0);
+	REQUIRE(m.Count() == 64);
+}
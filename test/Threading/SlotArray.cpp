@@ -0,0 +1,115 @@
+#include "TestValues.hpp"
+#include "ValkyrieEngineCommon/SlotArray.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace vlk;
+
+TEST_CASE("SlotArray allocate, get and free")
+{
+	SlotArray<int> slots;
+	std::vector<int> values(1000);
+	std::vector<UInt> indices(values.size());
+	std::vector<UInt> generations(values.size());
+
+	// Spans several chunks
+	for (Size i = 0; i < values.size(); i++)
+	{
+		values[i] = static_cast<int>(i);
+		slots.Allocate(&values[i], indices[i], generations[i]);
+		REQUIRE(indices[i] == i);
+		REQUIRE(generations[i] % 2 == 1);
+	}
+
+	for (Size i = 0; i < values.size(); i++)
+	{
+		REQUIRE(slots.Get(indices[i], generations[i]) == &values[i]);
+	}
+
+	// Indices past the allocated chunks and null generations are rejected
+	REQUIRE(slots.Get(100000, 1) == nullptr);
+	REQUIRE(slots.Get(~UInt(0), 1) == nullptr);
+	REQUIRE(slots.Get(indices[0], 0) == nullptr);
+
+	slots.Free(indices[10]);
+	REQUIRE(slots.Get(indices[10], generations[10]) == nullptr);
+
+	// Freed slots are reused with a new generation
+	int reused = -1;
+	UInt index, generation;
+	slots.Allocate(&reused, index, generation);
+	REQUIRE(index == indices[10]);
+	REQUIRE(generation != generations[10]);
+	REQUIRE(slots.Get(index, generation) == &reused);
+	REQUIRE(slots.Get(indices[10], generations[10]) == nullptr);
+}
+
+TEST_CASE("SlotArray referenced bits")
+{
+	SlotArray<int> slots;
+	int value = 0;
+	UInt index, generation;
+
+	// Newly allocated slots count as referenced
+	slots.Allocate(&value, index, generation);
+	REQUIRE(slots.ClearReferenced(index));
+	REQUIRE(!slots.ClearReferenced(index));
+
+	slots.Touch(index);
+	slots.Touch(index);
+	REQUIRE(slots.ClearReferenced(index));
+	REQUIRE(!slots.ClearReferenced(index));
+
+	// Touching an index past the allocated chunks is ignored
+	slots.Touch(100000);
+}
+
+TEST_CASE("SlotArray stale indices during concurrent reuse")
+{
+	SlotArray<int> slots;
+	int values[2] = { 0, 1 };
+	UInt index, generation;
+
+	// Allocation k of the only slot has generation 2k + 1 and stores values[k % 2]
+	slots.Allocate(&values[0], index, generation);
+	std::atomic<UInt> published(generation);
+	std::atomic<bool> stop(false);
+	std::atomic<Size> mismatches(0);
+	std::vector<std::thread> readers;
+
+	for (int r = 0; r < 4; r++)
+	{
+		readers.emplace_back([&]()
+		{
+			while (!stop)
+			{
+				const UInt g = published.load();
+				const int* expected = &values[((g - 1) / 2) % 2];
+
+				// Keeps reading the handle after it went stale; it must never return the new occupant
+				for (int i = 0; i < 64; i++)
+				{
+					const int* v = slots.Get(index, g);
+					if (v != nullptr && v != expected) mismatches++;
+				}
+			}
+		});
+	}
+
+	for (UInt k = 1; k < 200000; k++)
+	{
+		slots.Free(index);
+		slots.Allocate(&values[k % 2], index, generation);
+		published.store(generation);
+
+		// Lets the readers run between reuses on machines with few cores
+		if (k % 1024 == 0) std::this_thread::yield();
+	}
+
+	stop = true;
+	for (std::thread& t : readers) t.join();
+
+	REQUIRE(mismatches == 0);
+	REQUIRE(generation == 2 * 200000 - 1);
+}
@@ -0,0 +1,109 @@
+#include "TestValues.hpp"
+#include "ValkyrieEngineCommon/ThreadPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace vlk;
+
+TEST_CASE("ThreadPool parallel for")
+{
+	for (Size threads : { Size(0), Size(1), Size(4) })
+	{
+		ThreadPool pool(threads);
+		REQUIRE(pool.ThreadCount() == threads);
+
+		// Catch2 assertions are not thread safe, so results are checked afterwards
+		std::vector<std::atomic<int>> visits(1000);
+		std::atomic<Size> largest(0);
+		for (std::atomic<int>& v : visits) v = 0;
+
+		pool.ParallelFor(visits.size(), 7, [&](Size begin, Size end)
+		{
+			Size size = largest;
+			while (end - begin > size && !largest.compare_exchange_weak(size, end - begin)) { }
+			for (Size i = begin; i < end; i++) visits[i]++;
+		});
+
+		REQUIRE(largest == 7);
+		for (std::atomic<int>& v : visits) REQUIRE(v == 1);
+
+		std::atomic<Size> calls(0);
+		pool.ParallelFor(0, 7, [&](Size, Size) { calls++; });
+		REQUIRE(calls == 0);
+	}
+}
+
+TEST_CASE("ThreadPool nested parallel for")
+{
+	ThreadPool pool(2);
+	std::atomic<Size> sum(0);
+
+	pool.ParallelFor(8, 1, [&](Size, Size)
+	{
+		pool.ParallelFor(100, 10, [&](Size begin, Size end)
+		{
+			sum += end - begin;
+		});
+	});
+
+	REQUIRE(sum == 800);
+}
+
+#ifndef _WIN32
+// std::clock() measures wall time rather than processor time on Windows
+TEST_CASE("ThreadPool parallel for sleeps while other threads finish")
+{
+	ThreadPool pool(1);
+	const std::thread::id caller = std::this_thread::get_id();
+	std::atomic<bool> started(false);
+	std::clock_t start = 0;
+
+	// Whichever chunk the caller runs waits for the worker to start the other, which then sleeps
+	pool.ParallelFor(2, 1, [&](Size, Size)
+	{
+		if (std::this_thread::get_id() == caller)
+		{
+			while (!started) std::this_thread::yield();
+			start = std::clock();
+		}
+		else
+		{
+			started = true;
+			std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		}
+	});
+
+	// Processor time of the whole process, which the sleeping worker does not add to
+	REQUIRE(double(std::clock() - start) / CLOCKS_PER_SEC < 0.1);
+}
+#endif
+
+TEST_CASE("ThreadPool exceptions")
+{
+	ThreadPool pool(2);
+	std::atomic<Size> calls(0);
+
+	REQUIRE_THROWS_AS(pool.ParallelFor(16, 1, [&](Size begin, Size)
+	{
+		calls++;
+		if (begin == 5) throw std::runtime_error("Task failed");
+	}), std::runtime_error);
+
+	REQUIRE(calls == 16);
+}
+
+TEST_CASE("ThreadPool submit")
+{
+	std::atomic<Size> done(0);
+
+	{
+		ThreadPool pool(3);
+		for (Size i = 0; i < 64; i++) pool.Submit([&]() { done++; });
+	}
+
+	REQUIRE(done == 64);
+}
@@ -222,3 +222,138 @@ TEST_CASE("Transform3D global")
 	REQUIRE(t.GetWorldMatrix() == t.GetMatrix());
 	REQUIRE(r.GetWorldMatrix() == t.GetMatrix() * r.GetMatrix());
 }*/
+
+TEST_CASE("Transform3D cached world matrix")
+{
+	Transform3D chain[8];
+	for (Size i = 0; i < 8; i++)
+	{
+		chain[i].translation = Vector3(Float(i), 1.0f, -2.0f);
+		chain[i].rotation = Quaternion::AngleAxis(0.1f * Float(i + 1), Vector3::Normalized(Vector3(1.f, 2.f, 3.f)));
+		chain[i].scale = Vector3(1.1f, 0.9f, 1.0f);
+		if (i > 0) chain[i].SetParent(&chain[i - 1]);
+	}
+
+	Transform3D& leaf = chain[7];
+	Matrix4 uncached(leaf.GetWorldMatrix());
+
+	for (Transform3D& t : chain) t.SetCachingEnabled(true);
+	REQUIRE(leaf.IsCachingEnabled());
+	REQUIRE(leaf.GetWorldMatrix() == uncached);
+	REQUIRE(leaf.GetWorldMatrix() == uncached);
+
+	SECTION("Setters invalidate children")
+	{
+		chain[2].SetTranslation(Vector3(4.0f, 5.0f, 6.0f));
+		chain[5].SetRotation(Quaternion::AngleAxis(1.0f, Vector3::Up()));
+		chain[0].SetScale(Vector3(2.0f, 2.0f, 2.0f));
+
+		Matrix4 cached(leaf.GetWorldMatrix());
+		for (Transform3D& t : chain) t.SetCachingEnabled(false);
+		REQUIRE(cached == leaf.GetWorldMatrix());
+		REQUIRE(cached != uncached);
+	}
+
+	SECTION("Local matrix queried before the world matrix")
+	{
+		chain[2].SetTranslation(Vector3(5.0f, 0.0f, 0.0f));
+		Matrix4 local(chain[2].GetMatrix());
+		Matrix4 world(chain[2].GetWorldMatrix());
+		Matrix4 cached(leaf.GetWorldMatrix());
+		for (Transform3D& t : chain) t.SetCachingEnabled(false);
+		REQUIRE(local == chain[2].GetMatrix());
+		REQUIRE(world == chain[2].GetWorldMatrix());
+		REQUIRE(cached == leaf.GetWorldMatrix());
+		REQUIRE(cached != uncached);
+	}
+
+	SECTION("Direct modification with Invalidate")
+	{
+		chain[3].translation = Vector3(-7.0f, 0.0f, 0.0f);
+		REQUIRE(leaf.GetWorldMatrix() == uncached);
+
+		chain[3].Invalidate();
+		Matrix4 cached(leaf.GetWorldMatrix());
+		chain[3].SetCachingEnabled(false);
+		REQUIRE(cached == leaf.GetWorldMatrix());
+	}
+
+	SECTION("Reparenting")
+	{
+		leaf.SetParent(&chain[1]);
+		Matrix4 expected(chain[1].GetWorldMatrix() * leaf.GetMatrix());
+		REQUIRE(leaf.GetWorldMatrix() == expected);
+
+		leaf.SetParent(nullptr);
+		REQUIRE(leaf.GetWorldMatrix() == leaf.GetMatrix());
+	}
+
+	SECTION("Uncached parent")
+	{
+		chain[6].SetCachingEnabled(false);
+		chain[6].translation = Vector3(1.0f, 2.0f, 3.0f);
+		REQUIRE(leaf.GetWorldMatrix() == chain[6].GetWorldMatrix() * leaf.GetMatrix());
+	}
+
+	SECTION("Copy assignment invalidates children")
+	{
+		Transform3D other(chain[4]);
+		other.SetTranslation(Vector3(9.0f, 9.0f, 9.0f));
+		other.GetWorldMatrix();
+		chain[4] = other;
+
+		Matrix4 cached(leaf.GetWorldMatrix());
+		for (Transform3D& t : chain) t.SetCachingEnabled(false);
+		REQUIRE(cached == leaf.GetWorldMatrix());
+	}
+}
+
+namespace
+{
+	constexpr bool Near(Float a, Float b) { return a - b < 1e-5f && b - a < 1e-5f; }
+
+	constexpr Transform3D rig(
+		Vector3(0.f, 2.f, 0.f),
+		Quaternion::AngleAxis(ForceCXPR(vlk::HalfPi), ForceCXPR(Vector3(0.f, 0.f, 1.f))),
+		Vector3(2.f, 2.f, 2.f));
+
+	constexpr Transform3D camera(Vector3(1.f, 0.f, 0.f), Quaternion(), Vector3::One(), &rig);
+
+	constexpr Matrix4 cameraWorld = camera.GetWorldMatrix(ForceCXPR());
+	constexpr Vector3 cameraPosition = camera.GetWorldTranslation(ForceCXPR());
+}
+
+// Static hierarchies are evaluated entirely at compile time
+static_assert(camera.GetParent() == &rig, "Transform3D component constructor sets the parent");
+static_assert(camera.GetMatrix(ForceCXPR()).value == Matrix4::CreateTranslation(Vector3(1.f, 0.f, 0.f)), "Transform3D local matrix is constexpr");
+static_assert(Near(cameraPosition.X(), 0.f) && Near(cameraPosition.Y(), 4.f) && Near(cameraPosition.Z(), 0.f), "Transform3D world translation is constexpr");
+static_assert(Near(cameraWorld[0][1], 2.f) && Near(cameraWorld[1][0], -2.f) && Near(cameraWorld[2][2], 2.f), "Transform3D world matrix is constexpr");
+
+TEST_CASE("Transform3D constexpr overloads match runtime")
+{
+	Transform3D r(rig);
+	Transform3D c(camera);
+	c.SetParent(&r);
+
+	REQUIRE(c.GetWorldMatrix(ForceCXPR()).value == c.GetWorldMatrix());
+	REQUIRE(c.GetWorldTranslation(ForceCXPR()).value == c.GetWorldTranslation());
+	REQUIRE(c.GetWorldScale(ForceCXPR()).value == c.GetWorldScale());
+
+	for (int x = 0; x < 4; x++)
+	{
+		for (int y = 0; y < 4; y++)
+		{
+			REQUIRE(c.GetWorldMatrix()[x][y] == Approx(cameraWorld[x][y]).margin(1e-6));
+		}
+	}
+
+	// The constexpr overloads bypass the cache
+	r.SetCachingEnabled(true);
+	c.SetCachingEnabled(true);
+	const Matrix4 cached(c.GetWorldMatrix());
+	r.translation = Vector3(5.f, 5.f, 5.f);
+	REQUIRE(c.GetWorldMatrix() == cached);
+	REQUIRE(c.GetWorldMatrix(ForceCXPR()).value != c.GetWorldMatrix());
+	r.Invalidate();
+	REQUIRE(c.GetWorldMatrix(ForceCXPR()).value == c.GetWorldMatrix());
+}
@@ -0,0 +1,172 @@
+#include "TestValues.hpp"
+#include "ValkyrieEngineCommon/TransformGraph.hpp"
+#include <cstring>
+#include <stdexcept>
+
+using namespace vlk;
+
+namespace
+{
+	void SetTestTransform(Transform3D& t, Size i)
+	{
+		t.translation = Vector3(Float(i), -2.0f * Float(i), 0.5f);
+		t.rotation = Quaternion::AngleAxis(0.2f * Float(i + 1), Vector3::Normalized(Vector3(1.f, -2.f, 3.f)));
+		t.scale = Vector3(1.0f + 0.1f * Float(i), 0.9f, 1.2f);
+	}
+}
+
+TEST_CASE("TransformGraph3D nodes")
+{
+	TransformGraph3D g;
+	REQUIRE(g.Count() == 0);
+
+	Size root = g.AddNode();
+	Size child = g.AddNode(root);
+
+	REQUIRE(g.Count() == 2);
+	REQUIRE(g.GetParent(root) == Size(TransformGraph3D::NoParent));
+	REQUIRE(g.GetParent(child) == root);
+	REQUIRE(g.Translation(child) == Vector3());
+	REQUIRE(g.Rotation(child) == Quaternion());
+	REQUIRE(g.Scale(child) == Vector3(1.f, 1.f, 1.f));
+
+	REQUIRE_THROWS_AS(g.AddNode(5), std::out_of_range);
+	REQUIRE_THROWS_AS(g.Translation(5), std::out_of_range);
+	REQUIRE_THROWS_AS(g.SetParent(root, root), std::runtime_error);
+	REQUIRE_THROWS_AS(g.SetParent(root, child), std::runtime_error);
+	REQUIRE(g.GetParent(root) == Size(TransformGraph3D::NoParent));
+
+	g.Clear();
+	REQUIRE(g.Count() == 0);
+}
+
+TEST_CASE("TransformGraph3D world matrices")
+{
+	Transform3D t[6];
+	for (Size i = 0; i < 6; i++) SetTestTransform(t[i], i);
+
+	// Two chains, 0 <- 1 <- 2 and 3 <- 4, plus a lone node 5
+	TransformGraph3D g;
+	Size n[6];
+	for (Size i = 0; i < 6; i++) n[i] = g.AddNode(t[i]);
+
+	t[1].SetParent(&t[0]);
+	t[2].SetParent(&t[1]);
+	t[4].SetParent(&t[3]);
+	g.SetParent(n[1], n[0]);
+	g.SetParent(n[2], n[1]);
+	g.SetParent(n[4], n[3]);
+
+	g.UpdateWorldMatrices();
+	for (Size i = 0; i < 6; i++)
+	{
+		REQUIRE(g.GetMatrix(n[i]) == t[i].GetMatrix());
+		REQUIRE(g.GetWorldMatrix(n[i]) == t[i].GetWorldMatrix());
+	}
+
+	SECTION("Reparenting to a later node")
+	{
+		t[0].SetParent(&t[5]);
+		t[3].SetParent(&t[2]);
+		g.SetParent(n[0], n[5]);
+		g.SetParent(n[3], n[2]);
+		g.Translation(n[5]) = Vector3(3.f, 4.f, 5.f);
+		t[5].translation = Vector3(3.f, 4.f, 5.f);
+
+		g.UpdateWorldMatrices();
+		for (Size i = 0; i < 6; i++)
+		{
+			REQUIRE(g.GetWorldMatrix(n[i]) == t[i].GetWorldMatrix());
+		}
+
+		REQUIRE(g.GetParent(n[0]) == n[5]);
+		REQUIRE(g.GetParent(n[3]) == n[2]);
+		REQUIRE_THROWS_AS(g.SetParent(n[5], n[4]), std::runtime_error);
+	}
+}
+
+TEST_CASE("TransformGraph3D import and export")
+{
+	Transform3D t[5];
+	for (Size i = 0; i < 5; i++) SetTestTransform(t[i], i);
+
+	// Children listed before their parents
+	t[0].SetParent(&t[3]);
+	t[1].SetParent(&t[0]);
+	t[2].SetParent(&t[3]);
+
+	TransformGraph3D g;
+	std::vector<Size> n = g.Import({ &t[0], &t[1], &t[2], &t[3], &t[4] });
+	REQUIRE(n.size() == 5);
+	REQUIRE(g.GetParent(n[0]) == n[3]);
+
+	g.UpdateWorldMatrices();
+	for (Size i = 0; i < 5; i++)
+	{
+		REQUIRE(g.GetWorldMatrix(n[i]) == t[i].GetWorldMatrix());
+	}
+
+	Transform3D out[5];
+	out[3].SetParent(&out[1]);
+	g.Export(n, { &out[0], &out[1], &out[2], &out[3], &out[4] });
+
+	for (Size i = 0; i < 5; i++)
+	{
+		REQUIRE(out[i].translation == t[i].translation);
+		REQUIRE(out[i].rotation == t[i].rotation);
+		REQUIRE(out[i].scale == t[i].scale);
+		REQUIRE(out[i].GetWorldMatrix() == t[i].GetWorldMatrix());
+	}
+
+	REQUIRE(out[0].GetParent() == &out[3]);
+	REQUIRE(out[3].GetParent() == nullptr);
+
+	REQUIRE_THROWS_AS(g.Import({ &t[1] }), std::invalid_argument);
+	REQUIRE_THROWS_AS(g.Export({ n[1] }, { &out[1] }), std::invalid_argument);
+	REQUIRE_THROWS_AS(g.Export({ n[3] }, { }), std::invalid_argument);
+	REQUIRE(g.Count() == 5);
+}
+
+TEST_CASE("TransformGraph3D parallel update matches serial update")
+{
+	// Several random trees, each node parented to a random earlier node or made a root
+	TransformGraph3D g;
+	unsigned int seed = 12345;
+	for (Size i = 0; i < 5000; i++)
+	{
+		seed = seed * 1103515245u + 12345u;
+		Size parent = (i == 0 || (seed >> 16) % 50 == 0) ? Size(TransformGraph3D::NoParent) : Size((seed >> 8) % i);
+		Size n = g.AddNode(parent);
+		g.Translation(n) = Vector3(Float(seed % 7) * 0.25f, Float(seed % 11) * -0.125f, 1.0f);
+		g.Rotation(n) = Quaternion::AngleAxis(Float(seed % 13) * 0.1f, Vector3::Normalized(Vector3(1.f, 2.f, Float(seed % 5))));
+		g.Scale(n) = Vector3(1.0f + Float(seed % 3) * 0.05f, 1.0f, 0.95f);
+	}
+
+	// Move a few subtrees under later nodes to force a reorder
+	g.SetParent(3, 4000);
+	g.SetParent(10, 4999);
+
+	TransformGraph3D serial(g);
+	serial.UpdateWorldMatrices();
+
+	for (Size threads : { Size(0), Size(1), Size(3) })
+	{
+		ThreadPool pool(threads);
+
+		for (Size grain : { Size(1), Size(16), Size(4096) })
+		{
+			TransformGraph3D parallel(g);
+			parallel.UpdateWorldMatrices(pool, grain);
+
+			for (Size n = 0; n < g.Count(); n++)
+			{
+				const Matrix4& a = serial.GetWorldMatrix(n);
+				const Matrix4& b = parallel.GetWorldMatrix(n);
+				for (Size c = 0; c < 4; c++)
+				{
+					REQUIRE(std::memcmp(a[c].Data(), b[c].Data(), sizeof(Float) * 4) == 0);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,194 @@
+#include "ValkyrieEngineCommon/FastMath.hpp"
+#include "catch2/catch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace vlk;
+
+namespace
+{
+	//! Distance between a float and the next float away from zero.
+	double Ulp(double reference)
+	{
+		const Float r = std::abs(static_cast<Float>(reference));
+		return std::nextafter(r, std::numeric_limits<Float>::infinity()) - r;
+	}
+
+	//! Reproducible values spread evenly over [lo, hi].
+	std::vector<Float> Sweep(double lo, double hi, Size n)
+	{
+		std::vector<Float> out(n);
+		for (Size i = 0; i < n; i++) out[i] = static_cast<Float>(lo + (hi - lo) * static_cast<double>(i) / static_cast<double>(n - 1));
+		return out;
+	}
+}
+
+TEST_CASE("SinCos accuracy")
+{
+	double absError = 0;
+	for (Float f : Sweep(-8192.0, 8192.0, 1000003))
+	{
+		Float s, c;
+		SinCos(f, s, c);
+		absError = std::max(absError, std::abs(s - std::sin(static_cast<double>(f))));
+		absError = std::max(absError, std::abs(c - std::cos(static_cast<double>(f))));
+	}
+
+	double wideError = 0;
+	for (Float f : Sweep(-65536.0, 65536.0, 1000003))
+	{
+		Float s, c;
+		SinCos(f, s, c);
+		wideError = std::max(wideError, std::abs(s - std::sin(static_cast<double>(f))));
+		wideError = std::max(wideError, std::abs(c - std::cos(static_cast<double>(f))));
+	}
+
+	double ulpError = 0;
+	for (Float f : Sweep(-Pi, Pi, 1000003))
+	{
+		Float s, c;
+		SinCos(f, s, c);
+		const double rs = std::sin(static_cast<double>(f));
+		const double rc = std::cos(static_cast<double>(f));
+		ulpError = std::max(ulpError, std::abs(s - rs) / Ulp(rs));
+		ulpError = std::max(ulpError, std::abs(c - rc) / Ulp(rc));
+	}
+
+	INFO("Absolute error " << absError << ", up to 65536 " << wideError << ", ulp error " << ulpError);
+	REQUIRE(absError <= 1e-7);
+	REQUIRE(wideError <= 1e-6);
+	REQUIRE(ulpError <= 2.0);
+
+	Float s, c;
+	SinCos(0.0f, s, c);
+	REQUIRE(s == 0.0f);
+	REQUIRE(c == 1.0f);
+
+	// Angles that cannot be reduced produce NaN
+	for (Float f : { std::numeric_limits<Float>::quiet_NaN(), std::numeric_limits<Float>::infinity(), -std::numeric_limits<Float>::infinity(), 4e9f, -4e9f })
+	{
+		INFO(f);
+		SinCos(f, s, c);
+		REQUIRE(std::isnan(s));
+		REQUIRE(std::isnan(c));
+	}
+}
+
+TEST_CASE("FastATan2 accuracy")
+{
+	double absError = 0;
+	const std::vector<Float> coords = Sweep(-10.0, 10.0, 1501);
+	for (Float y : coords)
+	{
+		for (Float x : coords)
+		{
+			absError = std::max(absError, std::abs(FastATan2(y, x) - std::atan2(static_cast<double>(y), static_cast<double>(x))));
+		}
+	}
+
+	INFO("Absolute error " << absError);
+	REQUIRE(absError <= 6e-7);
+
+	// Signed zeros follow std::atan2
+	for (Float y : { 0.0f, -0.0f })
+	{
+		for (Float x : { 0.0f, -0.0f, 1.0f, -1.0f })
+		{
+			INFO(y << ", " << x);
+			REQUIRE(FastATan2(y, x) == Approx(std::atan2(y, x)).margin(6e-7));
+			REQUIRE(std::signbit(FastATan2(y, x)) == std::signbit(std::atan2(y, x)));
+		}
+	}
+}
+
+TEST_CASE("FastACos accuracy")
+{
+	double absError = 0;
+	for (Float f : Sweep(-1.0, 1.0, 1000003))
+	{
+		absError = std::max(absError, std::abs(FastACos(f) - std::acos(static_cast<double>(f))));
+	}
+
+	INFO("Absolute error " << absError);
+	REQUIRE(absError <= 5e-7);
+
+	REQUIRE(FastACos(1.0f) == 0.0f);
+	REQUIRE(FastACos(1.0001f) == 0.0f);
+	REQUIRE(FastACos(-1.0001f) == Pi);
+}
+
+TEST_CASE("Fast trigonometry batches")
+{
+	// Odd length, so every vector width leaves a scalar remainder
+	const Size n = 1001;
+	const std::vector<Float> angles = Sweep(-100.0, 100.0, n);
+	const std::vector<Float> xs = Sweep(3.0, -3.0, n);
+	const SIMDLevel detected = DetectSIMDLevel();
+
+	for (int l = 0; l <= static_cast<int>(detected); l++)
+	{
+		REQUIRE(SetSIMDLevel(static_cast<SIMDLevel>(l)) == static_cast<SIMDLevel>(l));
+
+		std::vector<Float> sines(n), cosines(n), atans(n), acoses(n);
+		SinCos(angles.data(), sines.data(), cosines.data(), n);
+		FastATan2(angles.data(), xs.data(), atans.data(), n);
+		FastACos(sines.data(), acoses.data(), n);
+
+		for (Size i = 0; i < n; i++)
+		{
+			Float s, c;
+			SinCos(angles[i], s, c);
+
+			INFO("Level " << l << ", angle " << angles[i]);
+			REQUIRE(sines[i] == Approx(s).margin(1e-7));
+			REQUIRE(cosines[i] == Approx(c).margin(1e-7));
+			REQUIRE(atans[i] == FastATan2(angles[i], xs[i]));
+			REQUIRE(acoses[i] == FastACos(sines[i]));
+		}
+
+		// Output may alias the input
+		std::vector<Float> inPlace = angles;
+		std::vector<Float> other(n);
+		SinCos(inPlace.data(), inPlace.data(), other.data(), n);
+		REQUIRE(inPlace == sines);
+
+		// Lanes that cannot be reduced produce NaN, like the scalar overload
+		std::vector<Float> invalid(angles.begin(), angles.begin() + 17);
+		invalid[1] = std::numeric_limits<Float>::quiet_NaN();
+		invalid[6] = std::numeric_limits<Float>::infinity();
+		invalid[11] = -4e9f;
+		std::vector<Float> invalidSines(invalid.size()), invalidCosines(invalid.size());
+		SinCos(invalid.data(), invalidSines.data(), invalidCosines.data(), invalid.size());
+
+		for (Size i = 0; i < invalid.size(); i++)
+		{
+			INFO("Level " << l << ", angle " << invalid[i]);
+			REQUIRE(std::isnan(invalidSines[i]) == (i == 1 || i == 6 || i == 11));
+			REQUIRE(std::isnan(invalidCosines[i]) == (i == 1 || i == 6 || i == 11));
+		}
+	}
+
+	SetSIMDLevel(detected);
+}
+
+TEST_CASE("FastInvSqrt accuracy")
+{
+	double relError = 0;
+	for (Float f : Sweep(1e-6, 1e6, 1000003))
+	{
+		const double reference = 1.0 / std::sqrt(static_cast<double>(f));
+		relError = std::max(relError, std::abs(FastInvSqrt(f) - reference) / reference);
+	}
+
+	// Powers of two across the whole normal range
+	for (int e = -126; e < 128; e++)
+	{
+		const Float f = std::ldexp(1.0f, e);
+		const double reference = 1.0 / std::sqrt(static_cast<double>(f));
+		relError = std::max(relError, std::abs(FastInvSqrt(f) - reference) / reference);
+	}
+
+	REQUIRE(relError < 5e-7);
+}
@@ -0,0 +1,76 @@
+#include "ValkyrieEngineCommon/LookupTable.hpp"
+#include "catch2/catch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace vlk;
+
+namespace
+{
+	struct Square
+	{
+		constexpr Float operator()(Float x) const { return x * x; }
+	};
+
+	constexpr Float Cube(ConstexprWrapper<Float> x) { return x * x * x; }
+
+	constexpr std::array<Float, 5> squares = MakeTable<5>(Square(), 0.0f, 1.0f);
+	constexpr LookupTable<3> cubes = MakeLookupTable<3>(Cube, -1.0f, 1.0f);
+	constexpr LookupTable<5> ramp = MakeLookupTable<5>(Square(), 0.0f, 4.0f, true);
+}
+
+// Tables and lookups are constant expressions
+static_assert(squares[0] == 0.0f && squares[2] == 0.25f && squares[4] == 1.0f, "MakeTable samples both ends");
+static_assert(cubes(-1.0f) == -1.0f && cubes(0.0f) == 0.0f && cubes(1.0f) == 1.0f, "Lookups at samples are exact");
+static_assert(cubes(0.5f) == 0.5f, "Lookups interpolate linearly");
+static_assert(cubes(-3.0f) == -1.0f && cubes(3.0f) == 1.0f, "Lookups clamp");
+static_assert(ramp(1.5f) == 2.5f && ramp(5.5f) == 2.5f && ramp(-2.5f) == 2.5f, "Periodic lookups wrap");
+static_assert(SinTable<>(0.0f) == 0.0f, "SinTable is constexpr");
+static_assert(EasingTable<Easing::OutBounce>(1.0f) == 1.0f, "EasingTable is constexpr");
+
+TEST_CASE("Lookup table edges")
+{
+	REQUIRE(cubes(std::numeric_limits<Float>::quiet_NaN()) == -1.0f);
+	REQUIRE(cubes(std::numeric_limits<Float>::infinity()) == 1.0f);
+	REQUIRE(ramp(1e30f) == 0.0f);
+	REQUIRE(ramp.IsPeriodic());
+	REQUIRE(!cubes.IsPeriodic());
+	REQUIRE(cubes.Lo() == -1.0f);
+	REQUIRE(cubes.Hi() == 1.0f);
+}
+
+TEST_CASE("Sine and cosine table accuracy")
+{
+	double sinError = 0, cosError = 0, fineError = 0;
+	for (Float f = -100.0f; f < 100.0f; f += 0.00071f)
+	{
+		sinError = std::max(sinError, std::abs(SinTable<>(f) - std::sin(static_cast<double>(f))));
+		cosError = std::max(cosError, std::abs(CosTable<>(f) - std::cos(static_cast<double>(f))));
+		fineError = std::max(fineError, std::abs(SinTable<1024>(f) - std::sin(static_cast<double>(f))));
+	}
+
+	REQUIRE(sinError < 8e-5);
+	REQUIRE(cosError < 8e-5);
+	REQUIRE(fineError < 1e-5);
+}
+
+TEST_CASE("Easing tables")
+{
+	const Float t = GENERATE(range(0.0f, 1.0f, 0.01f));
+
+	REQUIRE(EasingTable<Easing::InOutSine>(t) == Approx((1.0 - std::cos(Pi * t)) / 2.0).margin(2e-5));
+	REQUIRE(EasingTable<Easing::InExpo>(t) == Approx(t == 0.0f ? 0.0 : std::pow(2.0, 10.0 * t - 10.0)).margin(1e-4));
+	REQUIRE(EasingTable<Easing::OutExpo>(t) == Approx(1.0 - std::pow(2.0, -10.0 * t)).margin(1e-3));
+	REQUIRE(EasingTable<Easing::OutBounce>(t) == Approx(Easing::OutBounce()(ForceCXPR(t))).margin(1e-3));
+
+	for (Float e : { EasingTable<Easing::InOutSine>(0.0f), EasingTable<Easing::InExpo>(0.0f), EasingTable<Easing::OutExpo>(0.0f), EasingTable<Easing::OutElastic>(0.0f), EasingTable<Easing::OutBounce>(0.0f) })
+	{
+		REQUIRE(e == 0.0f);
+	}
+
+	for (Float e : { EasingTable<Easing::InOutSine>(1.0f), EasingTable<Easing::InExpo>(1.0f), EasingTable<Easing::OutExpo>(1.0f), EasingTable<Easing::OutElastic>(1.0f), EasingTable<Easing::OutBounce>(1.0f) })
+	{
+		REQUIRE(e == Approx(1.0f));
+	}
+}
@@ -0,0 +1,128 @@
+#include "ValkyrieEngineCommon/VMathBatch.hpp"
+#include "catch2/catch.hpp"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace vlk;
+
+namespace
+{
+	typedef void (*BatchFunction)(const Float*, Float*, Size);
+	typedef Float (*ScalarFunction)(Float);
+
+	//! Values on and around every boundary the kernels treat specially, followed by a sweep.
+	std::vector<Float> EdgeValues()
+	{
+		const Float inf = std::numeric_limits<Float>::infinity();
+		std::vector<Float> out =
+		{
+			0.0f, -0.0f, 0.5f, -0.5f, 1.5f, -1.5f, 2.5f, -2.5f,
+			0.49999997f, -0.49999997f, 0.50000006f, -0.50000006f,
+			0.99999994f, -0.99999994f, 1.0f, -1.0f,
+			8388607.5f, -8388607.5f, 8388608.0f, -8388608.0f, 8388609.0f, -8388609.0f,
+			16777215.0f, 2147483648.0f, -2147483648.0f, 1e30f, -1e30f,
+			std::numeric_limits<Float>::min(), -std::numeric_limits<Float>::denorm_min(),
+			std::numeric_limits<Float>::max(), -std::numeric_limits<Float>::max(),
+			inf, -inf, std::numeric_limits<Float>::quiet_NaN()
+		};
+
+		for (Float f = -20.0f; f <= 20.0f; f += 0.125f) out.push_back(f);
+		return out;
+	}
+
+	//! Compares every output bit for bit, treating all NaNs as equal, at every length up to the input size.
+	void CheckBatch(BatchFunction batch, ScalarFunction scalar, const std::vector<Float>& in)
+	{
+		const SIMDLevel detected = DetectSIMDLevel();
+
+		for (int l = 0; l <= static_cast<int>(detected); l++)
+		{
+			const SIMDLevel level = static_cast<SIMDLevel>(l);
+			REQUIRE(SetSIMDLevel(level) == level);
+
+			for (Size n : { Size(0), Size(1), Size(3), Size(7), Size(15), Size(17), in.size() })
+			{
+				// One guard element past the end must be left untouched
+				std::vector<Float> out(n + 1, 42.0f);
+				batch(in.data(), out.data(), n);
+
+				for (Size i = 0; i < n; i++)
+				{
+					const Float expected = scalar(in[i]);
+					INFO("Level " << l << ", input " << in[i] << ", got " << out[i] << ", expected " << expected);
+
+					if (std::isnan(expected)) REQUIRE(std::isnan(out[i]));
+					else REQUIRE(std::memcmp(&out[i], &expected, sizeof(Float)) == 0);
+				}
+
+				REQUIRE(out[n] == 42.0f);
+			}
+		}
+
+		SetSIMDLevel(detected);
+	}
+}
+
+TEST_CASE("SIMD level selection")
+{
+	const SIMDLevel detected = DetectSIMDLevel();
+
+	REQUIRE(GetSIMDLevel() == detected);
+	REQUIRE(SetSIMDLevel(SIMDLevel::Scalar) == SIMDLevel::Scalar);
+	REQUIRE(GetSIMDLevel() == SIMDLevel::Scalar);
+
+	// Levels beyond what the CPU supports are lowered
+	REQUIRE(SetSIMDLevel(SIMDLevel::AVX512) == detected);
+	REQUIRE(GetSIMDLevel() == detected);
+}
+
+TEST_CASE("Bulk rounding functions")
+{
+	const std::vector<Float> in = EdgeValues();
+
+	SECTION("Floor") { CheckBatch(Floor, [](Float f) { return Floor(f); }, in); }
+	SECTION("Ceil") { CheckBatch(Ceil, [](Float f) { return Ceil(f); }, in); }
+	SECTION("Trunc") { CheckBatch(Trunc, [](Float f) { return Trunc(f); }, in); }
+	SECTION("Round") { CheckBatch(Round, [](Float f) { return Round(f); }, in); }
+	SECTION("Abs") { CheckBatch(Abs, [](Float f) { return Abs(f); }, in); }
+}
+
+TEST_CASE("Bulk square root")
+{
+	std::vector<Float> in = EdgeValues();
+	for (Float f = 0.0f; f < 1000.0f; f += 0.37f) in.push_back(f);
+
+	CheckBatch(Sqrt, [](Float f) { return Sqrt(f); }, in);
+}
+
+TEST_CASE("Bulk functions may operate in place")
+{
+	std::vector<Float> values = { -1.5f, -0.5f, 0.5f, 1.5f, 2.5f };
+	Round(values.data(), values.data(), values.size());
+
+	REQUIRE(values == std::vector<Float>({ -2.0f, -1.0f, 1.0f, 2.0f, 3.0f }));
+}
+
+TEST_CASE("Bulk scalar fallbacks")
+{
+	const std::vector<Float> a = { 0.25f, 1.0f, 2.0f, 3.5f };
+	const std::vector<Float> b = { 2.0f, -1.5f, 0.75f, 3.0f };
+	std::vector<Float> out(a.size());
+
+	Pow(a.data(), b.data(), out.data(), a.size());
+	for (Size i = 0; i < a.size(); i++) REQUIRE(out[i] == Pow(a[i], b[i]));
+
+	FMod(a.data(), b.data(), out.data(), a.size());
+	for (Size i = 0; i < a.size(); i++) REQUIRE(out[i] == FMod(a[i], b[i]));
+
+	ATan2(a.data(), b.data(), out.data(), a.size());
+	for (Size i = 0; i < a.size(); i++) REQUIRE(out[i] == ATan2(a[i], b[i]));
+
+	Sin(b.data(), out.data(), b.size());
+	for (Size i = 0; i < b.size(); i++) REQUIRE(out[i] == Sin(b[i]));
+
+	ACos(a.data(), out.data(), 1);
+	REQUIRE(out[0] == ACos(a[0]));
+}
@@ -336,6 +336,25 @@ TEST_CASE("Vector2 normalize")
 	}
 }
 
+TEST_CASE("Vector2 safe and fast normalize")
+{
+	const Vector2 v = GENERATE(take(10, Vector2Generator::GetWrapper()));
+
+	if (Vector2::Length(v) != 0.0f)
+	{
+		const Vector2 n = Vector2::Normalized(v);
+		REQUIRE(Vector2::NormalizedSafe(v) == n);
+
+		const Vector2 f = Vector2::FastNormalized(v);
+		REQUIRE(f.X() == Approx(n.X()).margin(1e-6));
+		REQUIRE(f.Y() == Approx(n.Y()).margin(1e-6));
+	}
+
+	REQUIRE(Vector2::NormalizedSafe(Vector2::Zero()) == Vector2::Zero());
+	REQUIRE(Vector2::NormalizedSafe(Vector2::Zero(), Vector2(1.0f, 0.0f)) == Vector2(1.0f, 0.0f));
+	REQUIRE(Vector2::FastNormalized(Vector2::Zero()) == Vector2::Zero());
+}
+
 TEST_CASE("Vector2 distance to zero")
 {	
 	const Vector2 v = GENERATE(take(10, Vector2Generator::GetWrapper()));
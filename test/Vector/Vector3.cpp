@@ -313,6 +313,55 @@ TEST_CASE("Vector3 normalize")
 	}
 }
 
+TEST_CASE("Vector3 safe and fast normalize")
+{
+	const Vector3 v = GENERATE(take(10, Vector3Generator::GetWrapper()));
+
+	if (Vector3::Length(v) != 0.0f)
+	{
+		const Vector3 n = Vector3::Normalized(v);
+		REQUIRE(Vector3::NormalizedSafe(v) == n);
+
+		const Vector3 f = Vector3::FastNormalized(v);
+		REQUIRE(f.X() == Approx(n.X()).margin(1e-6));
+		REQUIRE(f.Y() == Approx(n.Y()).margin(1e-6));
+		REQUIRE(f.Z() == Approx(n.Z()).margin(1e-6));
+	}
+}
+
+TEST_CASE("Vector3 normalize without a direction")
+{
+	const Float inf = std::numeric_limits<Float>::infinity();
+	const Float nan = std::numeric_limits<Float>::quiet_NaN();
+
+	for (const Vector3& v : { Vector3::Zero(), Vector3(1e-30f, 0.0f, 0.0f), Vector3(inf, 0.0f, 0.0f), Vector3(nan, 1.0f, 1.0f) })
+	{
+		REQUIRE(Vector3::NormalizedSafe(v, Vector3::Up()) == Vector3::Up());
+		REQUIRE(Vector3::FastNormalized(v) == Vector3::Zero());
+	}
+
+	// Large vectors whose square length overflows have no usable length either
+	REQUIRE(Vector3::NormalizedSafe(Vector3(0.0f, 1e30f, 0.0f), Vector3::Up()) == Vector3::Up());
+
+	// Small vectors whose square length is still a normal float keep their direction
+	REQUIRE(Vector3::NormalizedSafe(Vector3(0.0f, 1e-18f, 0.0f)).Y() == Approx(1.0f));
+	REQUIRE(Vector3::FastNormalized(Vector3(0.0f, 0.0f, 1e-18f)).Z() == Approx(1.0f).margin(1e-6));
+}
+
+TEST_CASE("Vector3 fast normalize array")
+{
+	std::vector<Vector3> v;
+	for (Int i = 0; i < 9; i++) v.push_back(Vector3(Float(i), Float(2 - i), 0.5f * Float(i)));
+
+	std::vector<Vector3> out(v.size());
+	Vector3::FastNormalized(v.data(), out.data(), v.size());
+
+	for (Size i = 0; i < v.size(); i++) REQUIRE(out[i] == Vector3::FastNormalized(v[i]));
+
+	Vector3::FastNormalized(v.data(), v.data(), v.size());
+	REQUIRE(v == out);
+}
+
 TEST_CASE("Vector3 distance to zero")
 {
 	Vector3 v = GENERATE(take(10, Vector3Generator::GetWrapper()));
@@ -0,0 +1,165 @@
+#include "TestValues.hpp"
+#include "ValkyrieEngineCommon/VectorStream.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace vlk;
+
+//Deliberately not a multiple of the SIMD width so the scalar tail is exercised
+static std::vector<Vector3> GetStreamValues(Size offset = 0)
+{
+	std::vector<Vector3> vectors;
+
+	//Only the moderate values at the start of reducedValues, so products stay finite
+	const Size n = 16;
+
+	for (Size i = 0; i < 37; i++)
+	{
+		vectors.push_back(Vector3(
+			*(reducedValues.begin() + ((i + offset) % n)),
+			*(reducedValues.begin() + ((i * 3 + offset + 1) % n)),
+			*(reducedValues.begin() + ((i * 7 + offset + 2) % n))));
+	}
+
+	return vectors;
+}
+
+TEST_CASE("Vector3Stream conversion")
+{
+	std::vector<Vector3> v = GetStreamValues();
+	Vector3Stream s(v);
+
+	REQUIRE(s.Count() == v.size());
+	REQUIRE(reinterpret_cast<std::uintptr_t>(s.X()) % Vector3Stream::Alignment == 0);
+	REQUIRE(reinterpret_cast<std::uintptr_t>(s.Y()) % Vector3Stream::Alignment == 0);
+	REQUIRE(reinterpret_cast<std::uintptr_t>(s.Z()) % Vector3Stream::Alignment == 0);
+
+	for (Size i = 0; i < v.size(); i++)
+	{
+		REQUIRE(s.Get(i) == v[i]);
+		REQUIRE(s.X()[i] == v[i].X());
+		REQUIRE(s.Y()[i] == v[i].Y());
+		REQUIRE(s.Z()[i] == v[i].Z());
+	}
+
+	std::vector<Vector3> u = s.ToVector();
+	REQUIRE(u.size() == v.size());
+
+	for (Size i = 0; i < v.size(); i++)
+	{
+		REQUIRE(u[i] == v[i]);
+	}
+}
+
+TEST_CASE("Vector3Stream copy and resize")
+{
+	std::vector<Vector3> v = GetStreamValues();
+	Vector3Stream s(v);
+	Vector3Stream t(s);
+
+	t.Resize(100);
+	REQUIRE(t.Count() == 100);
+
+	for (Size i = 0; i < 100; i++)
+	{
+		if (i < v.size()) REQUIRE(t.Get(i) == v[i]);
+		else REQUIRE(t.Get(i) == Vector3::Zero());
+	}
+
+	t.Resize(3);
+	REQUIRE(t.Count() == 3);
+	REQUIRE(t.Get(2) == v[2]);
+
+	s = std::move(t);
+	REQUIRE(s.Count() == 3);
+}
+
+TEST_CASE("Vector3Stream add, scale and lerp")
+{
+	std::vector<Vector3> v = GetStreamValues(0);
+	std::vector<Vector3> u = GetStreamValues(5);
+	Vector3Stream s(v);
+	Vector3Stream t(u);
+	Vector3Stream r;
+
+	Vector3Stream::Add(s, t, r);
+	for (Size i = 0; i < v.size(); i++) REQUIRE(r.Get(i) == v[i] + u[i]);
+
+	Vector3Stream::Scale(s, 0.25f, r);
+	for (Size i = 0; i < v.size(); i++) REQUIRE(r.Get(i) == v[i] * 0.25f);
+
+	Vector3Stream::Lerp(s, t, 0.3f, r);
+	for (Size i = 0; i < v.size(); i++) REQUIRE(r.Get(i) == Vector3::Lerp(v[i], u[i], 0.3f));
+
+	//Output may alias an input
+	Vector3Stream::Add(s, t, s);
+	for (Size i = 0; i < v.size(); i++) REQUIRE(s.Get(i) == v[i] + u[i]);
+
+	REQUIRE_THROWS_AS(Vector3Stream::Add(s, Vector3Stream(3), r), std::invalid_argument);
+}
+
+TEST_CASE("Vector3Stream dot, cross and length")
+{
+	std::vector<Vector3> v = GetStreamValues(0);
+	std::vector<Vector3> u = GetStreamValues(7);
+	Vector3Stream s(v);
+	Vector3Stream t(u);
+	std::vector<Float> f(v.size());
+
+	Vector3Stream::Dot(s, t, f.data());
+	for (Size i = 0; i < v.size(); i++) REQUIRE(f[i] == Approx(Vector3::Dot(v[i], u[i])));
+
+	Vector3Stream::Length(s, f.data());
+	for (Size i = 0; i < v.size(); i++) REQUIRE(f[i] == Approx(Vector3::Length(v[i])));
+
+	Vector3Stream::Cross(s, t, s);
+	for (Size i = 0; i < v.size(); i++)
+	{
+		Vector3 c = Vector3::Cross(v[i], u[i]);
+		REQUIRE(s.X()[i] == Approx(c.X()));
+		REQUIRE(s.Y()[i] == Approx(c.Y()));
+		REQUIRE(s.Z()[i] == Approx(c.Z()));
+	}
+}
+
+TEST_CASE("Vector3Stream normalize")
+{
+	std::vector<Vector3> v = GetStreamValues();
+	Vector3Stream s(v);
+	Vector3Stream r;
+
+	Vector3Stream::Normalized(s, r);
+
+	for (Size i = 0; i < v.size(); i++)
+	{
+		Vector3 n = Vector3::Normalized(v[i]);
+		REQUIRE(r.X()[i] == Approx(n.X()));
+		REQUIRE(r.Y()[i] == Approx(n.Y()));
+		REQUIRE(r.Z()[i] == Approx(n.Z()));
+	}
+}
+
+TEST_CASE("Vector3Stream fast normalize")
+{
+	std::vector<Vector3> v = GetStreamValues();
+	v[1] = Vector3::Zero();
+	v[6] = Vector3(std::numeric_limits<Float>::quiet_NaN(), 1.0f, 0.0f);
+	v[v.size() - 1] = Vector3::Zero();
+
+	Vector3Stream s(v);
+	Vector3Stream r;
+
+	Vector3Stream::FastNormalized(s, r);
+
+	for (Size i = 0; i < v.size(); i++)
+	{
+		Vector3 n = Vector3::FastNormalized(v[i]);
+		REQUIRE(r.X()[i] == Approx(n.X()).margin(1e-6));
+		REQUIRE(r.Y()[i] == Approx(n.Y()).margin(1e-6));
+		REQUIRE(r.Z()[i] == Approx(n.Z()).margin(1e-6));
+	}
+
+	REQUIRE(r.Get(1) == Vector3::Zero());
+	REQUIRE(r.Get(6) == Vector3::Zero());
+}
@@ -1,5 +1,6 @@
 
 #include "TestValues.hpp"
+#include <cstdint>
 
 using namespace vlk;
 
@@ -318,3 +319,31 @@ TEST_CASE("Vector4 scale down assignment operator")
 	}
 }
 
+
+TEST_CASE("Vector4 alignment")
+{
+	VLK_STATIC_ASSERT_MSG(alignof(VectorBase<4, Float>) == 16, "VectorBase<4, Float> must be 16-byte aligned");
+	VLK_STATIC_ASSERT_MSG(sizeof(VectorBase<4, Float>) == 16, "VectorBase<4, Float> must not be padded");
+
+	Vector4 v[3];
+
+	for (Size i = 0; i < 3; i++)
+	{
+		REQUIRE(reinterpret_cast<std::uintptr_t>(v[i].Data()) % 16 == 0);
+	}
+}
+
+TEST_CASE("Vector4 constexpr arithmetic")
+{
+	VLK_CXX14_CONSTEXPR Vector4 v(1.0f, 2.0f, 3.0f, 4.0f);
+	VLK_CXX14_CONSTEXPR Vector4 u(0.5f, -1.0f, 2.0f, 8.0f);
+	VLK_CXX14_CONSTEXPR Vector4 w((v + u) * 2.0f - v / 2.0f);
+
+	VLK_STATIC_ASSERT_MSG(w == Vector4(2.5f, 1.0f, 8.5f, 22.0f), "Constant evaluation of Vector4 arithmetic failed");
+	VLK_STATIC_ASSERT_MSG(w != v, "Constant evaluation of Vector4 comparison failed");
+
+	//Runtime evaluation must match constant evaluation exactly
+	Vector4 x(v);
+	Vector4 y(u);
+	REQUIRE((x + y) * 2.0f - x / 2.0f == w);
+}
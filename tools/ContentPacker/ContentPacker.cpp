@@ -0,0 +1,119 @@
+/*
+ * Builds a content archive from a content directory.
+ *
+ * Usage: ValkyrieContentPacker <content directory> <archive>
+ *
+ * Every file below the content directory is stored under its path relative
+ * to that directory, using '/' as separator. A file named <path>.meta is not
+ * stored itself, but as the metadata of <path>. Binary metadata caches
+ * (<path>.metab) and their temporary files, which loading content writes next
+ * to it, are skipped, as is the archive itself if it is written inside the
+ * content directory.
+ */
+
+#include "ValkyrieEngineCommon/ContentArchive.hpp"
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	const std::string metaExtension = ".meta";
+
+	const std::string cacheExtension = ".metab";
+
+	//! Reads a whole file into a byte vector or string, without an intermediate copy.
+	template <typename Container>
+	Container ReadFile(const fs::path& path)
+	{
+		std::ifstream in(path, std::ios::binary);
+		if (!in.good()) throw std::runtime_error("Could not read " + path.string());
+
+		Container data(static_cast<std::size_t>(fs::file_size(path)), 0);
+		in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		data.resize(static_cast<std::size_t>(in.gcount()));
+		return data;
+	}
+
+	//! Returns true for binary metadata caches and the temporary files they are written through.
+	bool IsCache(const std::string& path)
+	{
+		const std::string::size_type i = path.rfind(cacheExtension);
+		if (i == std::string::npos) return false;
+
+		const std::string rest = path.substr(i + cacheExtension.size());
+		return rest.empty() || rest.compare(0, 4, ".tmp") == 0;
+	}
+
+	bool IsMeta(const std::string& path)
+	{
+		return path.size() > metaExtension.size() &&
+			path.compare(path.size() - metaExtension.size(), metaExtension.size(), metaExtension) == 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <content directory> <archive>" << std::endl;
+		return 2;
+	}
+
+	try
+	{
+		const fs::path root(argv[1]);
+		const fs::path archive = fs::weakly_canonical(argv[2]);
+
+		// Sorted so archives are reproducible
+		std::map<std::string, fs::path> files;
+		for (const fs::directory_entry& e : fs::recursive_directory_iterator(root))
+		{
+			if (!e.is_regular_file()) continue;
+
+			const std::string relative = e.path().lexically_relative(root).generic_string();
+			if (IsCache(relative) || fs::weakly_canonical(e.path()) == archive) continue;
+
+			files[relative] = e.path();
+		}
+
+		vlk::ContentArchiveWriter writer;
+		vlk::Size metaFiles = 0;
+
+		for (const std::pair<const std::string, fs::path>& f : files)
+		{
+			if (IsMeta(f.first))
+			{
+				if (files.count(f.first.substr(0, f.first.size() - metaExtension.size())) != 0)
+				{
+					metaFiles++;
+					continue;
+				}
+			}
+
+			auto meta = files.find(f.first + metaExtension);
+
+			writer.Add(
+				f.first,
+				ReadFile<std::vector<vlk::UByte>>(f.second),
+				(meta != files.end()) ? ReadFile<std::string>(meta->second) : std::string());
+		}
+
+		writer.Write(argv[2]);
+
+		std::cout << "Packed " << writer.Count() << " files and " << metaFiles << " metadata files into " << argv[2] << std::endl;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}